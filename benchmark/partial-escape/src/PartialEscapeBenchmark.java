@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class PartialEscapeBenchmark {
+    public static final int N = 1024;
+    public static final int[] ints = new int[N];
+
+    static {
+        for (int i = 0, k = 17; i < N; i++, k = k * 1103515245 + 12345) {
+            ints[i] = k;
+        }
+    }
+
+    static class Pair {
+        int first;
+        int second;
+    }
+
+    public void timeRareEscape(int count) {
+        int[] a = ints;
+        for (int i = 0; i < count; ++i) {
+            $noinline$sumPairs(a);
+        }
+    }
+
+    // Compare allocation rates with the GC statistics of the runtime running this benchmark.
+    static int $noinline$sumPairs(int[] a) {
+        if (doThrow) { throw new Error(); }
+        int sum = 0;
+        for (int i = 0; i + 1 < a.length; i += 2) {
+            Pair p = new Pair();
+            p.first = a[i];
+            p.second = a[i + 1];
+            if (p.first == Integer.MIN_VALUE) {
+                // Never taken with the data above; the pair only escapes here.
+                sEscape = p;
+            }
+            sum += p.first + p.second;
+        }
+        return sum;
+    }
+
+    public static Pair sEscape;
+    public static boolean doThrow = false;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class SchedulingBenchmark {
+    public static final int N = 1024;
+    public static final int[] ints = new int[N];
+    public static final long[] longs = new long[N];
+    public static final double[] doubles = new double[N];
+
+    static {
+        for (int i = 0, k = 17; i < N; i++, k = k * 1103515245 + 12345) {
+            ints[i] = k;
+            longs[i] = (long) k << 3;
+            doubles[i] = k * 0.25;
+        }
+    }
+
+    public void timeMulAddInt(int count) {
+        int[] a = ints;
+        int[] b = new int[N];
+        for (int i = 0; i < count; ++i) {
+            $noinline$mulAddInt(a, b);
+        }
+    }
+
+    public void timeMulAddLong(int count) {
+        long[] a = longs;
+        long[] b = new long[N];
+        for (int i = 0; i < count; ++i) {
+            $noinline$mulAddLong(a, b);
+        }
+    }
+
+    public void timeMulAddDouble(int count) {
+        double[] a = doubles;
+        double[] b = new double[N];
+        for (int i = 0; i < count; ++i) {
+            $noinline$mulAddDouble(a, b);
+        }
+    }
+
+    // Two independent load -> multiply -> store chains per iteration, which the scheduler
+    // can interleave to hide the load and multiply latencies.
+    static void $noinline$mulAddInt(int[] a, int[] b) {
+        if (doThrow) { throw new Error(); }
+        for (int i = 0; i + 1 < a.length; i += 2) {
+            b[i] = a[i] * a[i + 1] + b[i];
+            b[i + 1] = a[i + 1] * 31 + b[i + 1];
+        }
+    }
+
+    static void $noinline$mulAddLong(long[] a, long[] b) {
+        if (doThrow) { throw new Error(); }
+        for (int i = 0; i + 1 < a.length; i += 2) {
+            b[i] = a[i] * a[i + 1] + b[i];
+            b[i + 1] = a[i + 1] * 31L + b[i + 1];
+        }
+    }
+
+    static void $noinline$mulAddDouble(double[] a, double[] b) {
+        if (doThrow) { throw new Error(); }
+        for (int i = 0; i + 1 < a.length; i += 2) {
+            b[i] = a[i] * a[i + 1] + b[i];
+            b[i + 1] = a[i + 1] * 0.5 + b[i + 1];
+        }
+    }
+
+    public static boolean doThrow = false;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class SimdReductionBenchmark {
+    public static final int N = 1024;
+    public static final int[] ints = new int[N];
+
+    static {
+        for (int i = 0, k = 17; i < N; i++, k = k * 1103515245 + 12345) {
+            ints[i] = k;
+        }
+    }
+
+    public void timeSumInt(int count) {
+        int[] a = ints;
+        for (int i = 0; i < count; ++i) {
+            $noinline$sum(a);
+        }
+    }
+
+    public void timeMinInt(int count) {
+        int[] a = ints;
+        for (int i = 0; i < count; ++i) {
+            $noinline$min(a);
+        }
+    }
+
+    public void timeMaxInt(int count) {
+        int[] a = ints;
+        for (int i = 0; i < count; ++i) {
+            $noinline$max(a);
+        }
+    }
+
+    static int $noinline$sum(int[] a) {
+        if (doThrow) { throw new Error(); }
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i];
+        }
+        return sum;
+    }
+
+    static int $noinline$min(int[] a) {
+        if (doThrow) { throw new Error(); }
+        int min = Integer.MAX_VALUE;
+        for (int i = 0; i < a.length; i++) {
+            min = Math.min(min, a[i]);
+        }
+        return min;
+    }
+
+    static int $noinline$max(int[] a) {
+        if (doThrow) { throw new Error(); }
+        int max = Integer.MIN_VALUE;
+        for (int i = 0; i < a.length; i++) {
+            max = Math.max(max, a[i]);
+        }
+        return max;
+    }
+
+    public static boolean doThrow = false;
+}
@@ -33,6 +33,11 @@ CompiledCode::~CompiledCode() {
   GetStorage()->ReleaseCode(quick_code_);
 }
 
+void CompiledCode::ReleaseQuickCode() {
+  GetStorage()->ReleaseCode(quick_code_);
+  quick_code_ = nullptr;
+}
+
 bool CompiledCode::operator==(const CompiledCode& rhs) const {
   if (quick_code_ != nullptr) {
     if (rhs.quick_code_ == nullptr) {
@@ -138,4 +143,20 @@ CompiledMethod::~CompiledMethod() {
   storage->ReleaseVMapTable(vmap_table_);
 }
 
+void CompiledMethod::ReleaseVmapTable() {
+  GetStorage()->ReleaseVMapTable(vmap_table_);
+  vmap_table_ = nullptr;
+}
+
+void CompiledMethod::ReleaseCFIInfo() {
+  GetStorage()->ReleaseCFIInfo(cfi_info_);
+  cfi_info_ = nullptr;
+}
+
+void CompiledMethod::ReleaseCodeAndPatches() {
+  GetStorage()->ReleaseLinkerPatches(patches_);
+  patches_ = nullptr;
+  ReleaseQuickCode();
+}
+
 }  // namespace art
@@ -81,6 +81,9 @@ class CompiledCode {
     return storage_;
   }
 
+  // Releases the code, see CompiledMethod::ReleaseCodeAndPatches().
+  void ReleaseQuickCode();
+
   template <typename BitFieldType>
   typename BitFieldType::value_type GetPackedField() const {
     return BitFieldType::Decode(packed_fields_);
@@ -98,7 +101,7 @@ class CompiledCode {
   CompiledMethodStorage* const storage_;
 
   // Used to store the compiled code.
-  const LengthPrefixedArray<uint8_t>* const quick_code_;
+  const LengthPrefixedArray<uint8_t>* quick_code_;
 
   uint32_t packed_fields_;
 };
@@ -145,6 +148,18 @@ class CompiledMethod final : public CompiledCode {
 
   ArrayRef<const linker::LinkerPatch> GetPatches() const;
 
+  // Releases the stack maps. Used by the oat writer to reduce peak memory once it has
+  // copied the stack maps to the oat file and no debug info refers to them.
+  void ReleaseVmapTable();
+
+  // Releases the CFI. Used by the oat writer to reduce peak memory when it does not
+  // write any debug info.
+  void ReleaseCFIInfo();
+
+  // Releases the code and linker patches. Used by the oat writer to reduce peak memory once it
+  // has written the code to the oat file. The method has no compiled code afterwards.
+  void ReleaseCodeAndPatches();
+
  private:
   static constexpr size_t kIsIntrinsicLsb = kNumberOfCompiledCodePackedBits;
   static constexpr size_t kIsIntrinsicSize = 1u;
@@ -155,11 +170,11 @@ class CompiledMethod final : public CompiledCode {
   using IsIntrinsicField = BitField<bool, kIsIntrinsicLsb, kIsIntrinsicSize>;
 
   // For quick code, holds code infos which contain stack maps, inline information, and etc.
-  const LengthPrefixedArray<uint8_t>* const vmap_table_;
+  const LengthPrefixedArray<uint8_t>* vmap_table_;
   // For quick code, a FDE entry for the debug_frame section.
-  const LengthPrefixedArray<uint8_t>* const cfi_info_;
+  const LengthPrefixedArray<uint8_t>* cfi_info_;
   // For quick code, linker patches needed by the method.
-  const LengthPrefixedArray<linker::LinkerPatch>* const patches_;
+  const LengthPrefixedArray<linker::LinkerPatch>* patches_;
 };
 
 }  // namespace art
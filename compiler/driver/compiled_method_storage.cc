@@ -66,11 +66,15 @@ inline const LengthPrefixedArray<T>* CompiledMethodStorage::AllocateOrDeduplicat
   }
 }
 
-template <typename T>
-inline void CompiledMethodStorage::ReleaseArrayIfNotDeduplicated(
-    const LengthPrefixedArray<T>* array) {
-  if (array != nullptr && !DedupeEnabled()) {
+template <typename T, typename DedupeSetType>
+inline void CompiledMethodStorage::ReleaseArrayUse(const LengthPrefixedArray<T>* array,
+                                                   DedupeSetType* dedupe_set) {
+  if (array == nullptr) {
+    return;
+  } else if (!DedupeEnabled()) {
     ReleaseArray(swap_space_.get(), array);
+  } else {
+    dedupe_set->Remove(Thread::Current(), ArrayRef<const T>(&array->At(0), array->size()));
   }
 }
 
@@ -180,7 +184,7 @@ const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateCode(
 }
 
 void CompiledMethodStorage::ReleaseCode(const LengthPrefixedArray<uint8_t>* code) {
-  ReleaseArrayIfNotDeduplicated(code);
+  ReleaseArrayUse(code, &dedupe_code_);
 }
 
 const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateVMapTable(
@@ -189,7 +193,7 @@ const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateVMapTable(
 }
 
 void CompiledMethodStorage::ReleaseVMapTable(const LengthPrefixedArray<uint8_t>* table) {
-  ReleaseArrayIfNotDeduplicated(table);
+  ReleaseArrayUse(table, &dedupe_vmap_table_);
 }
 
 const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateCFIInfo(
@@ -198,7 +202,7 @@ const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateCFIInfo(
 }
 
 void CompiledMethodStorage::ReleaseCFIInfo(const LengthPrefixedArray<uint8_t>* cfi_info) {
-  ReleaseArrayIfNotDeduplicated(cfi_info);
+  ReleaseArrayUse(cfi_info, &dedupe_cfi_info_);
 }
 
 const LengthPrefixedArray<linker::LinkerPatch>* CompiledMethodStorage::DeduplicateLinkerPatches(
@@ -208,7 +212,7 @@ const LengthPrefixedArray<linker::LinkerPatch>* CompiledMethodStorage::Deduplica
 
 void CompiledMethodStorage::ReleaseLinkerPatches(
     const LengthPrefixedArray<linker::LinkerPatch>* linker_patches) {
-  ReleaseArrayIfNotDeduplicated(linker_patches);
+  ReleaseArrayUse(linker_patches, &dedupe_linker_patches_);
 }
 
 CompiledMethodStorage::ThunkMapKey CompiledMethodStorage::GetThunkMapKey(
@@ -91,8 +91,9 @@ class CompiledMethodStorage {
   const LengthPrefixedArray<T>* AllocateOrDeduplicateArray(const ArrayRef<const T>& data,
                                                            DedupeSetType* dedupe_set);
 
-  template <typename T>
-  void ReleaseArrayIfNotDeduplicated(const LengthPrefixedArray<T>* array);
+  // Releases the array, or one use of it if it was deduplicated.
+  template <typename T, typename DedupeSetType>
+  void ReleaseArrayUse(const LengthPrefixedArray<T>* array, DedupeSetType* dedupe_set);
 
   // DeDuplication data structures.
   template <typename ContentType>
@@ -98,4 +98,49 @@ TEST(CompiledMethodStorage, Deduplicate) {
   }
 }
 
+TEST(CompiledMethodStorage, ReleaseDeduplicated) {
+  CompiledMethodStorage storage(/* swap_fd= */ -1);
+  ASSERT_TRUE(storage.DedupeEnabled());
+
+  const uint8_t raw_code[] = { 1u, 2u, 3u };
+  const uint8_t raw_vmap_table[] = { 2, 4, 6 };
+  const uint8_t raw_cfi_info[] = { 1, 3, 5 };
+  const linker::LinkerPatch raw_patches[] = {
+      linker::LinkerPatch::IntrinsicReferencePatch(0u, 0u, 0u),
+  };
+  auto create_method = [&]() {
+    return CompiledMethod::SwapAllocCompiledMethod(
+        &storage,
+        InstructionSet::kNone,
+        ArrayRef<const uint8_t>(raw_code),
+        ArrayRef<const uint8_t>(raw_vmap_table),
+        ArrayRef<const uint8_t>(raw_cfi_info),
+        ArrayRef<const linker::LinkerPatch>(raw_patches));
+  };
+  CompiledMethod* method1 = create_method();
+  CompiledMethod* method2 = create_method();
+  ASSERT_EQ(method1->GetQuickCode().data(), method2->GetQuickCode().data());
+
+  // Releasing the data of one method keeps the deduplicated data of the other.
+  method1->ReleaseVmapTable();
+  method1->ReleaseCFIInfo();
+  method1->ReleaseCodeAndPatches();
+  EXPECT_TRUE(method1->GetQuickCode().empty());
+  EXPECT_TRUE(method1->GetVmapTable().empty());
+  EXPECT_TRUE(method1->GetCFIInfo().empty());
+  EXPECT_TRUE(method1->GetPatches().empty());
+  EXPECT_EQ(ArrayRef<const uint8_t>(raw_code), method2->GetQuickCode());
+  EXPECT_EQ(ArrayRef<const uint8_t>(raw_vmap_table), method2->GetVmapTable());
+  EXPECT_EQ(ArrayRef<const uint8_t>(raw_cfi_info), method2->GetCFIInfo());
+  EXPECT_EQ(1u, method2->GetPatches().size());
+
+  // New methods with the same data are deduplicated with the remaining method.
+  CompiledMethod* method3 = create_method();
+  EXPECT_EQ(method2->GetQuickCode().data(), method3->GetQuickCode().data());
+
+  CompiledMethod::ReleaseSwapAllocatedCompiledMethod(&storage, method1);
+  CompiledMethod::ReleaseSwapAllocatedCompiledMethod(&storage, method2);
+  CompiledMethod::ReleaseSwapAllocatedCompiledMethod(&storage, method3);
+}
+
 }  // namespace art
@@ -123,8 +123,11 @@ bool CompilerOptions::ParseRegisterAllocationStrategy(const std::string& option,
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorLinearScan;
   } else if (option == "graph-color") {
     register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorGraphColor;
+  } else if (option == "adaptive") {
+    register_allocation_strategy_ = RegisterAllocator::Strategy::kRegisterAllocatorAdaptive;
   } else {
-    *error_msg = "Unrecognized register allocation strategy. Try linear-scan, or graph-color.";
+    *error_msg = "Unrecognized register allocation strategy. Try linear-scan, graph-color, "
+                 "or adaptive.";
     return false;
   }
   return true;
@@ -82,7 +82,8 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->dump_cfg_append_ = true;
   }
   if (map.Exists(Base::RegisterAllocationStrategy)) {
-    if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::DumpInitFailures), error_msg)) {
+    if (!options->ParseRegisterAllocationStrategy(*map.Get(Base::RegisterAllocationStrategy),
+                                                  error_msg)) {
       return false;
     }
   }
@@ -232,6 +233,8 @@ inline void AddCompilerOptionsArgumentParserOptions(Builder& b) {
 
       .Define("--register-allocation-strategy=_")
           .template WithType<std::string>()
+          .WithHelp("linear-scan|graph-color|adaptive. adaptive uses graph coloring for OSR and\n"
+                    "profile-hot methods of moderate size, and linear scan otherwise.")
           .IntoKey(Map::RegisterAllocationStrategy)
 
       .Define("--resolve-startup-const-strings=_")
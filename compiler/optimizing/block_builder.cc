@@ -24,6 +24,89 @@
 
 namespace art {
 
+SwitchSearchTree::SwitchSearchTree(const DexSwitchTable& table,
+                                   uint32_t dex_pc,
+                                   ScopedArenaAllocator* allocator)
+    : table_(table),
+      dex_pc_(dex_pc),
+      nodes_(allocator->Adapter(kArenaAllocGraphBuilder)) {
+  DCHECK(ShouldBuild(table));
+  const size_t num_entries = table.GetNumEntries();
+
+  // Greedily partition the sorted keys into clusters, preferring the cluster
+  // kind which covers the most keys starting at `first`.
+  ScopedArenaVector<Node> clusters(allocator->Adapter(kArenaAllocGraphBuilder));
+  for (size_t first = 0; first != num_entries; ) {
+    size_t last_dense = first;
+    while (last_dense + 1u != num_entries && IsDenseCluster(first, last_dense + 1u)) {
+      ++last_dense;
+    }
+    size_t last_bit_test = first;
+    while (last_bit_test + 1u != num_entries && IsBitTestCluster(first, last_bit_test + 1u)) {
+      ++last_bit_test;
+    }
+    size_t dense_entries = last_dense - first + 1u;
+    size_t bit_test_entries = last_bit_test - first + 1u;
+    Node cluster = { NodeKind::kEqual, first, first, 0u, 0u, 0u };
+    if (bit_test_entries >= kMinimumBitTestEntries && bit_test_entries >= dense_entries) {
+      cluster.kind = NodeKind::kBitTestRange;
+      cluster.last = last_bit_test;
+    } else if (dense_entries >= kMinimumJumpTableEntries) {
+      cluster.kind = NodeKind::kJumpTable;
+      cluster.last = last_dense;
+    }
+    clusters.push_back(cluster);
+    first = cluster.last + 1u;
+  }
+
+  BuildNodes(ArrayRef<const Node>(clusters));
+  // Non-root nodes are stored at dex_pcs of the payload, which has 2 * num_entries slots.
+  DCHECK_LE(nodes_.size(), 2u * num_entries);
+}
+
+bool SwitchSearchTree::IsDenseCluster(size_t first, size_t last) const {
+  // Use a jump table if at least half of its entries are case targets.
+  int64_t range = static_cast<int64_t>(GetKey(last)) - GetKey(first) + 1;
+  return range <= 2 * static_cast<int64_t>(last - first + 1u);
+}
+
+bool SwitchSearchTree::IsBitTestCluster(size_t first, size_t last) const {
+  int64_t range = static_cast<int64_t>(GetKey(last)) - GetKey(first) + 1;
+  return range <= kMaximumBitTestRange && GetTargetDexPc(last) == GetTargetDexPc(first);
+}
+
+size_t SwitchSearchTree::BuildNodes(ArrayRef<const Node> clusters) {
+  DCHECK(!clusters.empty());
+  size_t id = nodes_.size();
+  if (clusters.size() == 1u) {
+    nodes_.push_back(clusters[0]);
+    if (clusters[0].kind == NodeKind::kBitTestRange) {
+      nodes_[id].true_id = id + 1u;
+      nodes_.push_back(Node{ NodeKind::kBitTest, clusters[0].first, clusters[0].last, 0u, 0u, 0u });
+    }
+    return id;
+  }
+
+  size_t middle = clusters.size() / 2u;
+  nodes_.push_back(
+      Node{ NodeKind::kLessThan, clusters.front().first, clusters.back().last, clusters[middle].first,
+            0u, 0u });
+  size_t true_id = BuildNodes(clusters.SubArray(0u, middle));
+  size_t false_id = BuildNodes(clusters.SubArray(middle));
+  nodes_[id].true_id = true_id;
+  nodes_[id].false_id = false_id;
+  return id;
+}
+
+int32_t SwitchSearchTree::GetBitTestMask(const Node& node) const {
+  DCHECK(node.kind == NodeKind::kBitTest);
+  uint32_t mask = 0u;
+  for (size_t i = node.first; i <= node.last; ++i) {
+    mask |= 1u << static_cast<uint32_t>(GetKey(i) - GetKey(node.first));
+  }
+  return static_cast<int32_t>(mask);
+}
+
 HBasicBlockBuilder::HBasicBlockBuilder(HGraph* graph,
                                        const DexFile* const dex_file,
                                        const CodeItemDebugInfoAccessor& accessor,
@@ -109,12 +192,22 @@ bool HBasicBlockBuilder::CreateBranchTargets() {
     } else if (instruction.IsSwitch()) {
       number_of_branches_++;  // count as at least one branch (b/77652521)
       DexSwitchTable table(instruction, dex_pc);
+      if (SwitchSearchTree::ShouldBuild(table)) {
+        // Create blocks for the nodes of the search tree, except for the root
+        // which is the block of the switch instruction.
+        SwitchSearchTree tree(table, dex_pc, local_allocator_);
+        for (size_t id = 1u; id != tree.GetNumberOfNodes(); ++id) {
+          MaybeCreateBlockAt(dex_pc, tree.GetDexPcForNode(id));
+        }
+      }
       for (DexSwitchTableIterator s_it(table); !s_it.Done(); s_it.Advance()) {
         MaybeCreateBlockAt(dex_pc + s_it.CurrentTargetOffset());
 
         // Create N-1 blocks where we will insert comparisons of the input value
         // against the Switch's case keys.
-        if (table.ShouldBuildDecisionTree() && !s_it.IsLast()) {
+        if (table.ShouldBuildDecisionTree() &&
+            !SwitchSearchTree::ShouldBuild(table) &&
+            !s_it.IsLast()) {
           // Store the block under dex_pc of the current key at the switch data
           // instruction for uniqueness but give it the dex_pc of the SWITCH
           // instruction which it semantically belongs to.
@@ -192,6 +285,12 @@ void HBasicBlockBuilder::ConnectBasicBlocks() {
       block->AddSuccessor(graph_->GetExitBlock());
     } else if (instruction.IsSwitch()) {
       DexSwitchTable table(instruction, dex_pc);
+      if (SwitchSearchTree::ShouldBuild(table)) {
+        HBasicBlock* default_block = GetBlockAt(std::next(DexInstructionIterator(pair)).DexPc());
+        ConnectSwitchSearchTree(block, table, dex_pc, default_block);
+        block = nullptr;
+        continue;
+      }
       for (DexSwitchTableIterator s_it(table); !s_it.Done(); s_it.Advance()) {
         uint32_t target_dex_pc = dex_pc + s_it.CurrentTargetOffset();
         block->AddSuccessor(GetBlockAt(target_dex_pc));
@@ -221,6 +320,51 @@ void HBasicBlockBuilder::ConnectBasicBlocks() {
   graph_->AddBlock(graph_->GetExitBlock());
 }
 
+void HBasicBlockBuilder::ConnectSwitchSearchTree(HBasicBlock* block,
+                                                 const DexSwitchTable& table,
+                                                 uint32_t dex_pc,
+                                                 HBasicBlock* default_block) {
+  SwitchSearchTree tree(table, dex_pc, local_allocator_);
+  for (size_t id = 0u; id != tree.GetNumberOfNodes(); ++id) {
+    const SwitchSearchTree::Node& node = tree.GetNode(id);
+    HBasicBlock* node_block = block;
+    if (id != 0u) {
+      node_block = GetBlockAt(tree.GetDexPcForNode(id));
+      graph_->AddBlock(node_block);
+    }
+    switch (node.kind) {
+      case SwitchSearchTree::NodeKind::kEqual:
+      case SwitchSearchTree::NodeKind::kBitTest:
+        node_block->AddSuccessor(GetBlockAt(tree.GetTargetDexPc(node.first)));
+        node_block->AddSuccessor(default_block);
+        break;
+      case SwitchSearchTree::NodeKind::kLessThan:
+        node_block->AddSuccessor(GetBlockAt(tree.GetDexPcForNode(node.true_id)));
+        node_block->AddSuccessor(GetBlockAt(tree.GetDexPcForNode(node.false_id)));
+        break;
+      case SwitchSearchTree::NodeKind::kBitTestRange:
+        node_block->AddSuccessor(GetBlockAt(tree.GetDexPcForNode(node.true_id)));
+        node_block->AddSuccessor(default_block);
+        break;
+      case SwitchSearchTree::NodeKind::kJumpTable: {
+        // One successor per value in the range, followed by the default block.
+        size_t index = node.first;
+        for (uint32_t i = 0u, range = tree.GetRange(node); i != range; ++i) {
+          if (static_cast<int64_t>(tree.GetKey(node.first)) + i == tree.GetKey(index)) {
+            node_block->AddSuccessor(GetBlockAt(tree.GetTargetDexPc(index)));
+            ++index;
+          } else {
+            node_block->AddSuccessor(default_block);
+          }
+        }
+        DCHECK_EQ(index, node.last + 1u);
+        node_block->AddSuccessor(default_block);
+        break;
+      }
+    }
+  }
+}
+
 // Returns the TryItem stored for `block` or nullptr if there is no info for it.
 static const dex::TryItem* GetTryItem(
     HBasicBlock* block,
@@ -17,14 +17,99 @@
 #ifndef ART_COMPILER_OPTIMIZING_BLOCK_BUILDER_H_
 #define ART_COMPILER_OPTIMIZING_BLOCK_BUILDER_H_
 
+#include "base/array_ref.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
+#include "dex/bytecode_utils.h"
 #include "dex/code_item_accessors.h"
 #include "dex/dex_file.h"
 #include "nodes.h"
 
 namespace art {
 
+// Lowering of a large sparse switch. The sorted keys are partitioned into clusters
+// which are each handled by a single comparison, a bit test against a mask of keys
+// sharing the same target, or a jump table (HPackedSwitch) for dense runs of keys.
+// The clusters are then arranged in a balanced binary search tree so that the number
+// of comparisons is logarithmic rather than linear in the number of keys.
+//
+// Both HBasicBlockBuilder and HInstructionBuilder walk the same nodes so that they
+// agree on the blocks of the tree and on the order of their successors. The root node
+// lives in the block of the switch instruction, the other nodes get blocks of their own.
+class SwitchSearchTree : public ValueObject {
+ public:
+  enum class NodeKind {
+    kEqual,         // if (value == key[first]) target[first] else default
+    kLessThan,      // if (value < key[split]) true_id else false_id
+    kJumpTable,     // HPackedSwitch over key[first] .. key[last], holes go to default
+    kBitTestRange,  // if ((value - key[first]) <u range) true_id else default
+    kBitTest,       // if (((mask >> (value - key[first])) & 1) != 0) target[first] else default
+  };
+
+  struct Node {
+    NodeKind kind;
+    size_t first;     // Index of the first key handled by this node.
+    size_t last;      // Index of the last key handled by this node.
+    size_t split;     // kLessThan: index of the first key handled by `false_id`.
+    size_t true_id;   // kLessThan, kBitTestRange: node reached when the condition holds.
+    size_t false_id;  // kLessThan: node reached when the condition does not hold.
+  };
+
+  SwitchSearchTree(const DexSwitchTable& table,
+                   uint32_t dex_pc,
+                   ScopedArenaAllocator* allocator);
+
+  static bool ShouldBuild(const DexSwitchTable& table) {
+    return table.IsSparse() && table.GetNumEntries() >= kMinimumNumberOfEntries;
+  }
+
+  size_t GetNumberOfNodes() const { return nodes_.size(); }
+  const Node& GetNode(size_t id) const { return nodes_[id]; }
+
+  // Returns the dex_pc under which the block of a non-root node is stored. Like the
+  // blocks of the comparison chain of small switches, these are keyed by dex_pcs
+  // inside the switch payload for uniqueness.
+  uint32_t GetDexPcForNode(size_t id) const {
+    DCHECK_NE(id, 0u);
+    return table_.GetDexPcForIndex(id - 1u);
+  }
+
+  int32_t GetKey(size_t index) const { return table_.GetEntryAt(index); }
+
+  uint32_t GetTargetDexPc(size_t index) const {
+    return dex_pc_ + table_.GetEntryAt(table_.GetFirstValueIndex() + index);
+  }
+
+  // Returns the number of values covered by a kJumpTable or kBitTestRange node.
+  uint32_t GetRange(const Node& node) const {
+    return static_cast<uint32_t>(
+        static_cast<int64_t>(GetKey(node.last)) - GetKey(node.first) + 1);
+  }
+
+  // Returns the mask of the keys handled by a kBitTest node, relative to `key[first]`.
+  int32_t GetBitTestMask(const Node& node) const;
+
+  // Sparse switches with fewer keys keep the linear chain of comparisons.
+  static constexpr size_t kMinimumNumberOfEntries = 5;
+  // Minimum number of keys to use a jump table, matching packed switches.
+  static constexpr size_t kMinimumJumpTableEntries = 4;
+  // Minimum number of keys with the same target to use a bit test.
+  static constexpr size_t kMinimumBitTestEntries = 3;
+  // Bit tests use a 32-bit mask.
+  static constexpr uint32_t kMaximumBitTestRange = 32;
+
+ private:
+  bool IsDenseCluster(size_t first, size_t last) const;
+  bool IsBitTestCluster(size_t first, size_t last) const;
+  size_t BuildNodes(ArrayRef<const Node> clusters);
+
+  const DexSwitchTable& table_;
+  const uint32_t dex_pc_;
+  ScopedArenaVector<Node> nodes_;
+
+  DISALLOW_COPY_AND_ASSIGN(SwitchSearchTree);
+};
+
 class HBasicBlockBuilder : public ValueObject {
  public:
   HBasicBlockBuilder(HGraph* graph,
@@ -57,6 +142,13 @@ class HBasicBlockBuilder : public ValueObject {
 
   bool CreateBranchTargets();
   void ConnectBasicBlocks();
+
+  // Connects the blocks of the search tree for the sparse switch at `dex_pc`,
+  // rooted at `block`, to the case targets and to `default_block`.
+  void ConnectSwitchSearchTree(HBasicBlock* block,
+                               const DexSwitchTable& table,
+                               uint32_t dex_pc,
+                               HBasicBlock* default_block);
   void InsertTryBoundaryBlocks();
 
   // To ensure branches with negative offsets can always OSR jump to compiled
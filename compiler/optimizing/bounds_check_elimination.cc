@@ -502,6 +502,11 @@ class BCEVisitor : public HGraphVisitor {
   static constexpr uint32_t kMaxLengthForAddingDeoptimize =
       std::numeric_limits<int32_t>::max() - 1024 * 1024;
 
+  // Compile-time budget for the loop-invariant null checks that are replaced by a
+  // deoptimization test in the loop preheader. Each of them requires range analysis
+  // of the loop control and adds a test to the preheader.
+  static constexpr size_t kMaxLoopNullChecksForDeoptimize = 16;
+
   // Added blocks for loop body entry test.
   bool IsAddedBlock(HBasicBlock* block) const {
     return block->GetBlockId() >= initial_block_size_;
@@ -525,6 +530,7 @@ class BCEVisitor : public HGraphVisitor {
                          allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
         finite_loop_(allocator_.Adapter(kArenaAllocBoundsCheckElimination)),
         has_dom_based_dynamic_bce_(false),
+        number_of_loop_null_check_deopts_(0u),
         initial_block_size_(graph->GetBlocks().size()),
         side_effects_(side_effects),
         induction_range_(induction_analysis),
@@ -1360,6 +1366,65 @@ class BCEVisitor : public HGraphVisitor {
     }
   }
 
+  /**
+   * Speculatively hoists a null check on a loop invariant reference out of the loop, using
+   * a deoptimization test in the preheader. This exposes the field loads and array lengths
+   * of the reference that are partially redundant across iterations, which are hoisted below.
+   *
+   * for (int i = 0; i < n; i++) {
+   *   sum += obj.field;  // null check and load repeated on every iteration
+   * }
+   *
+   * The check must be executed on every iteration (see DynamicBCESeemsProfitable()), so the
+   * deoptimization only happens when the loop would throw anyway. Otherwise, the check is
+   * left in the loop.
+   */
+  void VisitNullCheck(HNullCheck* check) override {
+    HLoopInformation* loop = check->GetBlock()->GetLoopInformation();
+    if (loop == nullptr ||
+        !loop->IsDefinedOutOfTheLoop(check->InputAt(0)) ||
+        number_of_loop_null_check_deopts_ >= kMaxLoopNullChecksForDeoptimize ||
+        !DynamicBCESeemsProfitable(loop, check->GetBlock())) {
+      return;
+    }
+    // The deoptimization test is guarded by a taken-test of the loop control, which
+    // requires range analysis of the loop control induction. A potentially infinite
+    // loop is fine here, since the check would throw on the first iteration already.
+    HInstruction* control = GetLoopControlInduction(loop);
+    bool needs_finite_test = false;
+    bool needs_taken_test = false;
+    if (control != nullptr &&
+        induction_range_.CanGenerateRange(
+            check, control, &needs_finite_test, &needs_taken_test) &&
+        CanHandleNullCheck(loop, check, needs_taken_test)) {
+      ++number_of_loop_null_check_deopts_;
+    }
+  }
+
+  /** Hoists invariant field loads exposed by loop null check elimination (see VisitArrayGet()). */
+  void VisitInstanceFieldGet(HInstanceFieldGet* field_get) override {
+    TryHoistInvariantLoad(field_get);
+  }
+
+  /** Hoists invariant array lengths exposed by loop null check elimination. */
+  void VisitArrayLength(HArrayLength* array_length) override {
+    TryHoistInvariantLoad(array_length);
+  }
+
+  void TryHoistInvariantLoad(HInstruction* instruction) {
+    DCHECK(instruction->IsInstanceFieldGet() || instruction->IsArrayLength());
+    if (!has_dom_based_dynamic_bce_ && instruction->IsInLoop() && instruction->CanBeMoved()) {
+      HLoopInformation* loop = instruction->GetBlock()->GetLoopInformation();
+      if (loop->IsDefinedOutOfTheLoop(instruction->InputAt(0))) {
+        SideEffects loop_effects = side_effects_.GetLoopEffects(loop->GetHeader());
+        if (!instruction->GetSideEffects().MayDependOn(loop_effects) &&
+            loop->DominatesAllBackEdges(instruction->GetBlock())) {
+          HoistToPreHeaderOrDeoptBlock(loop, instruction);
+        }
+      }
+    }
+  }
+
   /** Performs dominator-based dynamic elimination on suitable set of bounds checks. */
   void AddCompareWithDeoptimization(HBasicBlock* block,
                                     HInstruction* array_length,
@@ -1706,6 +1771,24 @@ class BCEVisitor : public HGraphVisitor {
     return false;
   }
 
+  /**
+   * Returns the loop header phi that controls the exit test of the loop, or null if the
+   * loop header does not end with a test on such a phi.
+   */
+  HInstruction* GetLoopControlInduction(HLoopInformation* loop) {
+    HBasicBlock* header = loop->GetHeader();
+    HInstruction* control = header->GetLastInstruction();
+    if (!control->IsIf() || !control->InputAt(0)->IsCondition()) {
+      return nullptr;
+    }
+    for (HInstruction* input : control->InputAt(0)->GetInputs()) {
+      if (input->IsPhi() && input->GetBlock() == header) {
+        return input;
+      }
+    }
+    return nullptr;
+  }
+
   /**
    * Returns true if the array length is already loop invariant, or can be made so
    * by handling the null check under the hood of the array length operation.
@@ -2026,6 +2109,9 @@ class BCEVisitor : public HGraphVisitor {
   // Flag that denotes whether dominator-based dynamic elimination has occurred.
   bool has_dom_based_dynamic_bce_;
 
+  // Number of loop null checks replaced by a deoptimization test.
+  size_t number_of_loop_null_check_deopts_;
+
   // Initial number of blocks.
   uint32_t initial_block_size_;
 
@@ -2042,7 +2128,8 @@ class BCEVisitor : public HGraphVisitor {
 };
 
 bool BoundsCheckElimination::Run() {
-  if (!graph_->HasBoundsChecks()) {
+  // Besides bounds checks, null checks in loops may be eliminated.
+  if (!graph_->HasBoundsChecks() && !graph_->HasLoops()) {
     return false;
   }
 
@@ -3650,6 +3650,36 @@ void InstructionCodeGeneratorARM64::VisitIf(HIf* if_instr) {
   if (codegen_->GoesToNextBlock(if_instr->GetBlock(), false_successor)) {
     false_target = nullptr;
   }
+  if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
+    if (GetGraph()->IsCompilingBaseline() && !Runtime::Current()->IsAotCompiler()) {
+      ScopedProfilingInfoUse spiu(
+          Runtime::Current()->GetJit(), GetGraph()->GetArtMethod(), Thread::Current());
+      ProfilingInfo* info = spiu.GetProfilingInfo();
+      if (info != nullptr) {
+        BranchCache* cache = info->GetBranchCache(if_instr->GetDexPc());
+        // Currently, not all If branches are profiled.
+        if (cache != nullptr) {
+          uint64_t address =
+              reinterpret_cast64<uint64_t>(cache) + BranchCache::FalseOffset().Int32Value();
+          static_assert(
+              BranchCache::TrueOffset().Int32Value() - BranchCache::FalseOffset().Int32Value() == 2,
+              "Unexpected offsets for BranchCache");
+          vixl::aarch64::Label done;
+          UseScratchRegisterScope temps(GetVIXLAssembler());
+          Register temp = temps.AcquireX();
+          Register counter = temps.AcquireW();
+          Register condition = InputRegisterAt(if_instr, 0);
+          __ Mov(temp, address);
+          __ Ldrh(counter, MemOperand(temp, condition, UXTW, 1));
+          __ Add(counter, counter, 1);
+          // Do not store the counter if it would overflow.
+          __ Tbnz(counter, 16, &done);
+          __ Strh(counter, MemOperand(temp, condition, UXTW, 1));
+          __ Bind(&done);
+        }
+      }
+    }
+  }
   GenerateTestAndBranch(if_instr, /* condition_input_index= */ 0, true_target, false_target);
 }
 
@@ -226,10 +226,27 @@ void InstructionCodeGeneratorX86::VisitVecReduce(HVecReduce* instruction) {
           __ phaddd(dst, dst);
           break;
         case HVecReduce::kMin:
-        case HVecReduce::kMax:
-          // Historical note: We've had a broken implementation here. b/117863065
-          // Do not draw on the old code if we ever want to bring MIN/MAX reduction back.
-          LOG(FATAL) << "Unsupported reduction type.";
+        case HVecReduce::kMax: {
+          // Reduce pairwise: combine the two 64-bit halves, then the two
+          // remaining 32-bit lanes, so that every lane takes part exactly once.
+          // (A previous implementation was broken, see b/117863065.)
+          XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+          bool is_min = instruction->GetReductionKind() == HVecReduce::kMin;
+          __ pshufd(tmp, src, Immediate(0x4e));
+          __ movaps(dst, src);
+          if (is_min) {
+            __ pminsd(dst, tmp);
+          } else {
+            __ pmaxsd(dst, tmp);
+          }
+          __ pshufd(tmp, dst, Immediate(0xb1));
+          if (is_min) {
+            __ pminsd(dst, tmp);
+          } else {
+            __ pmaxsd(dst, tmp);
+          }
+          break;
+        }
       }
       break;
     case DataType::Type::kInt64: {
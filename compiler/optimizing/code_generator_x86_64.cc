@@ -1961,7 +1961,12 @@ void InstructionCodeGeneratorX86_64::GenerateTestAndBranch(HInstruction* instruc
 void LocationsBuilderX86_64::VisitIf(HIf* if_instr) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(if_instr);
   if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
-    locations->SetInAt(0, Location::Any());
+    // Baseline JIT code indexes the branch cache with the condition, see VisitIf below.
+    if (GetGraph()->IsCompilingBaseline() && !Runtime::Current()->IsAotCompiler()) {
+      locations->SetInAt(0, Location::RequiresRegister());
+    } else {
+      locations->SetInAt(0, Location::Any());
+    }
   }
 }
 
@@ -1972,6 +1977,35 @@ void InstructionCodeGeneratorX86_64::VisitIf(HIf* if_instr) {
       nullptr : codegen_->GetLabelOf(true_successor);
   Label* false_target = codegen_->GoesToNextBlock(if_instr->GetBlock(), false_successor) ?
       nullptr : codegen_->GetLabelOf(false_successor);
+  if (IsBooleanValueOrMaterializedCondition(if_instr->InputAt(0))) {
+    Location cond_val = if_instr->GetLocations()->InAt(0);
+    if (GetGraph()->IsCompilingBaseline() && !Runtime::Current()->IsAotCompiler()) {
+      DCHECK(cond_val.IsRegister());
+      ScopedProfilingInfoUse spiu(
+          Runtime::Current()->GetJit(), GetGraph()->GetArtMethod(), Thread::Current());
+      ProfilingInfo* info = spiu.GetProfilingInfo();
+      if (info != nullptr) {
+        BranchCache* cache = info->GetBranchCache(if_instr->GetDexPc());
+        // Currently, not all If branches are profiled.
+        if (cache != nullptr) {
+          uint64_t address =
+              reinterpret_cast64<uint64_t>(cache) + BranchCache::FalseOffset().Int32Value();
+          static_assert(
+              BranchCache::TrueOffset().Int32Value() - BranchCache::FalseOffset().Int32Value() == 2,
+              "Unexpected offsets for BranchCache");
+          NearLabel done;
+          Address counter_address(
+              CpuRegister(TMP), cond_val.AsRegister<CpuRegister>(), TIMES_2, /* disp= */ 0);
+          __ movq(CpuRegister(TMP), Immediate(address));
+          // Do not increment the counter if it would overflow.
+          __ cmpw(counter_address, Immediate(-1));
+          __ j(kEqual, &done);
+          __ addw(counter_address, Immediate(1));
+          __ Bind(&done);
+        }
+      }
+    }
+  }
   GenerateTestAndBranch(if_instr, /* condition_input_index= */ 0, true_target, false_target);
 }
 
@@ -141,7 +141,9 @@ bool DoesNotEscape(HInstruction* reference, NoEscapeCheck& no_escape);
 inline bool DoesNotEscape(HInstruction* reference,
                           bool (*no_escape_fn)(HInstruction*, HInstruction*)) {
   LambdaNoEscapeCheck<typeof(no_escape_fn)> esc(no_escape_fn);
-  return DoesNotEscape(reference, esc);
+  LambdaNoEscapeCheck noop_esc([](HInstruction*, HInstruction*) { return false; });
+  return DoesNotEscape(reference,
+                       no_escape_fn == nullptr ? static_cast<NoEscapeCheck&>(noop_esc) : esc);
 }
 
 }  // namespace art
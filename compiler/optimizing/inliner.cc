@@ -16,9 +16,13 @@
 
 #include "inliner.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/logging.h"
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
 #include "builder.h"
 #include "class_linker.h"
 #include "class_root-inl.h"
@@ -34,17 +38,21 @@
 #include "intrinsics.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
+#include "jit/profiling_info.h"
 #include "mirror/class_loader.h"
 #include "mirror/dex_cache.h"
 #include "mirror/object_array-alloc-inl.h"
 #include "mirror/object_array-inl.h"
 #include "nodes.h"
+#include "oat_quick_method_header.h"
+#include "profile/profile_compilation_info.h"
 #include "reference_type_propagation.h"
 #include "register_allocator_linear_scan.h"
 #include "scoped_thread_state_change-inl.h"
 #include "sharpening.h"
 #include "ssa_builder.h"
 #include "ssa_phi_elimination.h"
+#include "stack_map.h"
 #include "thread.h"
 
 namespace art {
@@ -52,6 +60,10 @@ namespace art {
 // Instruction limit to control memory.
 static constexpr size_t kMaximumNumberOfTotalInstructions = 1024;
 
+// Instruction limit for OSR compilation. An OSR method contains a hot loop and is
+// compiled at most once, so it can afford more inlining.
+static constexpr size_t kMaximumNumberOfTotalInstructionsForOsr = 2048;
+
 // Maximum number of instructions for considering a method small,
 // which we will always try to inline if the other non-instruction limits
 // are not reached.
@@ -115,17 +127,81 @@ static size_t CountNumberOfInstructions(HGraph* graph) {
   return number_of_instructions;
 }
 
+size_t HInliner::GetMaximumNumberOfTotalInstructions() const {
+  if (outermost_graph_->IsCompilingOsr()) {
+    return kMaximumNumberOfTotalInstructionsForOsr;
+  } else {
+    return kMaximumNumberOfTotalInstructions;
+  }
+}
+
 void HInliner::UpdateInliningBudget() {
-  if (total_number_of_instructions_ >= kMaximumNumberOfTotalInstructions) {
+  const size_t maximum_number_of_total_instructions = GetMaximumNumberOfTotalInstructions();
+  if (total_number_of_instructions_ >= maximum_number_of_total_instructions) {
     // Always try to inline small methods.
     inlining_budget_ = kMaximumNumberOfInstructionsForSmallMethod;
   } else {
     inlining_budget_ = std::max(
         kMaximumNumberOfInstructionsForSmallMethod,
-        kMaximumNumberOfTotalInstructions - total_number_of_instructions_);
+        maximum_number_of_total_instructions - total_number_of_instructions_);
   }
 }
 
+// Returns the hotness of `method` as seen by the JIT. The interpreter counter is reset
+// when the method gets compiled and saturates under nterp, so it only ranks methods
+// that still run in the interpreter. Baseline compiled code counts in the ProfilingInfo
+// instead, and a method with optimized code already was among the hottest. Abstract and
+// native methods have no hotness counter, their JIT code would be a JNI stub anyway.
+static uint32_t GetJitHotness(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (method->IsAbstract() || method->IsNative()) {
+    return 0u;
+  }
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  const void* entry_point = method->GetEntryPointFromQuickCompiledCode();
+  if (jit->GetCodeCache()->ContainsPc(entry_point)) {
+    OatQuickMethodHeader* method_header = OatQuickMethodHeader::FromEntryPoint(entry_point);
+    if (method_header->IsOptimized() &&
+        !CodeInfo::IsBaseline(method_header->GetOptimizedCodeInfoPtr())) {
+      return ArtMethod::MaxCounter();
+    }
+  }
+  uint32_t hotness = method->GetCounter();
+  ScopedProfilingInfoUse spiu(jit, method, Thread::Current());
+  ProfilingInfo* info = spiu.GetProfilingInfo();
+  if (info != nullptr) {
+    hotness = std::max<uint32_t>(hotness, info->GetBaselineHotnessCount());
+  }
+  return hotness;
+}
+
+uint64_t HInliner::GetCallSiteWeight(HInvoke* invoke_instruction) const {
+  // Calls in loops are assumed to be executed more often than calls outside,
+  // whatever their profile says.
+  uint64_t loop_depth = 0u;
+  for (HLoopInformationOutwardIterator it(*invoke_instruction->GetBlock());
+       !it.Done();
+       it.Advance()) {
+    ++loop_depth;
+  }
+
+  // Then order by the hotness of the callee.
+  uint64_t hotness = 0u;
+  ArtMethod* resolved_method = invoke_instruction->GetResolvedMethod();
+  if (resolved_method != nullptr) {
+    const CompilerOptions& compiler_options = codegen_->GetCompilerOptions();
+    const ProfileCompilationInfo* pci = compiler_options.GetProfileCompilationInfo();
+    if (compiler_options.IsJitCompiler()) {
+      hotness = GetJitHotness(resolved_method);
+    } else if (pci != nullptr &&
+               pci->GetMethodHotness(MethodReference(
+                   resolved_method->GetDexFile(), resolved_method->GetDexMethodIndex())).IsHot()) {
+      hotness = ArtMethod::MaxCounter();
+    }
+  }
+  static_assert(ArtMethod::MaxCounter() <= std::numeric_limits<uint32_t>::max());
+  return (loop_depth << 32) | hotness;
+}
+
 bool HInliner::Run() {
   if (codegen_->GetCompilerOptions().GetInlineMaxCodeUnits() == 0) {
     // Inlining effectively disabled.
@@ -159,40 +235,58 @@ bool HInliner::Run() {
   const bool honor_inline_directives =
       honor_noinline_directives && Runtime::Current()->IsAotCompiler();
 
-  // Keep a copy of all blocks when starting the visit.
-  ArenaVector<HBasicBlock*> blocks = graph_->GetReversePostOrder();
-  DCHECK(!blocks.empty());
-  // Because we are changing the graph when inlining,
-  // we just iterate over the blocks of the outer method.
-  // This avoids doing the inlining work again on the inlined blocks.
-  for (HBasicBlock* block : blocks) {
-    for (HInstruction* instruction = block->GetFirstInstruction(); instruction != nullptr;) {
-      HInstruction* next = instruction->GetNext();
-      HInvoke* call = instruction->AsInvoke();
-      // As long as the call is not intrinsified, it is worth trying to inline.
-      if (call != nullptr && call->GetIntrinsic() == Intrinsics::kNone) {
-        if (honor_noinline_directives) {
-          // Debugging case: directives in method names control or assert on inlining.
-          std::string callee_name =
-              call->GetMethodReference().PrettyMethod(/* with_signature= */ false);
-          // Tests prevent inlining by having $noinline$ in their method names.
-          if (callee_name.find("$noinline$") == std::string::npos) {
-            if (TryInline(call)) {
-              didInline = true;
-            } else if (honor_inline_directives) {
-              bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
-              CHECK(!should_have_inlined) << "Could not inline " << callee_name;
-            }
-          }
-        } else {
-          DCHECK(!honor_inline_directives);
-          // Normal case: try to inline.
-          if (TryInline(call)) {
-            didInline = true;
-          }
+  // Because we are changing the graph when inlining, we collect the call sites
+  // of the outer method first. This avoids doing the inlining work again on the
+  // inlined blocks. As long as the call is not intrinsified, it is worth trying
+  // to inline.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<std::pair<uint64_t, HInvoke*>> call_sites(
+      allocator.Adapter(kArenaAllocMisc));
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        HInvoke* call = it.Current()->AsInvoke();
+        if (call != nullptr && call->GetIntrinsic() == Intrinsics::kNone) {
+          call_sites.emplace_back(GetCallSiteWeight(call), call);
         }
       }
-      instruction = next;
+    }
+  }
+  // Spend the budget on the hottest call sites first. Call sites of equal
+  // weight are tried in reverse post order.
+  std::stable_sort(call_sites.begin(),
+                   call_sites.end(),
+                   [](const std::pair<uint64_t, HInvoke*>& lhs,
+                      const std::pair<uint64_t, HInvoke*>& rhs) {
+                     return lhs.first > rhs.first;
+                   });
+
+  for (const std::pair<uint64_t, HInvoke*>& call_site : call_sites) {
+    HInvoke* call = call_site.second;
+    DCHECK(call->IsInBlock());
+    LOG_NOTE() << "Call site weight " << (call_site.first >> 32) << ":"
+               << (call_site.first & std::numeric_limits<uint32_t>::max()) << " for "
+               << call->GetMethodReference().PrettyMethod();
+    if (honor_noinline_directives) {
+      // Debugging case: directives in method names control or assert on inlining.
+      std::string callee_name =
+          call->GetMethodReference().PrettyMethod(/* with_signature= */ false);
+      // Tests prevent inlining by having $noinline$ in their method names.
+      if (callee_name.find("$noinline$") == std::string::npos) {
+        if (TryInline(call)) {
+          didInline = true;
+        } else if (honor_inline_directives) {
+          bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
+          CHECK(!should_have_inlined) << "Could not inline " << callee_name;
+        }
+      }
+    } else {
+      DCHECK(!honor_inline_directives);
+      // Normal case: try to inline.
+      if (TryInline(call)) {
+        didInline = true;
+      }
     }
   }
 
@@ -294,9 +294,19 @@ class HInliner : public HOptimization {
                                                 HInstruction* return_replacement,
                                                 HInstruction* invoke_instruction);
 
+  // Returns the limit on the total number of instructions of the outermost graph,
+  // which is higher for OSR compilations.
+  size_t GetMaximumNumberOfTotalInstructions() const;
+
   // Update the inlining budget based on `total_number_of_instructions_`.
   void UpdateInliningBudget();
 
+  // Returns the weight of `invoke_instruction` used to try the hottest call sites
+  // first. The upper 32 bits are the loop depth of the call site, the lower 32 bits
+  // the profiled hotness of the callee.
+  uint64_t GetCallSiteWeight(HInvoke* invoke_instruction) const
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Count the number of calls of `method` being inlined recursively.
   size_t CountRecursiveCallsOf(ArtMethod* method) const;
 
@@ -16,6 +16,8 @@
 
 #include "instruction_builder.h"
 
+#include <optional>
+
 #include "art_method-inl.h"
 #include "base/arena_bit_vector.h"
 #include "base/bit_vector-inl.h"
@@ -32,6 +34,7 @@
 #include "intrinsics.h"
 #include "intrinsics_utils.h"
 #include "jit/jit.h"
+#include "jit/profiling_info.h"
 #include "mirror/dex_cache.h"
 #include "oat_file.h"
 #include "optimizing_compiler_stats.h"
@@ -110,6 +113,7 @@ HInstructionBuilder::HInstructionBuilder(HGraph* graph,
       latest_result_(nullptr),
       current_this_parameter_(nullptr),
       loop_headers_(local_allocator->Adapter(kArenaAllocGraphBuilder)),
+      profiling_info_(nullptr),
       class_cache_(std::less<dex::TypeIndex>(), local_allocator->Adapter(kArenaAllocGraphBuilder)) {
   loop_headers_.reserve(kDefaultNumberOfLoops);
 }
@@ -363,6 +367,16 @@ bool HInstructionBuilder::Build() {
     native_debug_info_locations = FindNativeDebugInfoLocations();
   }
 
+  // When JIT compiling optimized code, use the branch profile collected by baseline code.
+  std::optional<ScopedProfilingInfoUse> spiu;
+  if (code_generator_ != nullptr &&
+      code_generator_->GetCompilerOptions().IsJitCompiler() &&
+      !graph_->IsCompilingBaseline() &&
+      graph_->GetArtMethod() != nullptr) {
+    spiu.emplace(Runtime::Current()->GetJit(), graph_->GetArtMethod(), Thread::Current());
+    profiling_info_ = spiu->GetProfilingInfo();
+  }
+
   for (HBasicBlock* block : graph_->GetReversePostOrder()) {
     current_block_ = block;
     uint32_t block_dex_pc = current_block_->GetDexPc();
@@ -435,6 +449,7 @@ bool HInstructionBuilder::Build() {
   }
 
   SetLoopHeaderPhiInputs();
+  profiling_info_ = nullptr;
 
   return true;
 }
@@ -642,13 +657,25 @@ void HInstructionBuilder::InitializeParameters() {
   }
 }
 
+void HInstructionBuilder::BuildIf(HInstruction* condition, uint32_t dex_pc) {
+  HIf* if_instr = new (allocator_) HIf(condition, dex_pc);
+  if (profiling_info_ != nullptr) {
+    BranchCache* cache = profiling_info_->GetBranchCache(dex_pc);
+    if (cache != nullptr) {
+      if_instr->SetTrueCount(cache->GetTrue());
+      if_instr->SetFalseCount(cache->GetFalse());
+    }
+  }
+  AppendInstruction(if_instr);
+}
+
 template<typename T>
 void HInstructionBuilder::If_22t(const Instruction& instruction, uint32_t dex_pc) {
   HInstruction* first = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
   HInstruction* second = LoadLocal(instruction.VRegB(), DataType::Type::kInt32);
   T* comparison = new (allocator_) T(first, second, dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+  BuildIf(comparison, dex_pc);
   current_block_ = nullptr;
 }
 
@@ -657,7 +684,7 @@ void HInstructionBuilder::If_21t(const Instruction& instruction, uint32_t dex_pc
   HInstruction* value = LoadLocal(instruction.VRegA(), DataType::Type::kInt32);
   T* comparison = new (allocator_) T(value, graph_->GetIntConstant(0, dex_pc), dex_pc);
   AppendInstruction(comparison);
-  AppendInstruction(new (allocator_) HIf(comparison, dex_pc));
+  BuildIf(comparison, dex_pc);
   current_block_ = nullptr;
 }
 
@@ -784,6 +811,8 @@ void HInstructionBuilder::BuildSwitch(const Instruction& instruction, uint32_t d
     // Empty Switch. Code falls through to the next block.
     DCHECK(IsFallthroughInstruction(instruction, dex_pc, current_block_));
     AppendInstruction(new (allocator_) HGoto(dex_pc));
+  } else if (SwitchSearchTree::ShouldBuild(table)) {
+    BuildSwitchSearchTree(table, value, dex_pc);
   } else if (table.ShouldBuildDecisionTree()) {
     for (DexSwitchTableIterator it(table); !it.Done(); it.Advance()) {
       HInstruction* case_value = graph_->GetIntConstant(it.CurrentKey(), dex_pc);
@@ -803,6 +832,56 @@ void HInstructionBuilder::BuildSwitch(const Instruction& instruction, uint32_t d
   current_block_ = nullptr;
 }
 
+void HInstructionBuilder::BuildSwitchSearchTree(const DexSwitchTable& table,
+                                                HInstruction* value,
+                                                uint32_t dex_pc) {
+  SwitchSearchTree tree(table, dex_pc, local_allocator_);
+  HInstruction* bit_test_offset = nullptr;
+  for (size_t id = 0u; id != tree.GetNumberOfNodes(); ++id) {
+    const SwitchSearchTree::Node& node = tree.GetNode(id);
+    if (id != 0u) {
+      current_block_ = FindBlockStartingAt(tree.GetDexPcForNode(id));
+    }
+    HInstruction* first_key = graph_->GetIntConstant(tree.GetKey(node.first), dex_pc);
+    HCondition* condition = nullptr;
+    switch (node.kind) {
+      case SwitchSearchTree::NodeKind::kEqual:
+        condition = new (allocator_) HEqual(value, first_key, dex_pc);
+        break;
+      case SwitchSearchTree::NodeKind::kLessThan:
+        condition = new (allocator_) HLessThan(
+            value, graph_->GetIntConstant(tree.GetKey(node.split), dex_pc), dex_pc);
+        break;
+      case SwitchSearchTree::NodeKind::kJumpTable:
+        AppendInstruction(new (allocator_) HPackedSwitch(
+            tree.GetKey(node.first), tree.GetRange(node), value, dex_pc));
+        continue;
+      case SwitchSearchTree::NodeKind::kBitTestRange:
+        // The bit test node is the next one and reuses the offset.
+        bit_test_offset = new (allocator_) HSub(DataType::Type::kInt32, value, first_key, dex_pc);
+        AppendInstruction(bit_test_offset);
+        condition = new (allocator_) HBelow(
+            bit_test_offset, graph_->GetIntConstant(tree.GetRange(node), dex_pc), dex_pc);
+        break;
+      case SwitchSearchTree::NodeKind::kBitTest: {
+        DCHECK(bit_test_offset != nullptr);
+        HInstruction* mask = graph_->GetIntConstant(tree.GetBitTestMask(node), dex_pc);
+        HInstruction* shifted =
+            new (allocator_) HShr(DataType::Type::kInt32, mask, bit_test_offset, dex_pc);
+        AppendInstruction(shifted);
+        HInstruction* bit = new (allocator_) HAnd(
+            DataType::Type::kInt32, shifted, graph_->GetIntConstant(1, dex_pc), dex_pc);
+        AppendInstruction(bit);
+        condition = new (allocator_) HNotEqual(bit, graph_->GetIntConstant(0, dex_pc), dex_pc);
+        bit_test_offset = nullptr;
+        break;
+      }
+    }
+    AppendInstruction(condition);
+    AppendInstruction(new (allocator_) HIf(condition, dex_pc));
+  }
+}
+
 void HInstructionBuilder::BuildReturn(const Instruction& instruction,
                                       DataType::Type type,
                                       uint32_t dex_pc) {
@@ -34,10 +34,12 @@ class ArtField;
 class ArtMethod;
 class CodeGenerator;
 class DexCompilationUnit;
+class DexSwitchTable;
 class HBasicBlockBuilder;
 class Instruction;
 class InstructionOperands;
 class OptimizingCompilerStats;
+class ProfilingInfo;
 class ScopedObjectAccess;
 class SsaBuilder;
 
@@ -118,6 +120,10 @@ class HInstructionBuilder : public ValueObject {
   template<typename T> void If_21t(const Instruction& instruction, uint32_t dex_pc);
   template<typename T> void If_22t(const Instruction& instruction, uint32_t dex_pc);
 
+  // Appends an HIf on `condition`, annotated with the branch profile collected
+  // by baseline JIT code, if any.
+  void BuildIf(HInstruction* condition, uint32_t dex_pc);
+
   void Conversion_12x(const Instruction& instruction,
                       DataType::Type input_type,
                       DataType::Type result_type,
@@ -210,6 +216,10 @@ class HInstructionBuilder : public ValueObject {
   // Builds an instruction sequence for a switch statement.
   void BuildSwitch(const Instruction& instruction, uint32_t dex_pc);
 
+  // Builds the search tree lowering of a large sparse switch on `value`,
+  // in the blocks created by HBasicBlockBuilder.
+  void BuildSwitchSearchTree(const DexSwitchTable& table, HInstruction* value, uint32_t dex_pc);
+
   // Builds a `HLoadString` loading the given `string_index`.
   void BuildLoadString(dex::StringIndex string_index, uint32_t dex_pc);
 
@@ -334,6 +344,10 @@ class HInstructionBuilder : public ValueObject {
 
   ScopedArenaVector<HBasicBlock*> loop_headers_;
 
+  // Profiling info of the method, used for branch profiles when JIT compiling
+  // optimized code. Valid only while Build() runs.
+  ProfilingInfo* profiling_info_;
+
   // Cached resolved types for the current compilation unit's DexFile.
   // Handle<>s reference entries in the `graph_->GetHandleCache()`.
   ScopedArenaSafeMap<dex::TypeIndex, Handle<mirror::Class>> class_cache_;
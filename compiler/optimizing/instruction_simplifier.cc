@@ -1109,6 +1109,9 @@ void InstructionSimplifierVisitor::VisitIf(HIf* instruction) {
     // Swap successors if input is negated.
     instruction->ReplaceInput(condition->InputAt(0), 0);
     instruction->GetBlock()->SwapSuccessors();
+    uint16_t true_count = instruction->GetTrueCount();
+    instruction->SetTrueCount(instruction->GetFalseCount());
+    instruction->SetFalseCount(true_count);
     RecordSimplification();
   }
 }
@@ -386,6 +386,53 @@ TEST_F(InstructionSimplifierTest, SimplifyPredicatedFieldGetNoNull) {
   EXPECT_INS_EQ(ifget->InputAt(0), obj_phi);
 }
 
+// The branch profile of an If must follow its successors when the
+// simplifier removes a negation of the condition.
+TEST_F(InstructionSimplifierTest, SimplifyIfBooleanNotSwapsBranchCounts) {
+  ScopedObjectAccess soa(Thread::Current());
+  VariableSizedHandleScope vshs(soa.Self());
+  CreateGraph(&vshs);
+  AdjacencyListGraph blks(SetupFromAdjacencyList("entry",
+                                                 "exit",
+                                                 {{"entry", "left"},
+                                                  {"entry", "right"},
+                                                  {"left", "breturn"},
+                                                  {"right", "breturn"},
+                                                  {"breturn", "exit"}}));
+#define GET_BLOCK(name) HBasicBlock* name = blks.Get(#name)
+  GET_BLOCK(entry);
+  GET_BLOCK(exit);
+  GET_BLOCK(left);
+  GET_BLOCK(right);
+  GET_BLOCK(breturn);
+#undef GET_BLOCK
+
+  HInstruction* bool_value = MakeParam(DataType::Type::kBool);
+  HInstruction* bool_not = new (GetAllocator()) HBooleanNot(bool_value);
+  HIf* if_inst = new (GetAllocator()) HIf(bool_not);
+  if_inst->SetTrueCount(1000u);
+  if_inst->SetFalseCount(10u);
+  entry->AddInstruction(bool_not);
+  entry->AddInstruction(if_inst);
+
+  left->AddInstruction(new (GetAllocator()) HGoto());
+  right->AddInstruction(new (GetAllocator()) HGoto());
+  breturn->AddInstruction(new (GetAllocator()) HReturnVoid());
+
+  SetupExit(exit);
+
+  graph_->ClearDominanceInformation();
+  graph_->BuildDominatorTree();
+  InstructionSimplifier simp(graph_, /*codegen=*/nullptr);
+  simp.Run();
+
+  EXPECT_INS_EQ(if_inst->InputAt(0), bool_value);
+  EXPECT_EQ(if_inst->IfTrueSuccessor(), right);
+  EXPECT_EQ(if_inst->IfFalseSuccessor(), left);
+  EXPECT_EQ(if_inst->GetTrueCount(), 10u);
+  EXPECT_EQ(if_inst->GetFalseCount(), 1000u);
+}
+
 // // ENTRY
 // obj = new Obj();
 // // Make sure this graph isn't broken
@@ -16,6 +16,9 @@
 
 #include "linear_order.h"
 
+#include <algorithm>
+
+#include "base/arena_bit_vector.h"
 #include "base/scoped_arena_allocator.h"
 #include "base/scoped_arena_containers.h"
 
@@ -54,6 +57,44 @@ static void AddToListForLinearization(ScopedArenaVector<HBasicBlock*>* worklist,
   worklist->insert(insert_pos.base(), block);
 }
 
+// Helper method to find the blocks that are not expected to execute in the common case,
+// i.e. blocks outside of loops that unconditionally end up throwing. These are typically
+// the argument checks and error reporting paths of a method. All successors of a cold
+// block are either cold or the exit block.
+static void FindColdBlocks(const HGraph* graph, ArenaBitVector* cold_blocks) {
+  auto is_cold = [cold_blocks](HBasicBlock* block) {
+    return cold_blocks->IsBitSet(block->GetBlockId());
+  };
+  // Visit in post order, so that the forward successors of a block have been classified
+  // before the block itself. Back edges can be ignored since loop blocks are never cold.
+  for (HBasicBlock* block : graph->GetPostOrder()) {
+    if (block->IsInLoop() || block->IsEntryBlock() || block->IsExitBlock()) {
+      continue;
+    }
+    const ArenaVector<HBasicBlock*>& successors = block->GetSuccessors();
+    bool cold;
+    if (block->GetLastInstruction()->IsThrow()) {
+      // Throws inside a try block are followed by a TryBoundary which may lead to
+      // a catch handler that is not cold.
+      cold = std::all_of(successors.begin(), successors.end(), [&](HBasicBlock* successor) {
+        return successor->IsExitBlock() || is_cold(successor);
+      });
+    } else {
+      cold = !successors.empty() && std::all_of(successors.begin(), successors.end(), is_cold);
+    }
+    if (cold) {
+      cold_blocks->SetBit(block->GetBlockId());
+    }
+  }
+}
+
+// Helper method to check whether the branch profile of the HIf ending `block`, if any,
+// shows its true successor executing more often than its false successor.
+static bool IsTrueSuccessorMoreLikely(HBasicBlock* block) {
+  HInstruction* last = block->GetLastInstruction();
+  return last->IsIf() && last->AsIf()->GetTrueCount() > last->AsIf()->GetFalseCount();
+}
+
 // Helper method to validate linear order.
 static bool IsLinearOrderWellFormed(const HGraph* graph, ArrayRef<HBasicBlock*> linear_order) {
   for (HBasicBlock* header : graph->GetBlocks()) {
@@ -87,7 +128,9 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
   DCHECK_EQ(linear_order.size(), graph->GetReversePostOrder().size());
   // Create a reverse post ordering with the following properties:
   // - Blocks in a loop are consecutive,
-  // - Back-edge is the last block before loop exits.
+  // - Back-edge is the last block before loop exits,
+  // - Cold blocks (see FindColdBlocks) come after all other blocks, keeping the
+  //   hot code of the method contiguous.
   //
   // (1): Record the number of forward predecessors for each block. This is to
   //      ensure the resulting order is reverse post order. We could use the
@@ -104,27 +147,50 @@ void LinearizeGraphInternal(const HGraph* graph, ArrayRef<HBasicBlock*> linear_o
     }
     forward_predecessors[block->GetBlockId()] = number_of_forward_predecessors;
   }
+  ArenaBitVector cold_blocks(
+      &allocator, graph->GetBlocks().size(), /* expandable= */ false, kArenaAllocLinearOrder);
+  FindColdBlocks(graph, &cold_blocks);
   // (2): Following a worklist approach, first start with the entry block, and
   //      iterate over the successors. When all non-back edge predecessors of a
   //      successor block are visited, the successor block is added in the worklist
   //      following an order that satisfies the requirements to build our linear graph.
+  //      Ready cold blocks are set aside and only linearized once the worklist is
+  //      empty. This is safe because they are outside of loops and all of their
+  //      successors are either cold or the exit block. Successors added last are
+  //      linearized first, so the false successor of an HIf normally comes right
+  //      after it; when the branch profile shows the true successor is more likely,
+  //      it is added last instead so that the common path falls through.
   ScopedArenaVector<HBasicBlock*> worklist(allocator.Adapter(kArenaAllocLinearOrder));
+  ScopedArenaVector<HBasicBlock*> cold_worklist(allocator.Adapter(kArenaAllocLinearOrder));
   worklist.push_back(graph->GetEntryBlock());
   size_t num_added = 0u;
   do {
-    HBasicBlock* current = worklist.back();
-    worklist.pop_back();
+    HBasicBlock* current;
+    if (!worklist.empty()) {
+      current = worklist.back();
+      worklist.pop_back();
+    } else {
+      current = cold_worklist.back();
+      cold_worklist.pop_back();
+    }
     linear_order[num_added] = current;
     ++num_added;
-    for (HBasicBlock* successor : current->GetSuccessors()) {
+    const ArenaVector<HBasicBlock*>& successors = current->GetSuccessors();
+    bool reverse_successors = IsTrueSuccessorMoreLikely(current);
+    for (size_t i = 0, size = successors.size(); i != size; ++i) {
+      HBasicBlock* successor = successors[reverse_successors ? size - 1u - i : i];
       int block_id = successor->GetBlockId();
       size_t number_of_remaining_predecessors = forward_predecessors[block_id];
       if (number_of_remaining_predecessors == 1) {
-        AddToListForLinearization(&worklist, successor);
+        if (cold_blocks.IsBitSet(block_id)) {
+          cold_worklist.push_back(successor);
+        } else {
+          AddToListForLinearization(&worklist, successor);
+        }
       }
       forward_predecessors[block_id] = number_of_remaining_predecessors - 1;
     }
-  } while (!worklist.empty());
+  } while (!worklist.empty() || !cold_worklist.empty());
   DCHECK_EQ(num_added, linear_order.size());
 
   DCHECK(graph->HasIrreducibleLoops() || IsLinearOrderWellFormed(graph, linear_order));
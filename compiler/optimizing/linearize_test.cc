@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <fstream>
 
 #include "base/arena_allocator.h"
@@ -244,4 +245,93 @@ TEST_F(LinearizeTest, CFG7) {
   TestCode(data, blocks);
 }
 
+TEST_F(LinearizeTest, ThrowBlockPlacedLast) {
+  // Structure of this graph
+  //            Block0
+  //              |
+  //            Block1
+  //            /    \
+  //   (throw) BlockT  BlockR (return)
+  //            \    /
+  //             Exit
+  //
+  // The throwing block would naturally come first; it must be placed
+  // after the returning block.
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_NE, 3,
+    Instruction::THROW | 0 << 8,
+    Instruction::RETURN_VOID);
+
+  HGraph* graph = CreateCFG(data);
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(kRuntimeISA, "default");
+  std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options);
+  SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+  liveness.Analyze();
+
+  const ArenaVector<HBasicBlock*>& linear_order = graph->GetLinearOrder();
+  size_t return_position = linear_order.size();
+  size_t throw_position = linear_order.size();
+  for (size_t i = 0; i < linear_order.size(); ++i) {
+    HInstruction* last = linear_order[i]->GetLastInstruction();
+    if (last->IsReturnVoid()) {
+      return_position = i;
+    } else if (last->IsThrow()) {
+      throw_position = i;
+    }
+  }
+  ASSERT_LT(return_position, linear_order.size());
+  ASSERT_LT(throw_position, linear_order.size());
+  ASSERT_LT(return_position, throw_position);
+}
+
+TEST_F(LinearizeTest, LikelySuccessorPlacedAfterIf) {
+  // Structure of this graph
+  //            Block0
+  //              |
+  //            Block1
+  //            /    \
+  //   (return) BlockF  BlockT (return)
+  //            \    /
+  //             Exit
+  //
+  // The false successor of the If comes right after it, unless the branch
+  // profile shows that the true successor is more likely.
+  const std::vector<uint16_t> data = ONE_REGISTER_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_NE, 3,
+    Instruction::RETURN_VOID,
+    Instruction::RETURN_VOID);
+
+  std::unique_ptr<CompilerOptions> compiler_options =
+      CommonCompilerTest::CreateCompilerOptions(kRuntimeISA, "default");
+  auto check_block_after_if = [&](uint16_t true_count, uint16_t false_count, bool expect_true) {
+    HGraph* graph = CreateCFG(data);
+    HIf* if_instr = nullptr;
+    for (HBasicBlock* block : graph->GetReversePostOrder()) {
+      if (block->GetLastInstruction()->IsIf()) {
+        if_instr = block->GetLastInstruction()->AsIf();
+      }
+    }
+    ASSERT_NE(if_instr, nullptr);
+    if_instr->SetTrueCount(true_count);
+    if_instr->SetFalseCount(false_count);
+
+    std::unique_ptr<CodeGenerator> codegen = CodeGenerator::Create(graph, *compiler_options);
+    SsaLivenessAnalysis liveness(graph, codegen.get(), GetScopedAllocator());
+    liveness.Analyze();
+
+    const ArenaVector<HBasicBlock*>& linear_order = graph->GetLinearOrder();
+    auto it = std::find(linear_order.begin(), linear_order.end(), if_instr->GetBlock());
+    ASSERT_TRUE(it != linear_order.end());
+    ASSERT_TRUE(it + 1 != linear_order.end());
+    EXPECT_EQ(*(it + 1),
+              expect_true ? if_instr->IfTrueSuccessor() : if_instr->IfFalseSuccessor());
+  };
+  check_block_after_if(/* true_count= */ 0u, /* false_count= */ 0u, /* expect_true= */ false);
+  check_block_after_if(/* true_count= */ 10u, /* false_count= */ 1000u, /* expect_true= */ false);
+  check_block_after_if(/* true_count= */ 1000u, /* false_count= */ 10u, /* expect_true= */ true);
+}
+
 }  // namespace art
@@ -339,8 +339,10 @@ static bool IsSubConst2(HGraph* graph,
 // Detect reductions of the following forms,
 //   x = x_phi + ..
 //   x = x_phi - ..
+//   x = min(x_phi, ..)
+//   x = max(x_phi, ..)
 static bool HasReductionFormat(HInstruction* reduction, HInstruction* phi) {
-  if (reduction->IsAdd()) {
+  if (reduction->IsAdd() || reduction->IsMin() || reduction->IsMax()) {
     return (reduction->InputAt(0) == phi && reduction->InputAt(1) != phi) ||
            (reduction->InputAt(0) != phi && reduction->InputAt(1) == phi);
   } else if (reduction->IsSub()) {
@@ -356,6 +358,10 @@ static HVecReduce::ReductionKind GetReductionKind(HVecOperation* reduction) {
       reduction->IsVecSADAccumulate() ||
       reduction->IsVecDotProd()) {
     return HVecReduce::kSum;
+  } else if (reduction->IsVecMin()) {
+    return HVecReduce::kMin;
+  } else if (reduction->IsVecMax()) {
+    return HVecReduce::kMax;
   }
   LOG(FATAL) << "Unsupported SIMD reduction " << reduction->GetId();
   UNREACHABLE();
@@ -1049,7 +1055,9 @@ void HLoopOptimization::Vectorize(LoopNode* node,
       block, trip_count, MaxNumberPeeled(), vector_length_);
   uint32_t chunk = vector_length_ * unroll;
 
-  DCHECK(trip_count == 0 || (trip_count >= MaxNumberPeeled() + chunk));
+  DCHECK(trip_count == 0 ||
+         (trip_count >= MaxNumberPeeled() + chunk) ||
+         IsInPredicatedVectorizationMode());
 
   // A cleanup loop is needed, at least, for any unknown trip count or
   // for a known trip count with remainder iterations after vectorization.
@@ -1548,6 +1556,37 @@ bool HLoopOptimization::VectorizeUse(LoopNode* node,
         return true;
       }
     }
+  } else if (instruction->IsMin() || instruction->IsMax()) {
+    // Deal with vector restrictions.
+    HInstruction* opa = instruction->InputAt(0);
+    HInstruction* opb = instruction->InputAt(1);
+    HInstruction* r = opa;
+    HInstruction* s = opb;
+    bool is_unsigned = false;
+    if (!DataType::IsIntegralType(type)) {
+      return false;  // NaN and -0.0 semantics differ across SIMD targets
+    } else if (HasVectorRestrictions(restrictions, kNoMinMax)) {
+      return false;  // unsupported instruction
+    } else if (HasVectorRestrictions(restrictions, kNoHiBits) &&
+               !IsNarrowerOperands(opa, opb, type, &r, &s, &is_unsigned)) {
+      return false;  // reject, unless all operands are same-extension narrower
+    }
+    // Accept MIN/MAX(x, y) for vectorizable operands.
+    DCHECK(r != nullptr && s != nullptr);
+    if (generate_code && vector_mode_ != kVector) {  // de-idiom
+      r = opa;
+      s = opb;
+    }
+    if (VectorizeUse(node, r, generate_code, type, restrictions) &&
+        VectorizeUse(node, s, generate_code, type, restrictions)) {
+      if (generate_code) {
+        GenerateVecOp(instruction,
+                      vector_map_->Get(r),
+                      vector_map_->Get(s),
+                      HVecOperation::ToProperType(type, is_unsigned));
+      }
+      return true;
+    }
   } else if (instruction->IsAbs()) {
     // Deal with vector restrictions.
     HInstruction* opa = instruction->InputAt(0);
@@ -1663,7 +1702,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
             *restrictions |= kNoDiv;
             return TrySetVectorLength(type, 4);
           case DataType::Type::kInt64:
-            *restrictions |= kNoDiv | kNoMul;
+            *restrictions |= kNoDiv | kNoMul | kNoMinMax;
             return TrySetVectorLength(type, 2);
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
@@ -1712,7 +1751,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
             *restrictions |= kNoDiv | kNoSAD;
             return TrySetVectorLength(type, 4);
           case DataType::Type::kInt64:
-            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD;
+            *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoMinMax | kNoSAD;
             return TrySetVectorLength(type, 2);
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
@@ -2037,6 +2076,14 @@ void HLoopOptimization::GenerateVecOp(HInstruction* org,
       GENERATE_VEC(
         new (global_allocator_) HVecUShr(global_allocator_, opa, opb, type, vector_length_, dex_pc),
         new (global_allocator_) HUShr(org_type, opa, opb, dex_pc));
+    case HInstruction::kMin:
+      GENERATE_VEC(
+        new (global_allocator_) HVecMin(global_allocator_, opa, opb, type, vector_length_, dex_pc),
+        new (global_allocator_) HMin(org_type, opa, opb, dex_pc));
+    case HInstruction::kMax:
+      GENERATE_VEC(
+        new (global_allocator_) HVecMax(global_allocator_, opa, opb, type, vector_length_, dex_pc),
+        new (global_allocator_) HMax(org_type, opa, opb, dex_pc));
     case HInstruction::kAbs:
       DCHECK(opb == nullptr);
       GENERATE_VEC(
@@ -2339,6 +2386,12 @@ bool HLoopOptimization::IsVectorizationProfitable(int64_t trip_count) {
     return false;  // nothing found
   } else if (trip_count < 0) {
     return false;  // guard against non-taken/large
+  } else if (IsInPredicatedVectorizationMode()) {
+    // A single loop governed by the while-predicate handles every element, so
+    // even trip counts shorter than the vector length need neither peeling nor
+    // a cleanup loop.
+    DCHECK_EQ(max_peel, 0u);
+    return true;
   } else if ((0 < trip_count) && (trip_count < (vector_length_ + max_peel))) {
     return false;  // insufficient iterations
   }
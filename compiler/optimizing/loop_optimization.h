@@ -84,6 +84,7 @@ class HLoopOptimization : public HOptimization {
     kNoSAD           = 1 << 11,  // no sum of absolute differences (SAD)
     kNoWideSAD       = 1 << 12,  // no sum of absolute differences (SAD) with operand widening
     kNoDotProd       = 1 << 13,  // no dot product
+    kNoMinMax        = 1 << 14,  // no min/max
   };
 
   /*
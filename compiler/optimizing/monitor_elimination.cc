@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_elimination.h"
+
+#include "base/scoped_arena_allocator.h"
+#include "base/scoped_arena_containers.h"
+#include "base/stl_util.h"
+#include "escape.h"
+
+namespace art {
+
+// Returns the `monitor-exit` on `reference` closing the region opened by `enter`, or
+// null if there is none on a straight-line path from `enter` or if an instruction in
+// between needs an environment, i.e. may deoptimize, throw or suspend while the monitor
+// is held. The path may enter the try block of a `synchronized` statement.
+static HMonitorOperation* FindMatchingExit(HMonitorOperation* enter, HInstruction* reference) {
+  HInstruction* instruction = enter->GetNext();
+  while (instruction != nullptr) {
+    if (instruction->IsMonitorOperation()) {
+      HMonitorOperation* monitor = instruction->AsMonitorOperation();
+      return (!monitor->IsEnter() && monitor->InputAt(0) == reference) ? monitor : nullptr;
+    }
+    if (instruction->NeedsEnvironment()) {
+      return nullptr;
+    }
+    if (instruction->IsGoto() || instruction->IsTryBoundary()) {
+      HBasicBlock* successor = instruction->IsGoto()
+          ? instruction->GetBlock()->GetSingleSuccessor()
+          : instruction->AsTryBoundary()->GetNormalFlowSuccessor();
+      if (successor->GetPredecessors().size() != 1u) {
+        return nullptr;
+      }
+      instruction = successor->GetFirstInstruction();
+    } else {
+      instruction = instruction->GetNext();
+    }
+  }
+  return nullptr;
+}
+
+// Returns whether any instruction can throw into `catch_block`.
+static bool CanEnterCatchBlock(HBasicBlock* catch_block) {
+  DCHECK(catch_block->IsCatchBlock());
+  for (HBasicBlock* block : catch_block->GetGraph()->GetReversePostOrder()) {
+    if (block->IsTryBlock() &&
+        block->GetTryCatchInformation()->GetTryEntry().HasExceptionHandler(*catch_block)) {
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        if (it.Current()->CanThrow()) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+size_t MonitorElimination::TryRemoveMonitorOperations(HInstruction* reference) {
+  // Monitor operations are not escapes. Any other use that `CalculateEscape()`
+  // reports could make the reference visible to another thread.
+  if (!DoesNotEscape(reference, /*no_escape_fn=*/ nullptr)) {
+    return 0u;
+  }
+
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HMonitorOperation*> monitors(allocator.Adapter(kArenaAllocOptimization));
+  for (const HUseListNode<HInstruction*>& use : reference->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (user->IsMonitorOperation() && user->AsMonitorOperation()->IsEnter()) {
+      HMonitorOperation* exit = FindMatchingExit(user->AsMonitorOperation(), reference);
+      if (exit == nullptr) {
+        return 0u;
+      }
+      monitors.push_back(user->AsMonitorOperation());
+      monitors.push_back(exit);
+    }
+  }
+  if (monitors.empty()) {
+    return 0u;
+  }
+  // Every other exit must be unreachable, or it would be left unbalanced.
+  for (const HUseListNode<HInstruction*>& use : reference->GetUses()) {
+    HInstruction* user = use.GetUser();
+    if (user->IsMonitorOperation() && !ContainsElement(monitors, user)) {
+      DCHECK(!user->AsMonitorOperation()->IsEnter());
+      if (!user->GetBlock()->IsCatchBlock() || CanEnterCatchBlock(user->GetBlock())) {
+        return 0u;
+      }
+      monitors.push_back(user->AsMonitorOperation());
+    }
+  }
+
+  for (HMonitorOperation* monitor : monitors) {
+    monitor->GetBlock()->RemoveInstruction(monitor);
+  }
+  MaybeRecordStat(stats_, MethodCompilationStat::kRemovedMonitorOperation, monitors.size());
+  return monitors.size();
+}
+
+bool MonitorElimination::Run() {
+  if (!graph_->HasMonitorOperations()) {
+    return false;
+  }
+  // The debugger can query the monitors held by a frame.
+  if (graph_->IsDebuggable()) {
+    return false;
+  }
+
+  // Collect the locked allocations first, as removing monitor operations
+  // would invalidate the instruction iterators.
+  ScopedArenaAllocator allocator(graph_->GetArenaStack());
+  ScopedArenaVector<HInstruction*> candidates(allocator.Adapter(kArenaAllocOptimization));
+  size_t number_of_monitor_operations = 0;
+  for (HBasicBlock* block : graph_->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (!instruction->IsMonitorOperation()) {
+        continue;
+      }
+      ++number_of_monitor_operations;
+      HInstruction* reference = instruction->InputAt(0);
+      if (instruction->AsMonitorOperation()->IsEnter() &&
+          (reference->IsNewInstance() || reference->IsNewArray()) &&
+          !ContainsElement(candidates, reference)) {
+        candidates.push_back(reference);
+      }
+    }
+  }
+
+  bool removed = false;
+  for (HInstruction* reference : candidates) {
+    size_t number_of_removed = TryRemoveMonitorOperations(reference);
+    DCHECK_GE(number_of_monitor_operations, number_of_removed);
+    number_of_monitor_operations -= number_of_removed;
+    removed = removed || (number_of_removed != 0u);
+  }
+
+  if (number_of_monitor_operations == 0u) {
+    // Stack maps no longer need the dex register maps for lock owner analysis.
+    graph_->SetHasMonitorOperations(false);
+  }
+  return removed;
+}
+
+}  // namespace art
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_MONITOR_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_MONITOR_ELIMINATION_H_
+
+#include "optimization.h"
+
+namespace art {
+
+/*
+ * Monitor elimination.
+ *
+ * Removes `monitor-enter`/`monitor-exit` pairs on objects allocated in the method that
+ * do not escape it. No other thread can ever lock such an object, so the monitor
+ * operations have no observable effect.
+ *
+ * The interpreter re-executes the `monitor-exit` of a region it resumes in after a
+ * deoptimization, and stack walks report the monitors held at a suspend point. To keep
+ * both consistent with the removed `monitor-enter`, a pair is only removed if the exit
+ * follows the enter on a straight-line path and no instruction between them needs an
+ * environment. Nothing in the region can then throw, so the `monitor-exit` in the
+ * catch-all handler of a `synchronized` block is dead and can be removed as well.
+ *
+ * Removing the monitor operations also lets load-store elimination, which bails out on
+ * graphs with monitor operations, scalar replace the object.
+ */
+class MonitorElimination : public HOptimization {
+ public:
+  MonitorElimination(HGraph* graph,
+                     OptimizingCompilerStats* stats,
+                     const char* name = kMonitorEliminationPassName)
+      : HOptimization(graph, name, stats) {}
+
+  bool Run() override;
+
+  static constexpr const char* kMonitorEliminationPassName = "monitor_elimination";
+
+ private:
+  // Returns the number of monitor operations removed on `reference`.
+  size_t TryRemoveMonitorOperations(HInstruction* reference);
+
+  DISALLOW_COPY_AND_ASSIGN(MonitorElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_MONITOR_ELIMINATION_H_
@@ -80,6 +80,7 @@ enum class OptimizationPass {
   kInvariantCodeMotion,
   kLoadStoreElimination,
   kLoopOptimization,
+  kMonitorElimination,
   kScheduling,
   kSelectGenerator,
   kSideEffectsAnalysis,
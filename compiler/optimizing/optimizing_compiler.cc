@@ -55,6 +55,7 @@
 #include "nodes.h"
 #include "oat_quick_method_header.h"
 #include "prepare_for_register_allocation.h"
+#include "profile/profile_compilation_info.h"
 #include "reference_type_propagation.h"
 #include "register_allocator_linear_scan.h"
 #include "select_generator.h"
@@ -563,6 +564,9 @@ bool OptimizingCompiler::RunArchOptimizations(HGraph* graph,
         OptDef(OptimizationPass::kInstructionSimplifierX86_64),
         OptDef(OptimizationPass::kSideEffectsAnalysis),
         OptDef(OptimizationPass::kGlobalValueNumbering, "GVN$after_arch"),
+        // Schedule before memory operand generation, which requires some
+        // instructions to stay next to their users.
+        OptDef(OptimizationPass::kScheduling),
         OptDef(OptimizationPass::kX86MemoryOperandGeneration)
       };
       return RunOptimizations(graph,
@@ -601,6 +605,14 @@ static void AllocateRegisters(HGraph* graph,
     std::unique_ptr<RegisterAllocator> register_allocator =
         RegisterAllocator::Create(&local_allocator, codegen, liveness, strategy);
     register_allocator->AllocateRegisters();
+    bool is_graph_color = (strategy == RegisterAllocator::kRegisterAllocatorGraphColor);
+    MaybeRecordStat(stats,
+                    is_graph_color ? MethodCompilationStat::kRegisterAllocatorGraphColor
+                                   : MethodCompilationStat::kRegisterAllocatorLinearScan);
+    MaybeRecordStat(stats,
+                    is_graph_color ? MethodCompilationStat::kSpillSlotsGraphColor
+                                   : MethodCompilationStat::kSpillSlotsLinearScan,
+                    register_allocator->GetNumberOfSpillSlots());
   }
 }
 
@@ -652,6 +664,9 @@ void OptimizingCompiler::RunOptimizations(HGraph* graph,
     OptDef(OptimizationPass::kDeadCodeElimination,
            "dead_code_elimination$after_inlining",
            OptimizationPass::kInliner),
+    // Remove locks on objects that inlining proved thread-local, before the
+    // passes that treat monitor operations as barriers.
+    OptDef(OptimizationPass::kMonitorElimination),
     // GVN.
     OptDef(OptimizationPass::kSideEffectsAnalysis,
            "side_effects$before_gvn"),
@@ -893,6 +908,17 @@ CodeGenerator* OptimizingCompiler::TryCompile(ArenaAllocator* allocator,
 
   RegisterAllocator::Strategy regalloc_strategy =
     compiler_options.GetRegisterAllocationStrategy();
+  if (regalloc_strategy == RegisterAllocator::kRegisterAllocatorAdaptive) {
+    bool is_hot_method = false;
+    if (compilation_kind == CompilationKind::kOsr) {
+      is_hot_method = true;
+    } else if (compilation_kind == CompilationKind::kOptimized &&
+               compiler_options.GetProfileCompilationInfo() != nullptr) {
+      is_hot_method = compiler_options.GetProfileCompilationInfo()->GetMethodHotness(
+          MethodReference(&dex_file, method_idx)).IsHot();
+    }
+    regalloc_strategy = RegisterAllocator::SelectStrategy(graph, is_hot_method);
+  }
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
@@ -984,10 +1010,15 @@ CodeGenerator* OptimizingCompiler::TryCompileIntrinsic(
 
   RunArchOptimizations(graph, codegen.get(), dex_compilation_unit, &pass_observer);
 
+  RegisterAllocator::Strategy regalloc_strategy =
+    compiler_options.GetRegisterAllocationStrategy();
+  if (regalloc_strategy == RegisterAllocator::kRegisterAllocatorAdaptive) {
+    regalloc_strategy = RegisterAllocator::SelectStrategy(graph, /* is_hot_method= */ false);
+  }
   AllocateRegisters(graph,
                     codegen.get(),
                     &pass_observer,
-                    compiler_options.GetRegisterAllocationStrategy(),
+                    regalloc_strategy,
                     compilation_stats_.get());
   if (!codegen->IsLeafMethod()) {
     VLOG(compiler) << "Intrinsic method is not leaf: " << method->GetIntrinsic()
@@ -117,6 +117,11 @@ enum class MethodCompilationStat {
   kPredicatedLoadAdded,
   kPredicatedStoreAdded,
   kDevirtualized,
+  kRegisterAllocatorLinearScan,
+  kRegisterAllocatorGraphColor,
+  kSpillSlotsLinearScan,
+  kSpillSlotsGraphColor,
+  kRemovedMonitorOperation,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
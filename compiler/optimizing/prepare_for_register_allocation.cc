@@ -18,6 +18,7 @@
 
 #include "dex/dex_file_types.h"
 #include "driver/compiler_options.h"
+#include "jit/profiling_info.h"
 #include "jni/jni_internal.h"
 #include "optimizing_compiler_stats.h"
 #include "well_known_classes.h"
@@ -180,7 +181,16 @@ bool PrepareForRegisterAllocation::CanEmitConditionAt(HCondition* condition,
     return false;
   }
 
-  if (user->IsIf() || user->IsDeoptimize()) {
+  if (user->IsIf()) {
+    // Baseline JIT code records which way each branch went by indexing the
+    // branch cache with the value of the condition, so it needs to be materialized
+    // on the instruction sets that record branch profiles.
+    return !(GetGraph()->IsCompilingBaseline() &&
+             compiler_options_.IsJitCompiler() &&
+             BranchCache::IsRecordedBy(compiler_options_.GetInstructionSet()));
+  }
+
+  if (user->IsDeoptimize()) {
     return true;
   }
 
@@ -53,6 +53,15 @@ std::unique_ptr<RegisterAllocator> RegisterAllocator::Create(ScopedArenaAllocato
   }
 }
 
+RegisterAllocator::Strategy RegisterAllocator::SelectStrategy(const HGraph* graph,
+                                                              bool is_hot_method) {
+  if (is_hot_method &&
+      static_cast<size_t>(graph->GetCurrentInstructionId()) <= kMaxInstructionsForGraphColor) {
+    return kRegisterAllocatorGraphColor;
+  }
+  return kRegisterAllocatorLinearScan;
+}
+
 RegisterAllocator::~RegisterAllocator() {
   if (kIsDebugBuild) {
     // Poison live interval pointers with "Error: BAD 71ve1nt3rval."
@@ -40,16 +40,26 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
  public:
   enum Strategy {
     kRegisterAllocatorLinearScan,
-    kRegisterAllocatorGraphColor
+    kRegisterAllocatorGraphColor,
+    // Pick one of the above per method, see `SelectStrategy()`.
+    kRegisterAllocatorAdaptive
   };
 
   static constexpr Strategy kRegisterAllocatorDefault = kRegisterAllocatorLinearScan;
 
+  // Methods with more instructions than this are always allocated with linear scan
+  // by the adaptive strategy, to bound the cost of building interference graphs.
+  static constexpr size_t kMaxInstructionsForGraphColor = 1000;
+
   static std::unique_ptr<RegisterAllocator> Create(ScopedArenaAllocator* allocator,
                                                    CodeGenerator* codegen,
                                                    const SsaLivenessAnalysis& analysis,
                                                    Strategy strategy = kRegisterAllocatorDefault);
 
+  // Resolve the adaptive strategy for `graph`. Graph coloring produces fewer spills
+  // but takes longer to run, so it is only chosen for hot methods of moderate size.
+  static Strategy SelectStrategy(const HGraph* graph, bool is_hot_method);
+
   virtual ~RegisterAllocator();
 
   // Main entry point for the register allocator. Given the liveness analysis,
@@ -60,6 +70,10 @@ class RegisterAllocator : public DeletableArenaObject<kArenaAllocRegisterAllocat
   // intervals that intersect each other. Returns false if it failed.
   virtual bool Validate(bool log_fatal_on_failure) = 0;
 
+  // Returns the number of stack slots used for spilling, including catch phi slots.
+  // Only valid after `AllocateRegisters()`.
+  virtual size_t GetNumberOfSpillSlots() const = 0;
+
   // Verifies that live intervals do not conflict. Used by unit testing.
   static bool ValidateIntervals(ArrayRef<LiveInterval* const> intervals,
                                 size_t number_of_spill_slots,
@@ -55,7 +55,7 @@ class RegisterAllocatorLinearScan : public RegisterAllocator {
     return ValidateInternal(log_fatal_on_failure);
   }
 
-  size_t GetNumberOfSpillSlots() const {
+  size_t GetNumberOfSpillSlots() const override {
     return int_spill_slots_.size()
         + long_spill_slots_.size()
         + float_spill_slots_.size()
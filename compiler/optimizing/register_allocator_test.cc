@@ -58,6 +58,7 @@ class RegisterAllocatorTest : public OptimizingUnitTest {
   void Loop2(Strategy strategy);
   void Loop3(Strategy strategy);
   void DeadPhi(Strategy strategy);
+  void NoSpillSlots(Strategy strategy);
   HGraph* BuildIfElseWithPhi(HPhi** phi, HInstruction** input1, HInstruction** input2);
   void PhiHint(Strategy strategy);
   HGraph* BuildFieldReturn(HInstruction** field, HInstruction** ret);
@@ -239,6 +240,52 @@ void RegisterAllocatorTest::Loop1(Strategy strategy) {
 
 TEST_ALL_STRATEGIES(Loop1);
 
+void RegisterAllocatorTest::NoSpillSlots(Strategy strategy) {
+  // Same snippet as Loop1, which needs fewer registers than available.
+  const std::vector<uint16_t> data = TWO_REGISTERS_CODE_ITEM(
+    Instruction::CONST_4 | 0 | 0,
+    Instruction::IF_EQ, 4,
+    Instruction::CONST_4 | 4 << 12 | 0,
+    Instruction::GOTO | 0xFD00,
+    Instruction::CONST_4 | 5 << 12 | 1 << 8,
+    Instruction::RETURN | 1 << 8);
+
+  HGraph* graph = CreateCFG(data);
+  x86::CodeGeneratorX86 codegen(graph, *compiler_options_);
+  SsaLivenessAnalysis liveness(graph, &codegen, GetScopedAllocator());
+  liveness.Analyze();
+  std::unique_ptr<RegisterAllocator> register_allocator =
+      RegisterAllocator::Create(GetScopedAllocator(), &codegen, liveness, strategy);
+  register_allocator->AllocateRegisters();
+  ASSERT_TRUE(register_allocator->Validate(false));
+  ASSERT_EQ(register_allocator->GetNumberOfSpillSlots(), 0u);
+}
+
+TEST_ALL_STRATEGIES(NoSpillSlots);
+
+TEST_F(RegisterAllocatorTest, SelectStrategy) {
+  HGraph* graph = CreateGraph();
+  // Methods that are not hot always use linear scan.
+  ASSERT_EQ(RegisterAllocator::SelectStrategy(graph, /* is_hot_method= */ false),
+            Strategy::kRegisterAllocatorLinearScan);
+  // Small hot methods use graph coloring.
+  ASSERT_EQ(RegisterAllocator::SelectStrategy(graph, /* is_hot_method= */ true),
+            Strategy::kRegisterAllocatorGraphColor);
+
+  // Large hot methods fall back to linear scan to bound compile time.
+  HBasicBlock* entry = new (GetAllocator()) HBasicBlock(graph);
+  graph->AddBlock(entry);
+  graph->SetEntryBlock(entry);
+  HInstruction* parameter = new (GetAllocator()) HParameterValue(
+      graph->GetDexFile(), dex::TypeIndex(0), 0, DataType::Type::kInt32);
+  entry->AddInstruction(parameter);
+  for (size_t i = 0; i < RegisterAllocator::kMaxInstructionsForGraphColor; ++i) {
+    entry->AddInstruction(new (GetAllocator()) HNot(DataType::Type::kInt32, parameter));
+  }
+  ASSERT_EQ(RegisterAllocator::SelectStrategy(graph, /* is_hot_method= */ true),
+            Strategy::kRegisterAllocatorLinearScan);
+}
+
 void RegisterAllocatorTest::Loop2(Strategy strategy) {
   /*
    * Test the following snippet:
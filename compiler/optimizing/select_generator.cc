@@ -23,12 +23,28 @@ namespace art {
 
 static constexpr size_t kMaxInstructionsInBranch = 1u;
 
+// Minimum number of recorded executions for a branch profile to be trusted, and the
+// ratio above which a branch is considered biased enough to be well predicted.
+static constexpr uint32_t kMinBranchProfileCount = 100u;
+static constexpr uint32_t kBiasedBranchRatio = 100u;
+
 HSelectGenerator::HSelectGenerator(HGraph* graph,
                                    OptimizingCompilerStats* stats,
                                    const char* name)
     : HOptimization(graph, name, stats) {
 }
 
+// Returns true if the branch profile of `if_instruction` shows it almost always going
+// the same way. Such a branch is well predicted, so speculatively executing the
+// instructions of both sides for a select is not worth it.
+static bool IsBiasedBranch(HIf* if_instruction) {
+  uint32_t true_count = if_instruction->GetTrueCount();
+  uint32_t false_count = if_instruction->GetFalseCount();
+  uint32_t total_count = true_count + false_count;
+  return total_count >= kMinBranchProfileCount &&
+         std::min(true_count, false_count) * kBiasedBranchRatio < total_count;
+}
+
 // Returns true if `block` has only one predecessor, ends with a Goto
 // or a Return and contains at most `kMaxInstructionsInBranch` other
 // movable instruction with no side-effects.
@@ -113,6 +129,11 @@ bool HSelectGenerator::Run() {
         !BlocksMergeTogether(true_block, false_block)) {
       continue;
     }
+    if (IsBiasedBranch(if_instruction) &&
+        !((true_block->IsSingleGoto() || true_block->IsSingleReturn()) &&
+          (false_block->IsSingleGoto() || false_block->IsSingleReturn()))) {
+      continue;
+    }
     HBasicBlock* merge_block = true_block->GetSingleSuccessor();
 
     // If the branches are not empty, move instructions in front of the If.
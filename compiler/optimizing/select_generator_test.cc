@@ -34,7 +34,7 @@ class SelectGeneratorTest : public OptimizingUnitTest {
                                                       DataType::Type::kInt32));
   }
 
-  void ConstructBasicGraphForSelect(HInstruction* instr) {
+  HIf* ConstructBasicGraphForSelect(HInstruction* instr) {
     HBasicBlock* if_block = AddNewBlock();
     HBasicBlock* then_block = AddNewBlock();
     HBasicBlock* else_block = AddNewBlock();
@@ -53,7 +53,8 @@ class SelectGeneratorTest : public OptimizingUnitTest {
     entry_block_->AddInstruction(bool_param);
     HIntConstant* const1 =  graph_->GetIntConstant(1);
 
-    if_block->AddInstruction(new (GetAllocator()) HIf(bool_param));
+    HIf* if_instr = new (GetAllocator()) HIf(bool_param);
+    if_block->AddInstruction(if_instr);
 
     then_block->AddInstruction(instr);
     then_block->AddInstruction(new (GetAllocator()) HGoto());
@@ -64,6 +65,7 @@ class SelectGeneratorTest : public OptimizingUnitTest {
     return_block_->AddPhi(phi);
     phi->AddInput(instr);
     phi->AddInput(const1);
+    return if_instr;
   }
 
   bool CheckGraphAndTrySelectGenerator() {
@@ -99,4 +101,40 @@ TEST_F(SelectGeneratorTest, testAdd) {
   EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
 }
 
+// Test that SelectGenerator keeps a branch that the profile shows is strongly biased
+// when that would speculatively execute the HAdd.
+TEST_F(SelectGeneratorTest, testBiasedBranch) {
+  InitGraphAndParameters();
+  HAdd* instr = new (GetAllocator()) HAdd(DataType::Type::kInt32,
+                                          parameters_[0],
+                                          parameters_[0], 0);
+  HIf* if_instr = ConstructBasicGraphForSelect(instr);
+  if_instr->SetTrueCount(1000u);
+  if_instr->SetFalseCount(2u);
+  EXPECT_FALSE(CheckGraphAndTrySelectGenerator());
+}
+
+// Test that SelectGenerator still succeeds with HAdd for a branch that is not biased.
+TEST_F(SelectGeneratorTest, testUnbiasedBranch) {
+  InitGraphAndParameters();
+  HAdd* instr = new (GetAllocator()) HAdd(DataType::Type::kInt32,
+                                          parameters_[0],
+                                          parameters_[0], 0);
+  HIf* if_instr = ConstructBasicGraphForSelect(instr);
+  if_instr->SetTrueCount(600u);
+  if_instr->SetFalseCount(400u);
+  EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
+}
+
+// Test that SelectGenerator ignores branch profiles with too few executions.
+TEST_F(SelectGeneratorTest, testBiasedBranchFewExecutions) {
+  InitGraphAndParameters();
+  HAdd* instr = new (GetAllocator()) HAdd(DataType::Type::kInt32,
+                                          parameters_[0],
+                                          parameters_[0], 0);
+  HIf* if_instr = ConstructBasicGraphForSelect(instr);
+  if_instr->SetTrueCount(50u);
+  EXPECT_TRUE(CheckGraphAndTrySelectGenerator());
+}
+
 }  // namespace art
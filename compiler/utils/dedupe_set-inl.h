@@ -74,6 +74,7 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
     auto it = keys_.find(hashed_in_key);
     if (it != keys_.end()) {
       DCHECK(it->Key() != nullptr);
+      it->AddUse();
       return it->Key();
     }
     const StoreKey* store_key = alloc_.Copy(in_key);
@@ -81,6 +82,18 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
     return store_key;
   }
 
+  void Remove(Thread* self, size_t hash, const InKey& in_key) REQUIRES(!lock_) {
+    MutexLock lock(self, lock_);
+    HashedKey<InKey> hashed_in_key(hash, &in_key);
+    auto it = keys_.find(hashed_in_key);
+    DCHECK(it != keys_.end());
+    if (it->RemoveUse()) {
+      const StoreKey* store_key = it->Key();
+      keys_.erase(it);
+      alloc_.Destroy(store_key);
+    }
+  }
+
   void UpdateStats(Thread* self, Stats* global_stats) REQUIRES(!lock_) {
     // HashSet<> doesn't keep entries ordered by hash, so we actually allocate memory
     // for bookkeeping while collecting the stats.
@@ -113,8 +126,8 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
   template <typename T>
   class HashedKey {
    public:
-    HashedKey() : hash_(0u), key_(nullptr) { }
-    HashedKey(size_t hash, const T* key) : hash_(hash), key_(key) { }
+    HashedKey() : hash_(0u), key_(nullptr), uses_(0u) { }
+    HashedKey(size_t hash, const T* key) : hash_(hash), key_(key), uses_(1u) { }
 
     size_t Hash() const {
       return hash_;
@@ -132,9 +145,23 @@ class DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Shard {
       key_ = nullptr;
     }
 
+    void AddUse() const {
+      ++uses_;
+    }
+
+    // Returns true if this was the last use.
+    bool RemoveUse() const {
+      DCHECK_NE(uses_, 0u);
+      --uses_;
+      return uses_ == 0u;
+    }
+
    private:
     size_t hash_;
     const T* key_;
+    // The number of Add calls not yet matched by a Remove. The set stays keyed by hash and
+    // contents, so the count can be updated in place.
+    mutable size_t uses_;
   };
 
   class ShardEmptyFn {
@@ -202,6 +229,20 @@ const StoreKey* DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::A
   return shards_[shard_bin]->Add(self, shard_hash, key);
 }
 
+template <typename InKey,
+          typename StoreKey,
+          typename Alloc,
+          typename HashType,
+          typename HashFunc,
+          HashType kShard>
+void DedupeSet<InKey, StoreKey, Alloc, HashType, HashFunc, kShard>::Remove(
+    Thread* self, const InKey& key) {
+  HashType raw_hash = HashFunc()(key);
+  HashType shard_hash = raw_hash / kShard;
+  HashType shard_bin = raw_hash % kShard;
+  shards_[shard_bin]->Remove(self, shard_hash, key);
+}
+
 template <typename InKey,
           typename StoreKey,
           typename Alloc,
@@ -29,7 +29,8 @@ class Thread;
 
 // A set of Keys that support a HashFunc returning HashType. Used to find duplicates of Key in the
 // Add method. The data-structure is thread-safe through the use of internal locks, it also
-// supports the lock being sharded.
+// supports the lock being sharded. Stored keys are reference counted, a stored key is destroyed
+// when each Add has been matched by a Remove, or with the set.
 template <typename InKey,
           typename StoreKey,
           typename Alloc,
@@ -41,6 +42,10 @@ class DedupeSet {
   // Add a new key to the dedupe set if not present. Return the equivalent deduplicated stored key.
   const StoreKey* Add(Thread* self, const InKey& key);
 
+  // Remove a use of the key previously added with Add. Destroy the stored key if it was its last
+  // use.
+  void Remove(Thread* self, const InKey& key);
+
   DedupeSet(const char* set_name, const Alloc& alloc);
 
   ~DedupeSet();
@@ -88,4 +88,57 @@ TEST(DedupeSetTest, Test) {
   }
 }
 
+class DedupeSetTestCountingAlloc {
+ public:
+  explicit DedupeSetTestCountingAlloc(size_t* live_keys) : live_keys_(live_keys) { }
+
+  const std::vector<uint8_t>* Copy(const ArrayRef<const uint8_t>& src) {
+    ++*live_keys_;
+    return new std::vector<uint8_t>(src.begin(), src.end());
+  }
+
+  void Destroy(const std::vector<uint8_t>* key) {
+    --*live_keys_;
+    delete key;
+  }
+
+ private:
+  size_t* live_keys_;
+};
+
+TEST(DedupeSetTest, Remove) {
+  Thread* self = Thread::Current();
+  size_t live_keys = 0u;
+  DedupeSetTestCountingAlloc alloc(&live_keys);
+  DedupeSet<ArrayRef<const uint8_t>,
+            std::vector<uint8_t>,
+            DedupeSetTestCountingAlloc,
+            size_t,
+            DedupeSetTestHashFunc> deduplicator("test", alloc);
+  uint8_t raw_test1[] = { 10u, 20u, 30u, 45u };
+  uint8_t raw_test2[] = { 10u, 22u, 30u, 47u };
+  ArrayRef<const uint8_t> test1(raw_test1);
+  ArrayRef<const uint8_t> test2(raw_test2);
+
+  const std::vector<uint8_t>* array1 = deduplicator.Add(self, test1);
+  ASSERT_EQ(array1, deduplicator.Add(self, test1));
+  const std::vector<uint8_t>* array2 = deduplicator.Add(self, test2);
+  ASSERT_NE(array2, array1);
+  ASSERT_EQ(2u, live_keys);
+
+  // The first key is kept until all its uses are removed.
+  deduplicator.Remove(self, test1);
+  ASSERT_EQ(2u, live_keys);
+  deduplicator.Remove(self, test1);
+  ASSERT_EQ(1u, live_keys);
+  deduplicator.Remove(self, test2);
+  ASSERT_EQ(0u, live_keys);
+
+  // Removed keys can be added again.
+  const std::vector<uint8_t>* array3 = deduplicator.Add(self, test1);
+  ASSERT_NE(array3, nullptr);
+  ASSERT_TRUE(std::equal(test1.begin(), test1.end(), array3->begin()));
+  ASSERT_EQ(1u, live_keys);
+}
+
 }  // namespace art
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compile_server.h"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "android-base/cmsg.h"
+#include "android-base/file.h"
+#include "android-base/stringprintf.h"
+#include "android-base/strings.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+using android::base::unique_fd;
+
+namespace {
+
+static constexpr uint32_t kRequestMagic = 0x64326f73;  // "d2os"
+
+// Upper bound for the size of the arguments of a request.
+static constexpr uint32_t kMaxRequestPayloadSize = 1u * 1024u * 1024u;
+
+struct RequestHeader {
+  uint32_t magic;
+  uint32_t num_args;
+  uint32_t payload_size;
+};
+
+bool MakeSocketAddress(const std::string& socket_path,
+                       /*out*/ sockaddr_un* addr,
+                       /*out*/ std::string* error_msg) {
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr->sun_path)) {
+    *error_msg = StringPrintf("Socket path too long: %s", socket_path.c_str());
+    return false;
+  }
+  strncpy(addr->sun_path, socket_path.c_str(), sizeof(addr->sun_path) - 1u);
+  return true;
+}
+
+}  // namespace
+
+bool SendCompileRequest(const std::string& socket_path,
+                        const std::vector<std::string>& args,
+                        const std::vector<int>& fds,
+                        /*out*/ int* return_code,
+                        /*out*/ std::string* error_msg) {
+  if (fds.size() > kCompileServerMaxRequestFds) {
+    *error_msg = StringPrintf("Too many file descriptors: %zu", fds.size());
+    return false;
+  }
+  sockaddr_un addr;
+  if (!MakeSocketAddress(socket_path, &addr, error_msg)) {
+    return false;
+  }
+  unique_fd sock(socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+  if (sock.get() == -1) {
+    *error_msg = StringPrintf("Failed to create socket: %s", strerror(errno));
+    return false;
+  }
+  if (TEMP_FAILURE_RETRY(connect(sock.get(), reinterpret_cast<sockaddr*>(&addr), sizeof(addr)))
+          != 0) {
+    *error_msg = StringPrintf("Failed to connect to %s: %s", socket_path.c_str(), strerror(errno));
+    return false;
+  }
+
+  std::string payload;
+  for (const std::string& arg : args) {
+    payload.append(arg);
+    payload.push_back('\0');
+  }
+  if (payload.size() > kMaxRequestPayloadSize) {
+    *error_msg = StringPrintf("Request too large: %zu bytes", payload.size());
+    return false;
+  }
+  RequestHeader header = {kRequestMagic,
+                          static_cast<uint32_t>(args.size()),
+                          static_cast<uint32_t>(payload.size())};
+  if (android::base::SendFileDescriptorVector(sock, &header, sizeof(header), fds) !=
+          static_cast<ssize_t>(sizeof(header)) ||
+      !android::base::WriteFully(sock, payload.data(), payload.size())) {
+    *error_msg = StringPrintf("Failed to send request: %s", strerror(errno));
+    return false;
+  }
+
+  int32_t response;
+  if (!android::base::ReadFully(sock, &response, sizeof(response))) {
+    *error_msg = StringPrintf("Failed to read response: %s", strerror(errno));
+    return false;
+  }
+  *return_code = response;
+  return true;
+}
+
+unique_fd CreateCompileServerSocket(const std::string& socket_path,
+                                    /*out*/ std::string* error_msg) {
+  sockaddr_un addr;
+  if (!MakeSocketAddress(socket_path, &addr, error_msg)) {
+    return unique_fd();
+  }
+  unique_fd sock(socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0));
+  if (sock.get() == -1) {
+    *error_msg = StringPrintf("Failed to create socket: %s", strerror(errno));
+    return unique_fd();
+  }
+  // Remove a socket left behind by a previous server.
+  unlink(socket_path.c_str());
+  // Restrict the socket to the user of the server before listening, so that no other
+  // user can connect and have code compiled with the server's permissions.
+  if (bind(sock.get(), reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+      chmod(socket_path.c_str(), S_IRUSR | S_IWUSR) != 0 ||
+      listen(sock.get(), SOMAXCONN) != 0) {
+    *error_msg = StringPrintf("Failed to listen on %s: %s", socket_path.c_str(), strerror(errno));
+    return unique_fd();
+  }
+  return sock;
+}
+
+bool ReceiveCompileRequest(int connection,
+                           /*out*/ std::vector<std::string>* args,
+                           /*out*/ std::vector<unique_fd>* fds,
+                           /*out*/ std::string* error_msg) {
+  RequestHeader header;
+  ssize_t received = android::base::ReceiveFileDescriptorVector(
+      connection, &header, sizeof(header), kCompileServerMaxRequestFds, fds);
+  if (received <= 0) {
+    *error_msg = StringPrintf("Failed to receive request: %s", strerror(errno));
+    return false;
+  }
+  // The file descriptors come with the first bytes, the rest of the header may be late.
+  if (static_cast<size_t>(received) < sizeof(header) &&
+      !android::base::ReadFully(connection,
+                                reinterpret_cast<uint8_t*>(&header) + received,
+                                sizeof(header) - received)) {
+    *error_msg = StringPrintf("Failed to receive request header: %s", strerror(errno));
+    return false;
+  }
+  if (header.magic != kRequestMagic || header.payload_size > kMaxRequestPayloadSize) {
+    *error_msg = "Invalid request header";
+    return false;
+  }
+  std::string payload(header.payload_size, '\0');
+  if (!android::base::ReadFully(connection, payload.data(), payload.size())) {
+    *error_msg = StringPrintf("Failed to receive request arguments: %s", strerror(errno));
+    return false;
+  }
+
+  args->clear();
+  for (size_t pos = 0u; pos != payload.size(); ) {
+    size_t end = payload.find('\0', pos);
+    if (end == std::string::npos) {
+      *error_msg = "Unterminated request argument";
+      return false;
+    }
+    std::string arg = payload.substr(pos, end - pos);
+    for (size_t i = 0; i != fds->size(); ++i) {
+      arg = android::base::StringReplace(arg,
+                                         StringPrintf("{fd%zu}", i),
+                                         std::to_string((*fds)[i].get()),
+                                         /*all=*/ true);
+    }
+    args->push_back(std::move(arg));
+    pos = end + 1u;
+  }
+  if (args->size() != header.num_args) {
+    *error_msg = StringPrintf("Expected %u arguments, got %zu", header.num_args, args->size());
+    return false;
+  }
+  return true;
+}
+
+bool SendCompileResponse(int connection, int return_code) {
+  int32_t response = return_code;
+  // Do not get killed by SIGPIPE if the client went away.
+  return TEMP_FAILURE_RETRY(send(connection, &response, sizeof(response), MSG_NOSIGNAL)) ==
+      static_cast<ssize_t>(sizeof(response));
+}
+
+}  // namespace art
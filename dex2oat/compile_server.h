@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DEX2OAT_COMPILE_SERVER_H_
+#define ART_DEX2OAT_COMPILE_SERVER_H_
+
+#include <string>
+#include <vector>
+
+#include "android-base/unique_fd.h"
+
+namespace art {
+
+// Protocol of the dex2oat compile server, started with `dex2oat --compile-server=<socket>`.
+//
+// The server creates the runtime and maps the boot image once, then listens on a local
+// Unix socket. Each connection carries one request: the dex2oat arguments for a single
+// compilation and the file descriptors it uses. The server forks a child for each request,
+// which compiles with the already warm runtime and its own class loaders, and replies with
+// the dex2oat return code. Everything the request loaded goes away when the child exits.
+//
+// In the request arguments, each "{fd<i>}" is replaced by the server's number for the i-th
+// file descriptor sent with the request, e.g. "--oat-fd={fd0}".
+
+// Arguments of a request asking the server to exit.
+static constexpr const char* kCompileServerShutdownRequest = "--compile-server-shutdown";
+
+// Maximum number of file descriptors sent with a request.
+static constexpr size_t kCompileServerMaxRequestFds = 64u;
+
+// Sends a request to the compile server listening on `socket_path` and waits for the reply.
+// Returns false if the server could not be reached, otherwise stores the dex2oat return code
+// in `return_code`.
+bool SendCompileRequest(const std::string& socket_path,
+                        const std::vector<std::string>& args,
+                        const std::vector<int>& fds,
+                        /*out*/ int* return_code,
+                        /*out*/ std::string* error_msg);
+
+// Creates the listening socket of the compile server at `socket_path`, replacing any stale
+// socket file. Only the user of the server can connect to it. Returns an invalid fd on failure.
+android::base::unique_fd CreateCompileServerSocket(const std::string& socket_path,
+                                                   /*out*/ std::string* error_msg);
+
+// Reads a request from an accepted `connection` and substitutes the received file
+// descriptors in its arguments.
+bool ReceiveCompileRequest(int connection,
+                           /*out*/ std::vector<std::string>* args,
+                           /*out*/ std::vector<android::base::unique_fd>* fds,
+                           /*out*/ std::string* error_msg);
+
+// Replies to the request read from `connection`.
+bool SendCompileResponse(int connection, int return_code);
+
+}  // namespace art
+
+#endif  // ART_DEX2OAT_COMPILE_SERVER_H_
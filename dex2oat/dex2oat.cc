@@ -15,11 +15,16 @@
  */
 
 #include <inttypes.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include "base/memory_tool.h"
 
+#include <algorithm>
 #include <forward_list>
 #include <fstream>
 #include <iostream>
@@ -27,6 +32,7 @@
 #include <log/log.h>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -38,6 +44,7 @@
 #endif  // __arm__
 #endif
 
+#include "android-base/file.h"
 #include "android-base/parseint.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
@@ -65,6 +72,7 @@
 #include "class_loader_context.h"
 #include "cmdline_parser.h"
 #include "compiler.h"
+#include "compile_server.h"
 #include "compiler_callbacks.h"
 #include "debug/elf_debug_writer.h"
 #include "debug/method_debug_info.h"
@@ -75,6 +83,7 @@
 #include "dex/verification_results.h"
 #include "dex2oat_options.h"
 #include "dexlayout.h"
+#include "driver/compiled_method_cache.h"
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
 #include "driver/compiler_options_map-inl.h"
@@ -211,6 +220,33 @@ static std::string StrippedCommandLine() {
   return android::base::Join(command, ' ');
 }
 
+// Whether a command line argument only names inputs or outputs, or only affects how the
+// compilation is run, and can be left out of the context of the compiled method cache.
+// The contents of the inputs are checked by the cache itself.
+static bool IsCompiledMethodCacheNeutralArgument(std::string_view arg) {
+  static constexpr const char* kNeutralPrefixes[] = {
+      "--app-image-",
+      "--class-loader-context",
+      "--compilation-reason=",
+      "--compiled-method-cache=",
+      "--cpu-set=",
+      "--dex-",
+      "--dm-",
+      "--dump-",
+      "--input-vdex",
+      "--oat-",
+      "--output-vdex",
+      "--profile-file",
+      "--stored-class-loader-context=",
+      "--swap-",
+      "--zip-",
+      "-j",
+  };
+  return std::any_of(std::begin(kNeutralPrefixes),
+                     std::end(kNeutralPrefixes),
+                     [arg](const char* prefix) { return android::base::StartsWith(arg, prefix); });
+}
+
 static void UsageErrorV(const char* fmt, va_list ap) {
   std::string error;
   StringAppendV(&error, fmt, ap);
@@ -642,6 +678,19 @@ class Dex2Oat final {
       boot_image_filename_ = parser_options->boot_image_filename;
     }
 
+    if (IsCompileServer()) {
+      if (compile_server_ != nullptr) {
+        Usage("--compile-server cannot be used in a compile server request");
+      }
+      // The server only creates the runtime. Inputs and outputs come with each request
+      // and are checked when the request is parsed.
+      if (boot_image_filename_.empty()) {
+        boot_image_filename_ =
+            GetDefaultBootImageLocation(android_root_, /*deny_art_apex_data_files=*/false);
+      }
+      return;
+    }
+
     DCHECK(compiler_options_->image_type_ == CompilerOptions::ImageType::kNone);
     if (!image_filenames_.empty() || image_fd_ != -1) {
       // If no boot image is provided, then dex2oat is compiling the primary boot image,
@@ -661,6 +710,10 @@ class Dex2Oat final {
       Usage("Can't have both --image and --image-fd");
     }
 
+    if (!compiled_method_cache_filename_.empty() && compiler_options_->IsGeneratingImage()) {
+      Usage("--compiled-method-cache cannot be used when generating an image");
+    }
+
     if (oat_filenames_.empty() && oat_fd_ == -1) {
       Usage("Output must be supplied with either --oat-file or --oat-fd");
     }
@@ -928,6 +981,13 @@ class Dex2Oat final {
   }
 
   void InsertCompileOptions(int argc, char** argv) {
+    if (!compiled_method_cache_filename_.empty()) {
+      for (int i = 1; i < argc; ++i) {
+        if (!IsCompiledMethodCacheNeutralArgument(argv[i])) {
+          compiled_method_cache_args_.push_back(argv[i]);
+        }
+      }
+    }
     if (!avoid_storing_invocation_) {
       std::ostringstream oss;
       for (int i = 0; i < argc; ++i) {
@@ -1078,6 +1138,8 @@ class Dex2Oat final {
     AssignTrueIfExists(args, M::ForceAllowOjInlines, &force_allow_oj_inlines_);
     AssignIfExists(args, M::PublicSdk, &public_sdk_);
     AssignIfExists(args, M::ApexVersions, &apex_versions_argument_);
+    AssignIfExists(args, M::CompileServer, &compile_server_socket_);
+    AssignIfExists(args, M::CompiledMethodCache, &compiled_method_cache_filename_);
 
     AssignIfExists(args, M::Backend, &compiler_kind_);
     parser_options->requested_specific_compiler = args.Exists(M::Backend);
@@ -1903,6 +1965,16 @@ class Dex2Oat final {
     }
 
     const bool compile_individually = ShouldCompileDexFilesIndividually();
+    std::string compiled_method_cache_context;
+    if (!compiled_method_cache_filename_.empty()) {
+      if (compile_individually) {
+        LOG(WARNING) << "Ignoring --compiled-method-cache when compiling dex files individually";
+      } else if (GetCompiledMethodCacheContext(&compiled_method_cache_context)) {
+        compiled_method_cache_.reset(new CompiledMethodCache(compiled_method_cache_filename_,
+                                                             compiled_method_cache_context));
+        driver_->SetCompiledMethodCache(compiled_method_cache_.get());
+      }
+    }
     if (compile_individually) {
       // Set the compiler driver in the callbacks so that we can avoid re-verification. This not
       // only helps performance but also prevents reverifying quickened bytecodes. Attempting
@@ -1981,6 +2053,15 @@ class Dex2Oat final {
     compiler_options_->verification_results_ = verification_results_.get();
     driver_->CompileAll(class_loader, dex_files, timings_);
     driver_->FreeThreadPools();
+    if (compiled_method_cache_ != nullptr) {
+      LOG(INFO) << "Reused " << compiled_method_cache_->GetNumberOfReusedMethods()
+                << " methods from the compiled method cache";
+      TimingLogger::ScopedTiming t("Save compiled method cache", timings_);
+      std::string error_msg;
+      if (!compiled_method_cache_->Save(&error_msg)) {
+        LOG(WARNING) << "Failed to save the compiled method cache: " << error_msg;
+      }
+    }
     return class_loader;
   }
 
@@ -2303,6 +2384,12 @@ class Dex2Oat final {
     if (compiler_options_->GetDumpTimings() ||
         (kIsDebugBuild && timings_->GetTotalNs() > MsToNs(1000))) {
       LOG(INFO) << Dumpable<TimingLogger>(*timings_);
+      struct rusage usage;
+      if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // On Linux, the maximum resident set size is reported in kilobytes.
+        size_t peak_rss = static_cast<size_t>(usage.ru_maxrss) * KB;
+        LOG(INFO) << "dex2oat peak memory: " << PrettySize(peak_rss) << " (" << peak_rss << "B)";
+      }
     }
   }
 
@@ -2326,6 +2413,28 @@ class Dex2Oat final {
     return is_host_;
   }
 
+  bool IsCompileServer() const {
+    return !compile_server_socket_.empty();
+  }
+
+  const std::string& GetCompileServerSocket() const {
+    return compile_server_socket_;
+  }
+
+  // Creates the runtime that the compile server keeps warm for its requests.
+  bool SetupCompileServer() {
+    TimingLogger::ScopedTiming t("dex2oat Setup", timings_);
+    DCHECK(IsCompileServer());
+    callbacks_.reset(new QuickCompilerCallbacks(CompilerCallbacks::CallbackMode::kCompileApp));
+    RuntimeArgumentMap runtime_options;
+    if (!PrepareRuntimeOptions(&runtime_options, callbacks_.get()) ||
+        !CreateRuntime(std::move(runtime_options))) {
+      return false;
+    }
+    compile_server_ = this;
+    return true;
+  }
+
   bool HasProfileInput() const {
     return profile_file_fd_ != -1 || !profile_file_.empty();
   }
@@ -2360,6 +2469,36 @@ class Dex2Oat final {
     return MayInvalidateVdexMetadata() && dm_file_ == nullptr;
   }
 
+  // Describes everything outside the dex files being compiled that the compiled code depends
+  // on: target, compiler arguments, boot class path, class loader context and profile.
+  bool GetCompiledMethodCacheContext(/*out*/ std::string* context) const {
+    std::ostringstream oss;
+    oss << compiler_options_->GetInstructionSet() << ' '
+        << compiler_options_->GetInstructionSetFeatures()->GetFeatureString() << '\n';
+    for (const std::string& arg : compiled_method_cache_args_) {
+      oss << arg << '\n';
+    }
+    for (const auto& [key, value] : *key_value_store_) {
+      if (key != OatHeader::kDex2OatCmdLineKey && key != OatHeader::kCompilationReasonKey) {
+        oss << key << '=' << value << '\n';
+      }
+    }
+    if (HasProfileInput()) {
+      std::string profile;
+      bool read = (profile_file_fd_ != -1)
+          ? (lseek(profile_file_fd_, 0, SEEK_SET) == 0 &&
+             android::base::ReadFdToString(profile_file_fd_, &profile))
+          : android::base::ReadFileToString(profile_file_, &profile);
+      if (!read) {
+        PLOG(WARNING) << "Failed to read the profile for the compiled method cache";
+        return false;
+      }
+      oss << profile;
+    }
+    *context = oss.str();
+    return true;
+  }
+
   bool LoadProfile() {
     DCHECK(HasProfileInput());
     profile_load_attempted_ = true;
@@ -2637,6 +2776,7 @@ class Dex2Oat final {
           timings_,
           do_oat_writer_layout ? profile_compilation_info_.get() : nullptr,
           compact_dex_level_));
+      oat_writers_.back()->SetReleaseWrittenMethods(true);
     }
   }
 
@@ -2708,6 +2848,10 @@ class Dex2Oat final {
     // for primary boot image and different extensions that could be loaded together.
     mirror::Object::SetHashCodeSeed(987654321u ^ GetCombinedChecksums());
 
+    if (compile_server_ != nullptr) {
+      return UseCompileServerRuntime();
+    }
+
     TimingLogger::ScopedTiming t_runtime("Create runtime", timings_);
     if (!Runtime::Create(std::move(runtime_options))) {
       LOG(ERROR) << "Failed to create runtime";
@@ -2743,6 +2887,26 @@ class Dex2Oat final {
     return true;
   }
 
+  // Use the runtime inherited from the compile server when compiling one of its requests.
+  bool UseCompileServerRuntime() {
+    DCHECK(compile_server_ != nullptr);
+    if (IsBootImage() ||
+        IsBootImageExtension() ||
+        boot_image_filename_ != compile_server_->boot_image_filename_ ||
+        runtime_args_ != compile_server_->runtime_args_ ||
+        compiler_options_->GetInstructionSet() !=
+            compile_server_->compiler_options_->GetInstructionSet()) {
+      LOG(ERROR) << "Compile request does not match the runtime of the compile server";
+      return false;
+    }
+
+    TimingLogger::ScopedTiming t_runtime("Use compile server runtime", timings_);
+    runtime_.reset(Runtime::Current());
+    runtime_->SetCompilerCallbacks(callbacks_.get());
+    WatchDog::SetRuntime(runtime_.get());
+    return true;
+  }
+
   // Let the ImageWriter write the image files. If we do not compile PIC, also fix up the oat files.
   bool CreateImageFile()
       REQUIRES(!Locks::mutator_lock_) {
@@ -2999,12 +3163,27 @@ class Dex2Oat final {
   // argument.
   std::string apex_versions_argument_;
 
+  // The socket on which to serve compile requests, see compile_server.h.
+  std::string compile_server_socket_;
+
+  // The compile server whose runtime is used, in the children compiling its requests.
+  static const Dex2Oat* compile_server_;
+
+  // The compiled method cache, see compiled_method_cache.h.
+  std::string compiled_method_cache_filename_;
+  std::unique_ptr<CompiledMethodCache> compiled_method_cache_;
+
+  // Command line arguments that affect the compiled code, for the compiled method cache.
+  std::vector<std::string> compiled_method_cache_args_;
+
   // Whether or we attempted to load the profile (if given).
   bool profile_load_attempted_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(Dex2Oat);
 };
 
+const Dex2Oat* Dex2Oat::compile_server_ = nullptr;
+
 static void b13564922() {
 #if defined(__linux__) && defined(__arm__)
   int major, minor;
@@ -3086,6 +3265,85 @@ static dex2oat::ReturnCode DoCompilation(Dex2Oat& dex2oat) {
   return dex2oat::ReturnCode::kNoFailure;
 }
 
+static dex2oat::ReturnCode Dex2oat(int argc, char** argv);
+
+// Connection of the request handled by a compile server child, see RunCompileServer.
+static int compile_server_connection = -1;
+
+// Exit handler of compile server children. Replies to the client if the request did not
+// complete normally, e.g. when a usage error in its arguments makes dex2oat exit().
+static void SendCompileServerExitResponse() {
+  if (compile_server_connection != -1) {
+    SendCompileResponse(compile_server_connection, static_cast<int>(dex2oat::ReturnCode::kOther));
+    compile_server_connection = -1;
+  }
+}
+
+// Serves compile requests with the runtime created by `server`, see compile_server.h.
+// Each request is compiled in a forked child which inherits the warm runtime and boot
+// image. The classes and class loaders of the request are dropped when the child exits.
+static dex2oat::ReturnCode RunCompileServer(Dex2Oat& server, const char* program_name) {
+  if (!server.SetupCompileServer()) {
+    return dex2oat::ReturnCode::kCreateRuntime;
+  }
+
+  const std::string& socket_path = server.GetCompileServerSocket();
+  std::string error_msg;
+  android::base::unique_fd server_socket = CreateCompileServerSocket(socket_path, &error_msg);
+  if (server_socket.get() == -1) {
+    LOG(ERROR) << error_msg;
+    return dex2oat::ReturnCode::kOther;
+  }
+  // Children reply on their connection, the server does not wait for them.
+  signal(SIGCHLD, SIG_IGN);
+  LOG(INFO) << "Compile server listening on " << socket_path;
+
+  while (true) {
+    android::base::unique_fd connection(
+        TEMP_FAILURE_RETRY(accept4(server_socket.get(), nullptr, nullptr, SOCK_CLOEXEC)));
+    if (connection.get() == -1) {
+      PLOG(ERROR) << "Compile server failed to accept a connection";
+      unlink(socket_path.c_str());
+      return dex2oat::ReturnCode::kOther;
+    }
+    std::vector<std::string> args;
+    std::vector<android::base::unique_fd> fds;
+    if (!ReceiveCompileRequest(connection.get(), &args, &fds, &error_msg)) {
+      LOG(ERROR) << error_msg;
+      continue;
+    }
+    if (args.size() == 1u && args[0] == kCompileServerShutdownRequest) {
+      unlink(socket_path.c_str());
+      SendCompileResponse(connection.get(), static_cast<int>(dex2oat::ReturnCode::kNoFailure));
+      return dex2oat::ReturnCode::kNoFailure;
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+      PLOG(ERROR) << "Compile server failed to fork";
+      SendCompileResponse(connection.get(), static_cast<int>(dex2oat::ReturnCode::kOther));
+    } else if (pid == 0) {
+      // Only this thread survived the fork, and it has a new tid.
+      Thread::Current()->InitAfterFork();
+      signal(SIGCHLD, SIG_DFL);
+      server_socket.reset();
+      compile_server_connection = connection.get();
+      atexit(SendCompileServerExitResponse);
+      std::vector<char*> argv;
+      argv.push_back(const_cast<char*>(program_name));
+      for (std::string& arg : args) {
+        argv.push_back(arg.data());
+      }
+      argv.push_back(nullptr);
+      dex2oat::ReturnCode result = Dex2oat(static_cast<int>(argv.size() - 1u), argv.data());
+      compile_server_connection = -1;
+      SendCompileResponse(connection.get(), static_cast<int>(result));
+      _exit(0);
+    }
+    // The request's file descriptors and connection are only used by the child.
+  }
+}
+
 static dex2oat::ReturnCode Dex2oat(int argc, char** argv) {
   b13564922();
 
@@ -3102,6 +3360,10 @@ static dex2oat::ReturnCode Dex2oat(int argc, char** argv) {
 
   art::MemMap::Init();  // For ZipEntry::ExtractToMemMap, vdex and profiles.
 
+  if (dex2oat->IsCompileServer()) {
+    return RunCompileServer(*dex2oat, argv[0]);
+  }
+
   // If needed, process profile information for profile guided compilation.
   // This operation involves I/O.
   if (dex2oat->HasProfileInput()) {
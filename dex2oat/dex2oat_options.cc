@@ -420,7 +420,22 @@ Parser CreateDex2oatArgumentParser() {
       .Define("--apex-versions=_")
           .WithType<std::string>()
           .WithHelp("Versions of apexes in the boot classpath, separated by '/'")
-          .IntoKey(M::ApexVersions);
+          .IntoKey(M::ApexVersions)
+      .Define("--compile-server=_")
+          .WithType<std::string>()
+          .WithMetavar("<socket-path>")
+          .WithHelp("runs dex2oat as a server that keeps the runtime and boot image loaded and\n"
+                    "compiles the requests received on the given local socket. Only the boot\n"
+                    "image, instruction set and runtime arguments are taken from this command\n"
+                    "line, requests must use the same ones.")
+          .IntoKey(M::CompileServer)
+      .Define("--compiled-method-cache=_")
+          .WithType<std::string>()
+          .WithMetavar("<file>")
+          .WithHelp("reuses the code of methods that did not change since the compilation that\n"
+                    "wrote the given cache file, then rewrites it. Not supported for boot\n"
+                    "images and app images.")
+          .IntoKey(M::CompiledMethodCache);
 
   AddCompilerOptionsArgumentParserOptions<Dex2oatArgumentMap>(*parser_builder);
 
@@ -18,23 +18,29 @@
 #include <regex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <android-base/file.h>
 #include <android-base/logging.h>
 #include <android-base/macros.h>
+#include <android-base/scopeguard.h>
 #include <android-base/stringprintf.h>
 
 #include "common_runtime_test.h"
 
 #include "arch/instruction_set_features.h"
+#include "base/file_utils.h"
 #include "base/macros.h"
 #include "base/mutex-inl.h"
 #include "base/string_view_cpp20.h"
 #include "base/utils.h"
 #include "base/zip_archive.h"
+#include "compile_server.h"
 #include "dex/art_dex_file_loader.h"
 #include "dex/base64_test_util.h"
 #include "dex/bytecode_utils.h"
@@ -204,6 +210,18 @@ class Dex2oatTest : public Dex2oatEnvironmentTest {
     EXPECT_EQ(expected, actual);
   }
 
+  // Returns the number of methods the last compilation reused from the compiled method cache.
+  size_t ParseReusedMethods() {
+    std::regex reused_regex("Reused ([0-9]+) methods from the compiled method cache");
+    std::smatch reused_match;
+    bool found = std::regex_search(output_, reused_match, reused_regex);
+    if (!found) {
+      EXPECT_TRUE(found) << output_;
+      return 0u;
+    }
+    return std::stoul(reused_match[1].str());
+  }
+
   std::string output_ = "";
   std::string error_msg_ = "";
 };
@@ -2376,4 +2394,154 @@ TEST_F(Dex2oatTest, LoadOutOfDateOatFile) {
   }
 }
 
+TEST_F(Dex2oatTest, CompileServer) {
+  const std::string socket_path = GetScratchDir() + "/compile_server.socket";
+  std::thread server([&]() {
+    std::string output;
+    std::string error_msg;
+    int status = Dex2Oat({"--compile-server=" + socket_path}, &output, &error_msg);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << error_msg << output;
+  });
+  auto shutdown_server = android::base::make_scope_guard([&]() {
+    int return_code = -1;
+    std::string error_msg;
+    EXPECT_TRUE(SendCompileRequest(
+        socket_path, {kCompileServerShutdownRequest}, {}, &return_code, &error_msg)) << error_msg;
+    EXPECT_EQ(0, return_code);
+    server.join();
+  });
+
+  // Requests must use the runtime arguments of the server, which Dex2Oat() adds
+  // around its arguments. Mirror them here.
+  std::vector<std::string> runtime_args;
+  std::string error_msg;
+  ASSERT_TRUE(StartDex2OatCommandLine(&runtime_args, &error_msg)) << error_msg;
+  runtime_args.erase(runtime_args.begin());  // The server provides the program name.
+  runtime_args.push_back("--runtime-arg");
+  runtime_args.push_back(Runtime::Current()->MustRelocateIfPossible() ? "-Xrelocate"
+                                                                      : "-Xnorelocate");
+  if (!kIsTargetBuild) {
+    runtime_args.push_back("--host");
+  }
+  runtime_args.push_back("--android-root=" + std::string(getenv("ANDROID_ROOT")));
+
+  auto compile = [&](const std::string& name,
+                     const std::vector<std::string>& extra_args,
+                     /*out*/ int* return_code) {
+    std::string dex_location = GetScratchDir() + "/" + name + ".jar";
+    std::string odex_location = GetOdexDir() + "/" + name + ".odex";
+    Copy(GetDexSrc1(), dex_location);
+    std::unique_ptr<File> oat_file(OS::CreateEmptyFile(odex_location.c_str()));
+    std::unique_ptr<File> vdex_file(
+        OS::CreateEmptyFile(ReplaceFileExtension(odex_location, "vdex").c_str()));
+    ASSERT_TRUE(oat_file != nullptr && vdex_file != nullptr);
+
+    std::vector<std::string> args = runtime_args;
+    args.push_back("--dex-file=" + dex_location);
+    args.push_back("--oat-fd={fd0}");
+    args.push_back("--output-vdex-fd={fd1}");
+    args.push_back("--oat-location=" + odex_location);
+    args.insert(args.end(), extra_args.begin(), extra_args.end());
+    // The server may still be starting, retry until it accepts the request.
+    bool sent = false;
+    for (size_t attempt = 0; !sent && attempt != 600u; ++attempt) {
+      sent = SendCompileRequest(
+          socket_path, args, {oat_file->Fd(), vdex_file->Fd()}, return_code, &error_msg);
+      if (!sent) {
+        usleep(100 * 1000);
+      }
+    }
+    ASSERT_TRUE(sent) << error_msg;
+    ASSERT_EQ(0, oat_file->FlushClose());
+    ASSERT_EQ(0, vdex_file->FlushClose());
+    if (*return_code == 0) {
+      std::unique_ptr<OatFile> odex_file(OatFile::Open(/*zip_fd=*/ -1,
+                                                       odex_location,
+                                                       odex_location,
+                                                       /*executable=*/ false,
+                                                       /*low_4gb=*/ false,
+                                                       dex_location,
+                                                       &error_msg));
+      ASSERT_TRUE(odex_file != nullptr) << error_msg;
+    }
+  };
+
+  // Two requests compiled with the same warm runtime.
+  int return_code = -1;
+  compile("CompileServer1", {}, &return_code);
+  EXPECT_EQ(0, return_code);
+  compile("CompileServer2", {}, &return_code);
+  EXPECT_EQ(0, return_code);
+  // A request for a different runtime is rejected.
+  compile("CompileServer3", {"--runtime-arg", "-Xms3m"}, &return_code);
+  EXPECT_NE(0, return_code);
+  // A request with invalid arguments gets a reply, even though dex2oat exits on usage errors.
+  compile("CompileServer4", {"--compiler-filter=invalid"}, &return_code);
+  EXPECT_NE(0, return_code);
+
+  // Only the user of the server can connect to it.
+  struct stat st;
+  ASSERT_EQ(0, stat(socket_path.c_str(), &st));
+  EXPECT_EQ(static_cast<mode_t>(S_IRUSR | S_IWUSR), st.st_mode & 0777);
+}
+
+TEST_F(Dex2oatTest, CompiledMethodCache) {
+  std::string dex_location = GetScratchDir() + "/CompiledMethodCache.jar";
+  std::string odex_location = GetOdexDir() + "/CompiledMethodCache.odex";
+  std::string cache_location = GetScratchDir() + "/CompiledMethodCache.cache";
+  Copy(GetTestDexFileName("ManyMethods"), dex_location);
+  const std::vector<std::string> extra_args = { "--compiled-method-cache=" + cache_location };
+  // The number of reused methods is only in the output on the host, see CheckHostValidity().
+  auto expect_reused_methods = [&](bool expect_reused) {
+    if (!kIsTargetBuild) {
+      EXPECT_EQ(expect_reused, ParseReusedMethods() != 0u) << output_;
+    }
+  };
+
+  // The first compilation writes the cache.
+  ASSERT_TRUE(GenerateOdexForTest(dex_location, odex_location, CompilerFilter::kSpeed, extra_args));
+  ASSERT_TRUE(OS::FileExists(cache_location.c_str()));
+  expect_reused_methods(/*expect_reused=*/ false);
+  std::string first_odex;
+  ASSERT_TRUE(android::base::ReadFileToString(odex_location, &first_odex));
+
+  // The second compilation reuses all methods and must produce the same oat file.
+  ASSERT_TRUE(GenerateOdexForTest(dex_location, odex_location, CompilerFilter::kSpeed, extra_args));
+  std::string second_odex;
+  ASSERT_TRUE(android::base::ReadFileToString(odex_location, &second_odex));
+  EXPECT_TRUE(first_odex == second_odex);
+  expect_reused_methods(/*expect_reused=*/ true);
+
+  // The cache does not apply to a compilation with different options.
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  odex_location,
+                                  CompilerFilter::kSpeed,
+                                  { "--compiled-method-cache=" + cache_location, "--debuggable" }));
+  expect_reused_methods(/*expect_reused=*/ false);
+}
+
+// Compiled code embeds dex indexes outside of linker patches, for example in the slow paths
+// resolving strings and types. Methods whose indexes shift must be compiled again.
+TEST_F(Dex2oatTest, CompiledMethodCacheShiftedIndexes) {
+  std::string dex_location = GetScratchDir() + "/CompiledMethodCache.jar";
+  std::string odex_location = GetOdexDir() + "/CompiledMethodCache.odex";
+  std::string cache_location = GetScratchDir() + "/CompiledMethodCache.cache";
+  const std::vector<std::string> extra_args = { "--compiled-method-cache=" + cache_location };
+
+  Copy(GetTestDexFileName("CompiledMethodCacheA"), dex_location);
+  ASSERT_TRUE(GenerateOdexForTest(dex_location, odex_location, CompilerFilter::kSpeed, extra_args));
+  ASSERT_TRUE(GenerateOdexForTest(dex_location, odex_location, CompilerFilter::kSpeed, extra_args));
+  // The number of reused methods is only in the output on the host, see CheckHostValidity().
+  if (!kIsTargetBuild) {
+    EXPECT_NE(0u, ParseReusedMethods()) << output_;
+  }
+
+  // Only edited() changed, but the string and type indexes used by all other methods shifted.
+  Copy(GetTestDexFileName("CompiledMethodCacheB"), dex_location);
+  ASSERT_TRUE(GenerateOdexForTest(dex_location, odex_location, CompilerFilter::kSpeed, extra_args));
+  if (!kIsTargetBuild) {
+    EXPECT_EQ(0u, ParseReusedMethods()) << output_;
+  }
+}
+
 }  // namespace art
@@ -0,0 +1,953 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compiled_method_cache.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "android-base/logging.h"
+#include "android-base/stringprintf.h"
+
+#include "base/array_ref.h"
+#include "base/leb128.h"
+#include "base/logging.h"  // For VLOG.
+#include "base/os.h"
+#include "base/unix_file/fd_file.h"
+#include "class_status.h"
+#include "compiled_method-inl.h"
+#include "dex/class_accessor-inl.h"
+#include "dex/class_reference.h"
+#include "dex/code_item_accessors-inl.h"
+#include "dex/dex_file-inl.h"
+#include "dex/dex_file_exception_helpers.h"
+#include "dex/dex_instruction-inl.h"
+#include "driver/compiler_driver.h"
+#include "driver/compiler_options.h"
+#include "linker/linker_patch.h"
+#include "stack_map.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+namespace {
+
+static constexpr uint8_t kCacheMagic[] = { 'd', 'm', 'c', '\n' };
+static constexpr uint32_t kCacheVersion = 2u;
+
+// Methods with more code units are never found to always throw by the inliner,
+// see `AlwaysThrows()` in inliner.cc.
+static constexpr uint32_t kMaximumAlwaysThrowingCodeUnits = 1024u;
+
+// 64-bit FNV-1a hash of the data it is updated with.
+class Fingerprint {
+ public:
+  void UpdateBytes(const void* data, size_t size) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    for (size_t i = 0; i != size; ++i) {
+      hash_ = (hash_ ^ bytes[i]) * kPrime;
+    }
+  }
+
+  template <typename T>
+  void UpdateInt(T value) {
+    static_assert(std::is_integral_v<T>);
+    UpdateBytes(&value, sizeof(value));
+  }
+
+  void UpdateString(std::string_view str) {
+    UpdateInt<uint32_t>(str.size());
+    UpdateBytes(str.data(), str.size());
+  }
+
+  uint64_t Get() const {
+    return hash_;
+  }
+
+ private:
+  static constexpr uint64_t kOffsetBasis = UINT64_C(0xcbf29ce484222325);
+  static constexpr uint64_t kPrime = UINT64_C(0x100000001b3);
+
+  uint64_t hash_ = kOffsetBasis;
+};
+
+void UpdateWithString(Fingerprint* fingerprint, const DexFile& dex_file, dex::StringIndex idx) {
+  fingerprint->UpdateString(dex_file.StringViewByIdx(idx));
+}
+
+void UpdateWithType(Fingerprint* fingerprint, const DexFile& dex_file, dex::TypeIndex idx) {
+  fingerprint->UpdateString(idx.IsValid() ? dex_file.StringByTypeIdx(idx) : "");
+}
+
+void UpdateWithField(Fingerprint* fingerprint, const DexFile& dex_file, uint32_t field_idx) {
+  const dex::FieldId& field_id = dex_file.GetFieldId(field_idx);
+  fingerprint->UpdateString(dex_file.GetFieldDeclaringClassDescriptor(field_id));
+  fingerprint->UpdateString(dex_file.GetFieldName(field_id));
+  fingerprint->UpdateString(dex_file.GetFieldTypeDescriptor(field_id));
+}
+
+void UpdateWithMethod(Fingerprint* fingerprint, const DexFile& dex_file, uint32_t method_idx) {
+  const dex::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  fingerprint->UpdateString(dex_file.GetMethodDeclaringClassDescriptor(method_id));
+  fingerprint->UpdateString(dex_file.GetMethodName(method_id));
+  fingerprint->UpdateString(dex_file.GetMethodSignature(method_id).ToString());
+}
+
+void UpdateWithProto(Fingerprint* fingerprint, const DexFile& dex_file, dex::ProtoIndex idx) {
+  fingerprint->UpdateString(dex_file.GetProtoSignature(dex_file.GetProtoId(idx)).ToString());
+}
+
+// Fingerprints the code of a method with both the dex indexes it uses and what they refer to.
+// The compiled code does not only refer to dex files through linker patches, slow paths and
+// runtime calls for unresolved members pass raw string, type, field and method indexes. So an
+// edit renumbering the dex file must change the fingerprint of methods whose indexes shift.
+// Returns zero for code using call sites or method handles, which is not cached.
+uint64_t ComputeCodeFingerprint(const DexFile& dex_file,
+                                uint32_t method_idx,
+                                const CodeItemDataAccessor& accessor) {
+  Fingerprint fingerprint;
+  UpdateWithMethod(&fingerprint, dex_file, method_idx);
+  // The declaring class is loaded by its type index, for example for static field accesses.
+  fingerprint.UpdateInt(dex_file.GetMethodId(method_idx).class_idx_.index_);
+  fingerprint.UpdateInt(accessor.RegistersSize());
+  fingerprint.UpdateInt(accessor.InsSize());
+  fingerprint.UpdateInt(accessor.OutsSize());
+  fingerprint.UpdateInt(accessor.TriesSize());
+
+  std::vector<uint16_t> units;
+  for (const DexInstructionPcPair& pair : accessor) {
+    const Instruction& inst = pair.Inst();
+    const uint16_t* raw_units = reinterpret_cast<const uint16_t*>(&inst);
+    units.assign(raw_units, raw_units + inst.SizeInCodeUnits());
+    // Clear the index operands, they are fingerprinted below by what they refer to.
+    uint32_t index = 0u;
+    uint32_t proto_index = 0u;
+    switch (Instruction::FormatOf(inst.Opcode())) {
+      case Instruction::k21c:
+        index = inst.VRegB_21c();
+        units[1] = 0u;
+        break;
+      case Instruction::k31c:
+        index = inst.VRegB_31c();
+        units[1] = 0u;
+        units[2] = 0u;
+        break;
+      case Instruction::k22c:
+        index = inst.VRegC_22c();
+        units[1] = 0u;
+        break;
+      case Instruction::k35c:
+        index = inst.VRegB_35c();
+        units[1] = 0u;
+        break;
+      case Instruction::k3rc:
+        index = inst.VRegB_3rc();
+        units[1] = 0u;
+        break;
+      case Instruction::k45cc:
+        index = inst.VRegB_45cc();
+        proto_index = inst.VRegH_45cc();
+        units[1] = 0u;
+        units[3] = 0u;
+        break;
+      case Instruction::k4rcc:
+        index = inst.VRegB_4rcc();
+        proto_index = inst.VRegH_4rcc();
+        units[1] = 0u;
+        units[3] = 0u;
+        break;
+      default:
+        break;
+    }
+    fingerprint.UpdateBytes(units.data(), units.size() * sizeof(uint16_t));
+    switch (Instruction::IndexTypeOf(inst.Opcode())) {
+      case Instruction::kIndexNone:
+        break;
+      case Instruction::kIndexStringRef:
+        fingerprint.UpdateInt(index);
+        UpdateWithString(&fingerprint, dex_file, dex::StringIndex(index));
+        break;
+      case Instruction::kIndexTypeRef:
+        fingerprint.UpdateInt(index);
+        UpdateWithType(&fingerprint, dex_file, dex::TypeIndex(index));
+        break;
+      case Instruction::kIndexFieldRef:
+        // Static field accesses also load the declaring class by its type index.
+        fingerprint.UpdateInt(index);
+        fingerprint.UpdateInt(dex_file.GetFieldId(index).class_idx_.index_);
+        UpdateWithField(&fingerprint, dex_file, index);
+        break;
+      case Instruction::kIndexMethodRef:
+        // Static invokes also load the declaring class by its type index.
+        fingerprint.UpdateInt(index);
+        fingerprint.UpdateInt(dex_file.GetMethodId(index).class_idx_.index_);
+        UpdateWithMethod(&fingerprint, dex_file, index);
+        break;
+      case Instruction::kIndexMethodAndProtoRef:
+        fingerprint.UpdateInt(index);
+        fingerprint.UpdateInt(proto_index);
+        UpdateWithMethod(&fingerprint, dex_file, index);
+        UpdateWithProto(&fingerprint, dex_file, dex::ProtoIndex(proto_index));
+        break;
+      case Instruction::kIndexProtoRef:
+        fingerprint.UpdateInt(index);
+        UpdateWithProto(&fingerprint, dex_file, dex::ProtoIndex(index));
+        break;
+      default:
+        return 0u;
+    }
+  }
+
+  for (const dex::TryItem& try_item : accessor.TryItems()) {
+    fingerprint.UpdateInt(try_item.start_addr_);
+    fingerprint.UpdateInt(try_item.insn_count_);
+    for (CatchHandlerIterator it(accessor, try_item); it.HasNext(); it.Next()) {
+      fingerprint.UpdateInt(it.GetHandlerTypeIndex().index_);
+      UpdateWithType(&fingerprint, dex_file, it.GetHandlerTypeIndex());
+      fingerprint.UpdateInt(it.GetHandlerAddress());
+    }
+  }
+  // Zero means "not cacheable".
+  return std::max<uint64_t>(fingerprint.Get(), 1u);
+}
+
+// Whether the inliner may find that the method always throws, which changes how its callers
+// are compiled. This is a superset of `AlwaysThrows()` in inliner.cc.
+bool MayAlwaysThrow(const CodeItemDataAccessor& accessor) {
+  if (accessor.TriesSize() != 0u ||
+      accessor.InsnsSizeInCodeUnits() > kMaximumAlwaysThrowingCodeUnits) {
+    return false;
+  }
+  for (const DexInstructionPcPair& pair : accessor) {
+    switch (pair->Opcode()) {
+      case Instruction::RETURN:
+      case Instruction::RETURN_VOID:
+      case Instruction::RETURN_WIDE:
+      case Instruction::RETURN_OBJECT:
+        return false;
+      default:
+        break;
+    }
+  }
+  return true;
+}
+
+void UpdateWithStaticValues(Fingerprint* fingerprint,
+                            const DexFile& dex_file,
+                            const dex::ClassDef& class_def) {
+  for (EncodedStaticFieldValueIterator it(dex_file, class_def); it.HasNext(); it.Next()) {
+    fingerprint->UpdateInt(static_cast<uint32_t>(it.GetValueType()));
+    switch (it.GetValueType()) {
+      case EncodedArrayValueIterator::ValueType::kString:
+        UpdateWithString(fingerprint, dex_file, dex::StringIndex(it.GetJavaValue().i));
+        break;
+      case EncodedArrayValueIterator::ValueType::kType:
+        UpdateWithType(fingerprint, dex_file, dex::TypeIndex(it.GetJavaValue().i));
+        break;
+      default:
+        fingerprint->UpdateInt(it.GetJavaValue().j);
+        break;
+    }
+  }
+}
+
+// The compiler only looks for marker annotations such as @CriticalNative or @NeverInline,
+// so the types of the annotations are enough.
+void UpdateWithAnnotationSet(Fingerprint* fingerprint,
+                             const DexFile& dex_file,
+                             const dex::AnnotationSetItem* annotation_set) {
+  if (annotation_set == nullptr) {
+    fingerprint->UpdateInt(0u);
+    return;
+  }
+  fingerprint->UpdateInt(annotation_set->size_);
+  for (uint32_t i = 0; i != annotation_set->size_; ++i) {
+    const dex::AnnotationItem* annotation_item = dex_file.GetAnnotationItem(annotation_set, i);
+    fingerprint->UpdateInt(annotation_item->visibility_);
+    const uint8_t* annotation = annotation_item->annotation_;
+    UpdateWithType(fingerprint, dex_file, dex::TypeIndex(DecodeUnsignedLeb128(&annotation)));
+  }
+}
+
+void UpdateWithAnnotations(Fingerprint* fingerprint,
+                           const DexFile& dex_file,
+                           const dex::ClassDef& class_def) {
+  const dex::AnnotationsDirectoryItem* annotations = dex_file.GetAnnotationsDirectory(class_def);
+  if (annotations == nullptr) {
+    return;
+  }
+  UpdateWithAnnotationSet(fingerprint, dex_file, dex_file.GetClassAnnotationSet(annotations));
+  const dex::FieldAnnotationsItem* field_annotations = dex_file.GetFieldAnnotations(annotations);
+  for (uint32_t i = 0; i != annotations->fields_size_; ++i) {
+    UpdateWithField(fingerprint, dex_file, field_annotations[i].field_idx_);
+    UpdateWithAnnotationSet(
+        fingerprint, dex_file, dex_file.GetFieldAnnotationSetItem(field_annotations[i]));
+  }
+  const dex::MethodAnnotationsItem* method_annotations =
+      dex_file.GetMethodAnnotations(annotations);
+  for (uint32_t i = 0; i != annotations->methods_size_; ++i) {
+    UpdateWithMethod(fingerprint, dex_file, method_annotations[i].method_idx_);
+    UpdateWithAnnotationSet(
+        fingerprint, dex_file, dex_file.GetMethodAnnotationSetItem(method_annotations[i]));
+  }
+}
+
+bool FindMethodIndex(const DexFile& dex_file,
+                     const std::string& class_descriptor,
+                     const std::string& name,
+                     const std::string& signature,
+                     /*out*/ uint32_t* method_idx) {
+  const dex::TypeId* type_id = dex_file.FindTypeId(class_descriptor.c_str());
+  const dex::StringId* name_id = dex_file.FindStringId(name.c_str());
+  dex::TypeIndex return_type_idx;
+  std::vector<dex::TypeIndex> param_type_idxs;
+  if (type_id == nullptr ||
+      name_id == nullptr ||
+      !dex_file.CreateTypeList(signature, &return_type_idx, &param_type_idxs)) {
+    return false;
+  }
+  const dex::ProtoId* proto_id =
+      dex_file.FindProtoId(return_type_idx, param_type_idxs.data(), param_type_idxs.size());
+  if (proto_id == nullptr) {
+    return false;
+  }
+  const dex::MethodId* method_id = dex_file.FindMethodId(*type_id, *name_id, *proto_id);
+  if (method_id == nullptr) {
+    return false;
+  }
+  *method_idx = dex_file.GetIndexForMethodId(*method_id);
+  return true;
+}
+
+class CacheWriter {
+ public:
+  template <typename T>
+  void WriteInt(T value) {
+    static_assert(std::is_integral_v<T>);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    data_.insert(data_.end(), bytes, bytes + sizeof(value));
+  }
+
+  void WriteBytes(ArrayRef<const uint8_t> bytes) {
+    WriteInt<uint32_t>(bytes.size());
+    data_.insert(data_.end(), bytes.begin(), bytes.end());
+  }
+
+  void WriteString(const std::string& str) {
+    WriteBytes(ArrayRef<const uint8_t>(reinterpret_cast<const uint8_t*>(str.data()), str.size()));
+  }
+
+  const std::vector<uint8_t>& GetData() const {
+    return data_;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+class CacheReader {
+ public:
+  explicit CacheReader(ArrayRef<const uint8_t> data) : data_(data) {}
+
+  template <typename T>
+  bool ReadInt(/*out*/ T* value) {
+    static_assert(std::is_integral_v<T>);
+    if (data_.size() < sizeof(T)) {
+      return false;
+    }
+    memcpy(value, data_.data(), sizeof(T));
+    data_ = data_.SubArray(sizeof(T));
+    return true;
+  }
+
+  bool ReadBytes(/*out*/ std::vector<uint8_t>* bytes) {
+    uint32_t size;
+    if (!ReadInt(&size) || data_.size() < size) {
+      return false;
+    }
+    bytes->assign(data_.begin(), data_.begin() + size);
+    data_ = data_.SubArray(size);
+    return true;
+  }
+
+  bool ReadString(/*out*/ std::string* str) {
+    uint32_t size;
+    if (!ReadInt(&size) || data_.size() < size) {
+      return false;
+    }
+    str->assign(reinterpret_cast<const char*>(data_.data()), size);
+    data_ = data_.SubArray(size);
+    return true;
+  }
+
+  bool IsAtEnd() const {
+    return data_.empty();
+  }
+
+ private:
+  ArrayRef<const uint8_t> data_;
+};
+
+}  // namespace
+
+CompiledMethodCache::CompiledMethodCache(const std::string& filename, const std::string& context)
+    : filename_(filename),
+      context_(context),
+      fingerprint_(0u),
+      lock_("compiled method cache lock", kGenericBottomLock),
+      reused_methods_(0u) {}
+
+CompiledMethodCache::~CompiledMethodCache() {}
+
+void CompiledMethodCache::PrepareForCompilation(const CompilerDriver* driver,
+                                                const std::vector<const DexFile*>& dex_files) {
+  dex_files_ = dex_files;
+  code_fingerprints_.clear();
+  Fingerprint fingerprint;
+  fingerprint.UpdateInt(kCacheVersion);
+  fingerprint.UpdateString(context_);
+  for (const DexFile* dex_file : dex_files) {
+    std::vector<uint64_t> code_fingerprints(dex_file->NumMethodIds(), 0u);
+    fingerprint.UpdateInt(dex_file->NumClassDefs());
+    for (ClassAccessor accessor : dex_file->GetClasses()) {
+      const dex::ClassDef& class_def = accessor.GetClassDef();
+      fingerprint.UpdateString(accessor.GetDescriptor());
+      fingerprint.UpdateInt(accessor.GetAccessFlags());
+      UpdateWithType(&fingerprint, *dex_file, class_def.superclass_idx_);
+      const dex::TypeList* interfaces = dex_file->GetInterfacesList(class_def);
+      uint32_t num_interfaces = (interfaces != nullptr) ? interfaces->Size() : 0u;
+      fingerprint.UpdateInt(num_interfaces);
+      for (uint32_t i = 0; i != num_interfaces; ++i) {
+        UpdateWithType(&fingerprint, *dex_file, interfaces->GetTypeItem(i).type_idx_);
+      }
+      ClassStatus status =
+          driver->GetClassStatus(ClassReference(dex_file, accessor.GetClassDefIndex()));
+      fingerprint.UpdateInt(static_cast<uint32_t>(status));
+      UpdateWithStaticValues(&fingerprint, *dex_file, class_def);
+      UpdateWithAnnotations(&fingerprint, *dex_file, class_def);
+
+      for (const ClassAccessor::Field& field : accessor.GetFields()) {
+        UpdateWithField(&fingerprint, *dex_file, field.GetIndex());
+        fingerprint.UpdateInt(field.GetAccessFlags());
+        fingerprint.UpdateInt(field.GetHiddenapiFlags());
+      }
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        const uint32_t method_idx = method.GetIndex();
+        const uint32_t access_flags = method.GetAccessFlags();
+        UpdateWithMethod(&fingerprint, *dex_file, method_idx);
+        fingerprint.UpdateInt(access_flags);
+        fingerprint.UpdateInt(method.GetHiddenapiFlags());
+        if (method.GetCodeItem() == nullptr) {
+          continue;
+        }
+        CodeItemDataAccessor code(*dex_file, method.GetCodeItem());
+        uint64_t code_fingerprint = ComputeCodeFingerprint(*dex_file, method_idx, code);
+        code_fingerprints[method_idx] = code_fingerprint;
+        if ((access_flags & kAccConstructor) != 0u && (access_flags & kAccStatic) != 0u) {
+          // The compiler omits initialization checks of classes with a trivial <clinit>.
+          fingerprint.UpdateInt(code_fingerprint);
+        }
+        fingerprint.UpdateInt<uint8_t>(MayAlwaysThrow(code) ? 1u : 0u);
+      }
+    }
+    code_fingerprints_.push_back(std::move(code_fingerprints));
+  }
+  fingerprint_ = fingerprint.Get();
+
+  std::string error_msg;
+  if (!Load(&error_msg)) {
+    LOG(WARNING) << "Ignoring compiled method cache " << filename_ << ": " << error_msg;
+    previous_entries_.clear();
+  }
+}
+
+bool CompiledMethodCache::Load(std::string* error_msg) {
+  previous_entries_.clear();
+  if (!OS::FileExists(filename_.c_str())) {
+    return true;  // First compilation with this cache.
+  }
+  std::unique_ptr<File> file(OS::OpenFileForReading(filename_.c_str()));
+  if (file == nullptr) {
+    *error_msg = StringPrintf("Failed to open: %s", strerror(errno));
+    return false;
+  }
+  int64_t length = file->GetLength();
+  if (length < 0) {
+    *error_msg = StringPrintf("Failed to get length: %s", strerror(-length));
+    return false;
+  }
+  std::vector<uint8_t> data(static_cast<size_t>(length));
+  if (!file->ReadFully(data.data(), data.size())) {
+    *error_msg = StringPrintf("Failed to read: %s", strerror(errno));
+    return false;
+  }
+
+  CacheReader reader{ArrayRef<const uint8_t>(data)};
+  uint8_t magic[sizeof(kCacheMagic)];
+  for (uint8_t& c : magic) {
+    if (!reader.ReadInt(&c)) {
+      *error_msg = "Truncated header";
+      return false;
+    }
+  }
+  uint32_t version;
+  uint64_t fingerprint;
+  if (memcmp(magic, kCacheMagic, sizeof(kCacheMagic)) != 0 ||
+      !reader.ReadInt(&version) ||
+      !reader.ReadInt(&fingerprint)) {
+    *error_msg = "Invalid header";
+    return false;
+  }
+  if (version != kCacheVersion || fingerprint != fingerprint_) {
+    VLOG(compiler) << "Compiled method cache " << filename_ << " is out of date";
+    return true;
+  }
+
+  uint32_t num_entries;
+  if (!reader.ReadInt(&num_entries)) {
+    *error_msg = "Truncated header";
+    return false;
+  }
+  std::unordered_map<std::string, Entry> entries;
+  for (uint32_t i = 0; i != num_entries; ++i) {
+    std::string key;
+    Entry entry;
+    uint32_t num_dependencies;
+    if (!reader.ReadString(&key) ||
+        !reader.ReadInt(&entry.code_fingerprint) ||
+        !reader.ReadInt(&num_dependencies)) {
+      *error_msg = "Truncated entry";
+      return false;
+    }
+    for (uint32_t j = 0; j != num_dependencies; ++j) {
+      Dependency dependency;
+      if (!reader.ReadInt(&dependency.method_index) ||
+          !reader.ReadInt(&dependency.code_fingerprint)) {
+        *error_msg = "Truncated dependency";
+        return false;
+      }
+      entry.dependencies.push_back(dependency);
+    }
+    uint32_t num_patches;
+    if (!reader.ReadBytes(&entry.code) ||
+        !reader.ReadBytes(&entry.vmap_table) ||
+        !reader.ReadBytes(&entry.cfi_info) ||
+        !reader.ReadInt(&num_patches)) {
+      *error_msg = "Truncated entry";
+      return false;
+    }
+    for (uint32_t j = 0; j != num_patches; ++j) {
+      Patch patch;
+      if (!reader.ReadInt(&patch.type) ||
+          !reader.ReadInt(&patch.literal_offset) ||
+          !reader.ReadInt(&patch.pc_insn_offset) ||
+          !reader.ReadInt(&patch.value1) ||
+          !reader.ReadInt(&patch.value2) ||
+          !reader.ReadInt(&patch.dex_file_index) ||
+          !reader.ReadString(&patch.target_class) ||
+          !reader.ReadString(&patch.target_name) ||
+          !reader.ReadString(&patch.target_signature)) {
+        *error_msg = "Truncated patch";
+        return false;
+      }
+      entry.patches.push_back(std::move(patch));
+    }
+    entries.emplace(std::move(key), std::move(entry));
+  }
+  if (!reader.IsAtEnd()) {
+    *error_msg = "Unexpected data after the last entry";
+    return false;
+  }
+  VLOG(compiler) << "Loaded " << entries.size() << " methods from " << filename_;
+  previous_entries_.swap(entries);
+  return true;
+}
+
+bool CompiledMethodCache::Save(std::string* error_msg) {
+  CacheWriter writer;
+  for (uint8_t c : kCacheMagic) {
+    writer.WriteInt(c);
+  }
+  writer.WriteInt(kCacheVersion);
+  writer.WriteInt(fingerprint_);
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    writer.WriteInt<uint32_t>(entries_.size());
+    for (const auto& [key, entry] : entries_) {
+      writer.WriteString(key);
+      writer.WriteInt(entry.code_fingerprint);
+      writer.WriteInt<uint32_t>(entry.dependencies.size());
+      for (const Dependency& dependency : entry.dependencies) {
+        writer.WriteInt(dependency.method_index);
+        writer.WriteInt(dependency.code_fingerprint);
+      }
+      writer.WriteBytes(ArrayRef<const uint8_t>(entry.code));
+      writer.WriteBytes(ArrayRef<const uint8_t>(entry.vmap_table));
+      writer.WriteBytes(ArrayRef<const uint8_t>(entry.cfi_info));
+      writer.WriteInt<uint32_t>(entry.patches.size());
+      for (const Patch& patch : entry.patches) {
+        writer.WriteInt(patch.type);
+        writer.WriteInt(patch.literal_offset);
+        writer.WriteInt(patch.pc_insn_offset);
+        writer.WriteInt(patch.value1);
+        writer.WriteInt(patch.value2);
+        writer.WriteInt(patch.dex_file_index);
+        writer.WriteString(patch.target_class);
+        writer.WriteString(patch.target_name);
+        writer.WriteString(patch.target_signature);
+      }
+    }
+  }
+
+  // Write a temporary file and rename it, so that an interrupted compilation does not leave
+  // a truncated cache behind.
+  const std::string temp_filename = filename_ + ".tmp";
+  std::unique_ptr<File> file(OS::CreateEmptyFileWriteOnly(temp_filename.c_str()));
+  if (file == nullptr) {
+    *error_msg = StringPrintf("Failed to create %s: %s", temp_filename.c_str(), strerror(errno));
+    return false;
+  }
+  const std::vector<uint8_t>& data = writer.GetData();
+  if (!file->WriteFully(data.data(), data.size())) {
+    *error_msg = StringPrintf("Failed to write %s: %s", temp_filename.c_str(), strerror(errno));
+    file->Erase(/*unlink=*/ true);
+    return false;
+  }
+  if (file->FlushCloseOrErase() != 0) {
+    *error_msg = StringPrintf("Failed to flush %s: %s", temp_filename.c_str(), strerror(errno));
+    unlink(temp_filename.c_str());
+    return false;
+  }
+  if (rename(temp_filename.c_str(), filename_.c_str()) != 0) {
+    *error_msg = StringPrintf("Failed to rename %s to %s: %s",
+                              temp_filename.c_str(),
+                              filename_.c_str(),
+                              strerror(errno));
+    unlink(temp_filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+CompiledMethod* CompiledMethodCache::Lookup(CompilerDriver* driver, MethodReference method_ref) {
+  if (previous_entries_.empty()) {
+    return nullptr;
+  }
+  int32_t dex_file_index = GetDexFileIndex(method_ref.dex_file);
+  uint64_t code_fingerprint = GetCodeFingerprint(method_ref);
+  if (code_fingerprint == 0u) {
+    return nullptr;
+  }
+  std::string key = GetKey(method_ref);
+  auto it = previous_entries_.find(key);
+  if (it == previous_entries_.end()) {
+    return nullptr;
+  }
+  const Entry& entry = it->second;
+  std::vector<linker::LinkerPatch> patches;
+  if (entry.code_fingerprint != code_fingerprint ||
+      !CheckDependencies(dex_file_index, entry) ||
+      !MakePatches(entry, &patches)) {
+    return nullptr;
+  }
+  CompiledMethod* compiled_method = CompiledMethod::SwapAllocCompiledMethod(
+      driver->GetCompiledMethodStorage(),
+      driver->GetCompilerOptions().GetInstructionSet(),
+      ArrayRef<const uint8_t>(entry.code),
+      ArrayRef<const uint8_t>(entry.vmap_table),
+      ArrayRef<const uint8_t>(entry.cfi_info),
+      ArrayRef<const linker::LinkerPatch>(patches));
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    entries_.emplace(std::move(key), entry);
+  }
+  reused_methods_.fetch_add(1u, std::memory_order_relaxed);
+  return compiled_method;
+}
+
+void CompiledMethodCache::Insert(MethodReference method_ref,
+                                 const CompiledMethod* compiled_method) {
+  Entry entry;
+  if (!MakeEntry(method_ref, compiled_method, &entry)) {
+    return;
+  }
+  std::string key = GetKey(method_ref);
+  MutexLock mu(Thread::Current(), lock_);
+  entries_.emplace(std::move(key), std::move(entry));
+}
+
+bool CompiledMethodCache::MakeEntry(MethodReference method_ref,
+                                    const CompiledMethod* compiled_method,
+                                    /*out*/ Entry* entry) const {
+  entry->code_fingerprint = GetCodeFingerprint(method_ref);
+  if (compiled_method->IsIntrinsic() || entry->code_fingerprint == 0u) {
+    return false;
+  }
+
+  // Record the inlined methods. The stack maps refer to them by method index in the dex file
+  // of the compiled method.
+  ArrayRef<const uint8_t> vmap_table = compiled_method->GetVmapTable();
+  if (!vmap_table.empty()) {
+    CodeInfo code_info(vmap_table.data());
+    for (StackMap stack_map : code_info.GetStackMaps()) {
+      for (InlineInfo inline_info : code_info.GetInlineInfosOf(stack_map)) {
+        if (inline_info.EncodesArtMethod()) {
+          return false;
+        }
+        uint32_t method_index = code_info.GetMethodIndexOf(inline_info);
+        auto same_method = [method_index](const Dependency& dependency) {
+          return dependency.method_index == method_index;
+        };
+        if (std::none_of(entry->dependencies.begin(), entry->dependencies.end(), same_method)) {
+          uint64_t code_fingerprint =
+              GetCodeFingerprint(MethodReference(method_ref.dex_file, method_index));
+          if (code_fingerprint == 0u) {
+            return false;
+          }
+          entry->dependencies.push_back({method_index, code_fingerprint});
+        }
+      }
+    }
+  }
+
+  for (const linker::LinkerPatch& patch : compiled_method->GetPatches()) {
+    Patch cached_patch = {};
+    cached_patch.type = static_cast<uint8_t>(patch.GetType());
+    cached_patch.literal_offset = patch.LiteralOffset();
+    cached_patch.dex_file_index = -1;
+    const DexFile* target_dex_file = nullptr;
+    switch (patch.GetType()) {
+      case linker::LinkerPatch::Type::kIntrinsicReference:
+        cached_patch.pc_insn_offset = patch.PcInsnOffset();
+        cached_patch.value1 = patch.IntrinsicData();
+        break;
+      case linker::LinkerPatch::Type::kDataBimgRelRo:
+        cached_patch.pc_insn_offset = patch.PcInsnOffset();
+        cached_patch.value1 = patch.BootImageOffset();
+        break;
+      case linker::LinkerPatch::Type::kMethodRelative:
+      case linker::LinkerPatch::Type::kMethodBssEntry:
+      case linker::LinkerPatch::Type::kJniEntrypointRelative:
+        cached_patch.pc_insn_offset = patch.PcInsnOffset();
+        FALLTHROUGH_INTENDED;
+      case linker::LinkerPatch::Type::kCallRelative: {
+        MethodReference target = patch.TargetMethod();
+        const dex::MethodId& method_id = target.GetMethodId();
+        target_dex_file = target.dex_file;
+        cached_patch.target_class = target_dex_file->GetMethodDeclaringClassDescriptor(method_id);
+        cached_patch.target_name = target_dex_file->GetMethodName(method_id);
+        cached_patch.target_signature = target_dex_file->GetMethodSignature(method_id).ToString();
+        break;
+      }
+      case linker::LinkerPatch::Type::kTypeRelative:
+      case linker::LinkerPatch::Type::kTypeBssEntry:
+      case linker::LinkerPatch::Type::kPublicTypeBssEntry:
+      case linker::LinkerPatch::Type::kPackageTypeBssEntry:
+        cached_patch.pc_insn_offset = patch.PcInsnOffset();
+        target_dex_file = patch.TargetTypeDexFile();
+        cached_patch.target_class = target_dex_file->StringByTypeIdx(patch.TargetTypeIndex());
+        break;
+      case linker::LinkerPatch::Type::kStringRelative:
+      case linker::LinkerPatch::Type::kStringBssEntry:
+        cached_patch.pc_insn_offset = patch.PcInsnOffset();
+        target_dex_file = patch.TargetStringDexFile();
+        cached_patch.target_name = target_dex_file->StringViewByIdx(patch.TargetStringIndex());
+        break;
+      case linker::LinkerPatch::Type::kCallEntrypoint:
+        cached_patch.value1 = patch.EntrypointOffset();
+        break;
+      case linker::LinkerPatch::Type::kBakerReadBarrierBranch:
+        cached_patch.value1 = patch.GetBakerCustomValue1();
+        cached_patch.value2 = patch.GetBakerCustomValue2();
+        break;
+    }
+    if (target_dex_file != nullptr) {
+      // Only references to the dex files being compiled can be mapped to the next compilation.
+      cached_patch.dex_file_index = GetDexFileIndex(target_dex_file);
+      if (cached_patch.dex_file_index < 0) {
+        return false;
+      }
+    }
+    entry->patches.push_back(std::move(cached_patch));
+  }
+
+  ArrayRef<const uint8_t> code = compiled_method->GetQuickCode();
+  entry->code.assign(code.begin(), code.end());
+  entry->vmap_table.assign(vmap_table.begin(), vmap_table.end());
+  ArrayRef<const uint8_t> cfi_info = compiled_method->GetCFIInfo();
+  entry->cfi_info.assign(cfi_info.begin(), cfi_info.end());
+  return true;
+}
+
+bool CompiledMethodCache::CheckDependencies(size_t dex_file_index, const Entry& entry) const {
+  const std::vector<uint64_t>& code_fingerprints = code_fingerprints_[dex_file_index];
+  for (const Dependency& dependency : entry.dependencies) {
+    // The code fingerprint covers the name of the method, so a match also means that the
+    // inlined method kept its index.
+    if (dependency.method_index >= code_fingerprints.size() ||
+        code_fingerprints[dependency.method_index] != dependency.code_fingerprint) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CompiledMethodCache::MakePatches(const Entry& entry,
+                                      /*out*/ std::vector<linker::LinkerPatch>* patches) const {
+  using Type = linker::LinkerPatch::Type;
+  for (const Patch& cached_patch : entry.patches) {
+    const DexFile* dex_file = nullptr;
+    if (cached_patch.dex_file_index >= 0) {
+      if (static_cast<size_t>(cached_patch.dex_file_index) >= dex_files_.size()) {
+        return false;
+      }
+      dex_file = dex_files_[cached_patch.dex_file_index];
+    }
+    const uint32_t literal_offset = cached_patch.literal_offset;
+    const uint32_t pc_insn_offset = cached_patch.pc_insn_offset;
+    // Index of the target method, type or string in `dex_file`.
+    uint32_t target_idx = 0u;
+    switch (static_cast<Type>(cached_patch.type)) {
+      case Type::kMethodRelative:
+      case Type::kMethodBssEntry:
+      case Type::kJniEntrypointRelative:
+      case Type::kCallRelative:
+        if (dex_file == nullptr ||
+            !FindMethodIndex(*dex_file,
+                             cached_patch.target_class,
+                             cached_patch.target_name,
+                             cached_patch.target_signature,
+                             &target_idx)) {
+          return false;
+        }
+        break;
+      case Type::kTypeRelative:
+      case Type::kTypeBssEntry:
+      case Type::kPublicTypeBssEntry:
+      case Type::kPackageTypeBssEntry: {
+        const dex::TypeId* type_id =
+            (dex_file != nullptr) ? dex_file->FindTypeId(cached_patch.target_class.c_str())
+                                  : nullptr;
+        if (type_id == nullptr) {
+          return false;
+        }
+        target_idx = dex_file->GetIndexForTypeId(*type_id).index_;
+        break;
+      }
+      case Type::kStringRelative:
+      case Type::kStringBssEntry: {
+        const dex::StringId* string_id =
+            (dex_file != nullptr) ? dex_file->FindStringId(cached_patch.target_name.c_str())
+                                  : nullptr;
+        if (string_id == nullptr) {
+          return false;
+        }
+        target_idx = dex_file->GetIndexForStringId(*string_id).index_;
+        break;
+      }
+      default:
+        break;
+    }
+
+    switch (static_cast<Type>(cached_patch.type)) {
+      case Type::kIntrinsicReference:
+        patches->push_back(linker::LinkerPatch::IntrinsicReferencePatch(
+            literal_offset, pc_insn_offset, cached_patch.value1));
+        break;
+      case Type::kDataBimgRelRo:
+        patches->push_back(linker::LinkerPatch::DataBimgRelRoPatch(
+            literal_offset, pc_insn_offset, cached_patch.value1));
+        break;
+      case Type::kMethodRelative:
+        patches->push_back(linker::LinkerPatch::RelativeMethodPatch(
+            literal_offset, dex_file, pc_insn_offset, target_idx));
+        break;
+      case Type::kMethodBssEntry:
+        patches->push_back(linker::LinkerPatch::MethodBssEntryPatch(
+            literal_offset, dex_file, pc_insn_offset, target_idx));
+        break;
+      case Type::kJniEntrypointRelative:
+        patches->push_back(linker::LinkerPatch::RelativeJniEntrypointPatch(
+            literal_offset, dex_file, pc_insn_offset, target_idx));
+        break;
+      case Type::kCallRelative:
+        patches->push_back(
+            linker::LinkerPatch::RelativeCodePatch(literal_offset, dex_file, target_idx));
+        break;
+      case Type::kTypeRelative:
+        patches->push_back(linker::LinkerPatch::RelativeTypePatch(
+            literal_offset, dex_file, pc_insn_offset, target_idx));
+        break;
+      case Type::kTypeBssEntry:
+        patches->push_back(linker::LinkerPatch::TypeBssEntryPatch(
+            literal_offset, dex_file, pc_insn_offset, target_idx));
+        break;
+      case Type::kPublicTypeBssEntry:
+        patches->push_back(linker::LinkerPatch::PublicTypeBssEntryPatch(
+            literal_offset, dex_file, pc_insn_offset, target_idx));
+        break;
+      case Type::kPackageTypeBssEntry:
+        patches->push_back(linker::LinkerPatch::PackageTypeBssEntryPatch(
+            literal_offset, dex_file, pc_insn_offset, target_idx));
+        break;
+      case Type::kStringRelative:
+        patches->push_back(linker::LinkerPatch::RelativeStringPatch(
+            literal_offset, dex_file, pc_insn_offset, target_idx));
+        break;
+      case Type::kStringBssEntry:
+        patches->push_back(linker::LinkerPatch::StringBssEntryPatch(
+            literal_offset, dex_file, pc_insn_offset, target_idx));
+        break;
+      case Type::kCallEntrypoint:
+        patches->push_back(
+            linker::LinkerPatch::CallEntrypointPatch(literal_offset, cached_patch.value1));
+        break;
+      case Type::kBakerReadBarrierBranch:
+        patches->push_back(linker::LinkerPatch::BakerReadBarrierBranchPatch(
+            literal_offset, cached_patch.value1, cached_patch.value2));
+        break;
+      default:
+        return false;  // Corrupt cache file.
+    }
+  }
+  return true;
+}
+
+uint64_t CompiledMethodCache::GetCodeFingerprint(MethodReference method_ref) const {
+  int32_t dex_file_index = GetDexFileIndex(method_ref.dex_file);
+  if (dex_file_index < 0) {
+    return 0u;
+  }
+  const std::vector<uint64_t>& code_fingerprints = code_fingerprints_[dex_file_index];
+  return (method_ref.index < code_fingerprints.size()) ? code_fingerprints[method_ref.index] : 0u;
+}
+
+int32_t CompiledMethodCache::GetDexFileIndex(const DexFile* dex_file) const {
+  auto it = std::find(dex_files_.begin(), dex_files_.end(), dex_file);
+  return (it != dex_files_.end()) ? static_cast<int32_t>(it - dex_files_.begin()) : -1;
+}
+
+std::string CompiledMethodCache::GetKey(MethodReference method_ref) const {
+  return std::to_string(GetDexFileIndex(method_ref.dex_file)) + ':' + method_ref.PrettyMethod();
+}
+
+}  // namespace art
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DEX2OAT_DRIVER_COMPILED_METHOD_CACHE_H_
+#define ART_DEX2OAT_DRIVER_COMPILED_METHOD_CACHE_H_
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "dex/method_reference.h"
+
+namespace art {
+
+class CompiledMethod;
+class CompilerDriver;
+class DexFile;
+
+namespace linker {
+class LinkerPatch;
+}  // namespace linker
+
+// Cache of compiled methods that lets dex2oat reuse the code of methods that did not change
+// since a previous compilation, see `dex2oat --compiled-method-cache`.
+//
+// The code in an oat file is already linked, so the cache keeps the methods as the compiler
+// produced them: code, stack maps, CFI and linker patches. Dex indexes in the patches are
+// stored symbolically and mapped to the new dex files on reuse, the linker then patches the
+// reused code like freshly compiled code. Other dex indexes, such as those passed to runtime
+// calls by slow paths, are embedded in the code, so they must not change.
+//
+// A cached method is reused only if all of the following are unchanged:
+//  - the compilation context: compiler options, boot class path, class loader context and
+//    profile, see `context`,
+//  - the declarations of all classes being compiled: hierarchy, fields, methods, annotations,
+//    static values, <clinit> code and verification status. Field offsets, vtable layout and
+//    class initialization checks in the compiled code depend on them,
+//  - the set of methods the inliner may consider to always throw,
+//  - the code of the method, with the dex indexes it uses and what they refer to,
+//  - the code of the methods inlined into it, which must also keep their method index as the
+//    stack maps refer to them by index.
+class CompiledMethodCache {
+ public:
+  CompiledMethodCache(const std::string& filename, const std::string& context);
+  ~CompiledMethodCache();
+
+  // Fingerprints `dex_files` and loads the entries of the cache file that match. Must be called
+  // after verification, as the verification status of classes is part of the fingerprint.
+  void PrepareForCompilation(const CompilerDriver* driver,
+                             const std::vector<const DexFile*>& dex_files);
+
+  // Returns a compiled method reused from the cache, or null if the method must be compiled.
+  CompiledMethod* Lookup(CompilerDriver* driver, MethodReference method_ref)
+      REQUIRES(!lock_);
+
+  // Records a freshly compiled method for the next compilation.
+  void Insert(MethodReference method_ref, const CompiledMethod* compiled_method)
+      REQUIRES(!lock_);
+
+  // Writes the methods compiled or reused by this compilation to the cache file.
+  bool Save(std::string* error_msg) REQUIRES(!lock_);
+
+  size_t GetNumberOfReusedMethods() const {
+    return reused_methods_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // A linker patch with its dex reference, if any, stored by name.
+  struct Patch {
+    uint8_t type;
+    uint32_t literal_offset;
+    uint32_t pc_insn_offset;
+    // Data of patches that do not refer to a dex file.
+    uint32_t value1;
+    uint32_t value2;
+    // Index of the target dex file in the compiled dex files, or -1.
+    int32_t dex_file_index;
+    // Declaring class, name and signature of a target method, descriptor of a target type
+    // (in `target_class`) or contents of a target string (in `target_name`).
+    std::string target_class;
+    std::string target_name;
+    std::string target_signature;
+  };
+
+  // A method inlined into the cached method.
+  struct Dependency {
+    uint32_t method_index;
+    uint64_t code_fingerprint;
+  };
+
+  struct Entry {
+    uint64_t code_fingerprint;
+    std::vector<Dependency> dependencies;
+    std::vector<uint8_t> code;
+    std::vector<uint8_t> vmap_table;
+    std::vector<uint8_t> cfi_info;
+    std::vector<Patch> patches;
+  };
+
+  bool Load(std::string* error_msg);
+  bool MakeEntry(MethodReference method_ref,
+                 const CompiledMethod* compiled_method,
+                 /*out*/ Entry* entry) const;
+  bool CheckDependencies(size_t dex_file_index, const Entry& entry) const;
+  bool MakePatches(const Entry& entry, /*out*/ std::vector<linker::LinkerPatch>* patches) const;
+  uint64_t GetCodeFingerprint(MethodReference method_ref) const;
+  int32_t GetDexFileIndex(const DexFile* dex_file) const;
+  std::string GetKey(MethodReference method_ref) const;
+
+  const std::string filename_;
+  const std::string context_;
+
+  // Dex files being compiled, and the code fingerprint of each of their methods indexed by
+  // method index. Zero for methods without code or that cannot be cached.
+  std::vector<const DexFile*> dex_files_;
+  std::vector<std::vector<uint64_t>> code_fingerprints_;
+  uint64_t fingerprint_;
+
+  // Entries from the cache file. Read-only during compilation.
+  std::unordered_map<std::string, Entry> previous_entries_;
+
+  // Entries to write back to the cache file.
+  Mutex lock_;
+  std::unordered_map<std::string, Entry> entries_ GUARDED_BY(lock_);
+
+  std::atomic<size_t> reused_methods_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompiledMethodCache);
+};
+
+}  // namespace art
+
+#endif  // ART_DEX2OAT_DRIVER_COMPILED_METHOD_CACHE_H_
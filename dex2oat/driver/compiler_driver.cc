@@ -22,6 +22,9 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <algorithm>
+#include <limits>
+#include <sstream>
 #include <string_view>
 #include <vector>
 
@@ -54,6 +57,7 @@
 #include "dex/dex_instruction-inl.h"
 #include "dex/verification_results.h"
 #include "dex/verified_method.h"
+#include "driver/compiled_method_cache.h"
 #include "driver/compiler_options.h"
 #include "driver/dex_compilation_unit.h"
 #include "gc/accounting/card_table-inl.h"
@@ -96,6 +100,13 @@ static constexpr bool kTimeCompileMethod = !kIsDebugBuild;
 // Print additional info during profile guided compilation.
 static constexpr bool kDebugProfileGuidedCompilation = false;
 
+// Compile work is split so that each compiler thread gets about this many work items, which
+// keeps a single huge class from dominating the tail of the parallel compilation.
+static constexpr size_t kCompileWorkItemsPerThread = 16;
+
+// Classes cheaper than this (in estimated code units) are never split across work items.
+static constexpr uint64_t kMinimumCompileWorkItemCost = 1024;
+
 // Max encoded fields allowed for initializing app image. Hardcode the number for now
 // because 5000 should be large enough.
 static constexpr uint32_t kMaxEncodedFields = 5000;
@@ -264,6 +275,7 @@ CompilerDriver::CompilerDriver(
       parallel_thread_count_(thread_count),
       stats_(new AOTCompilationStats),
       compiled_method_storage_(swap_fd),
+      compiled_method_cache_(nullptr),
       max_arena_alloc_(0) {
   DCHECK(compiler_options_ != nullptr);
 
@@ -470,15 +482,24 @@ static void CompileMethodQuick(
               driver->ShouldCompileBasedOnProfile(method_ref);
 
       if (compile) {
-        // NOTE: if compiler declines to compile this method, it will return null.
-        compiled_method = driver->GetCompiler()->Compile(code_item,
-                                                         access_flags,
-                                                         invoke_type,
-                                                         class_def_idx,
-                                                         method_idx,
-                                                         class_loader,
-                                                         dex_file,
-                                                         dex_cache);
+        CompiledMethodCache* cache = driver->GetCompiledMethodCache();
+        if (cache != nullptr) {
+          compiled_method = cache->Lookup(driver, method_ref);
+        }
+        if (compiled_method == nullptr) {
+          // NOTE: if compiler declines to compile this method, it will return null.
+          compiled_method = driver->GetCompiler()->Compile(code_item,
+                                                           access_flags,
+                                                           invoke_type,
+                                                           class_def_idx,
+                                                           method_idx,
+                                                           class_loader,
+                                                           dex_file,
+                                                           dex_cache);
+          if (cache != nullptr && compiled_method != nullptr) {
+            cache->Insert(method_ref, compiled_method);
+          }
+        }
         ProfileMethodsCheck check_type =
             driver->GetCompilerOptions().CheckProfiledMethodsCompiled();
         if (UNLIKELY(check_type != ProfileMethodsCheck::kNone)) {
@@ -1401,8 +1422,9 @@ class ParallelCompilationManager {
     CHECK_GT(work_units, 0U);
 
     index_.store(begin, std::memory_order_relaxed);
+    worker_busy_ns_.assign(work_units, 0u);
     for (size_t i = 0; i < work_units; ++i) {
-      thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn));
+      thread_pool_->AddTask(self, new ForAllClosureLambda<Fn>(this, end, fn, &worker_busy_ns_[i]));
     }
     thread_pool_->StartWorkers(self);
 
@@ -1421,16 +1443,23 @@ class ParallelCompilationManager {
     return index_.fetch_add(1, std::memory_order_seq_cst);
   }
 
+  // Returns the time each work unit of the last ForAll spent running before it ran out of work.
+  ArrayRef<const uint64_t> GetWorkerBusyTimes() const {
+    return ArrayRef<const uint64_t>(worker_busy_ns_);
+  }
+
  private:
   template <typename Fn>
   class ForAllClosureLambda : public Task {
    public:
-    ForAllClosureLambda(ParallelCompilationManager* manager, size_t end, Fn fn)
+    ForAllClosureLambda(ParallelCompilationManager* manager, size_t end, Fn fn, uint64_t* busy_ns)
         : manager_(manager),
           end_(end),
-          fn_(fn) {}
+          fn_(fn),
+          busy_ns_(busy_ns) {}
 
     void Run(Thread* self) override {
+      const uint64_t start_ns = NanoTime();
       while (true) {
         const size_t index = manager_->NextIndex();
         if (UNLIKELY(index >= end_)) {
@@ -1439,6 +1468,7 @@ class ParallelCompilationManager {
         fn_(index);
         self->AssertNoPendingException();
       }
+      *busy_ns_ = NanoTime() - start_ns;
     }
 
     void Finalize() override {
@@ -1449,9 +1479,11 @@ class ParallelCompilationManager {
     ParallelCompilationManager* const manager_;
     const size_t end_;
     Fn fn_;
+    uint64_t* const busy_ns_;
   };
 
   AtomicInteger index_;
+  std::vector<uint64_t> worker_busy_ns_;
   ClassLinker* const class_linker_;
   const jobject class_loader_;
   CompilerDriver* const compiler_;
@@ -2192,6 +2224,18 @@ class InitializeClassVisitor : public CompilationVisitor {
         bool too_many_encoded_fields = (!is_boot_image && !is_boot_image_extension) &&
             klass->NumStaticFields() > kMaxEncodedFields;
 
+        if (is_app_image && !klass->IsInitialized()) {
+          if (!try_initialize_with_superclasses) {
+            ReportNotInitialized(descriptor,
+                                 "Superclass or interface not initialized, or unresolved types"
+                                 " in method signatures");
+          } else if (too_many_encoded_fields) {
+            ReportNotInitialized(descriptor, "Too many static fields");
+          } else if (!compiler_options.IsImageClass(descriptor)) {
+            ReportNotInitialized(descriptor, "Not an image class");
+          }
+        }
+
         // If the class was not initialized, we can proceed to see if we can initialize static
         // fields. Limit the max number of encoded fields.
         if (!klass->IsInitialized() &&
@@ -2218,6 +2262,13 @@ class InitializeClassVisitor : public CompilationVisitor {
                 !compiler_options.GetDebuggable() &&
                 (compiler_options.InitializeAppImageClasses() ||
                  NoClinitInDependency(klass, self, &class_loader));
+            if (!can_init_static_fields) {
+              ReportNotInitialized(descriptor,
+                                   compiler_options.GetDebuggable()
+                                       ? "Debuggable compilation"
+                                       : "Class initializer in the class or its dependencies"
+                                         " requires --initialize-app-image-classes");
+            }
             // TODO The checking for clinit can be removed since it's already
             // checked when init superclass. Currently keep it because it contains
             // processing of intern strings. Will be removed later when intern strings
@@ -2309,6 +2360,8 @@ class InitializeClassVisitor : public CompilationVisitor {
         }
         self->AssertNoPendingException();
       }
+    } else if (is_app_image) {
+      ReportNotInitialized(descriptor, "Not verified");
     }
     if (old_status == ClassStatus::kInitialized) {
       // Initialized classes shall be visibly initialized when loaded from the image.
@@ -2327,6 +2380,17 @@ class InitializeClassVisitor : public CompilationVisitor {
   }
 
  private:
+  // Records why the static fields of an app image class are not initialized at compile time,
+  // see `--dump-init-failures`. Transaction aborts are recorded with the exception instead.
+  void ReportNotInitialized(const char* descriptor, const char* reason) {
+    VLOG(compiler) << "Not initializing " << descriptor << ": " << reason;
+    std::ostream* file_log = manager_->GetCompiler()->GetCompilerOptions().GetInitFailureOutput();
+    if (file_log != nullptr) {
+      *file_log << descriptor << "\n";
+      *file_log << reason << "\n";
+    }
+  }
+
   void InternStrings(Handle<mirror::Class> klass, Handle<mirror::ClassLoader> class_loader)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     DCHECK(manager_->GetCompiler()->GetCompilerOptions().IsBootImage() ||
@@ -2551,6 +2615,104 @@ void CompilerDriver::InitializeClasses(jobject class_loader,
   }
 }
 
+// A contiguous range of the methods of a class, in ClassAccessor::GetMethods() order,
+// compiled as one unit of work.
+struct CompileWorkItem {
+  uint32_t class_def_index;
+  uint32_t begin_method;
+  uint32_t end_method;
+  uint64_t cost;
+};
+
+// Estimates the cost of compiling `method` from its code size. Methods without code
+// or which the profile excludes from compilation are cheap.
+static uint64_t EstimateCompileCost(const CompilerDriver* driver,
+                                    const DexFile& dex_file,
+                                    const ClassAccessor::Method& method) {
+  if (method.GetCodeItem() == nullptr ||
+      !driver->ShouldCompileBasedOnProfile(MethodReference(&dex_file, method.GetIndex()))) {
+    return 1u;
+  }
+  return 1u + method.GetInstructions().InsnsSizeInCodeUnits();
+}
+
+// Splits the classes of `dex_file` into work items, longest expected job first. Classes are
+// split at method boundaries when they are much larger than the average work item, so that
+// a few huge classes do not leave the other compiler threads idle at the end.
+static std::vector<CompileWorkItem> CollectCompileWorkItems(const CompilerDriver* driver,
+                                                            const DexFile& dex_file,
+                                                            size_t thread_count) {
+  const uint32_t num_class_defs = dex_file.NumClassDefs();
+  std::vector<CompileWorkItem> work_items;
+  work_items.reserve(num_class_defs);
+  if (thread_count <= 1u) {
+    // Nothing to balance, compile whole classes in index order.
+    for (uint32_t class_def_index = 0; class_def_index != num_class_defs; ++class_def_index) {
+      work_items.push_back({class_def_index, 0u, std::numeric_limits<uint32_t>::max(), 0u});
+    }
+    return work_items;
+  }
+
+  std::vector<uint64_t> method_costs;
+  uint64_t total_cost = 0u;
+  for (uint32_t class_def_index = 0; class_def_index != num_class_defs; ++class_def_index) {
+    ClassAccessor accessor(dex_file, class_def_index);
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      method_costs.push_back(EstimateCompileCost(driver, dex_file, method));
+      total_cost += method_costs.back();
+    }
+  }
+  const uint64_t max_item_cost = std::max(
+      kMinimumCompileWorkItemCost, total_cost / (thread_count * kCompileWorkItemsPerThread));
+
+  auto cost_it = method_costs.begin();
+  for (uint32_t class_def_index = 0; class_def_index != num_class_defs; ++class_def_index) {
+    CompileWorkItem item = {class_def_index, 0u, 0u, 0u};
+    int64_t previous_method_idx = -1;
+    ClassAccessor accessor(dex_file, class_def_index);
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      // Never separate duplicate encoded methods, the compile loop skips them by comparing
+      // with the previous method.
+      if (item.cost >= max_item_cost && method.GetIndex() != previous_method_idx) {
+        work_items.push_back(item);
+        item = {class_def_index, item.end_method, item.end_method, 0u};
+      }
+      previous_method_idx = method.GetIndex();
+      ++item.end_method;
+      item.cost += *cost_it;
+      ++cost_it;
+    }
+    work_items.push_back(item);
+  }
+  DCHECK(cost_it == method_costs.end());
+
+  std::stable_sort(work_items.begin(),
+                   work_items.end(),
+                   [](const CompileWorkItem& lhs, const CompileWorkItem& rhs) {
+                     return lhs.cost > rhs.cost;
+                   });
+  return work_items;
+}
+
+// Logs how much of the wall time of a parallel compilation each worker spent compiling.
+static void DumpWorkerUtilization(const char* timing_name,
+                                  size_t num_work_items,
+                                  uint64_t wall_ns,
+                                  ArrayRef<const uint64_t> busy_ns) {
+  uint64_t total_busy_ns = 0u;
+  std::ostringstream oss;
+  for (size_t i = 0; i != busy_ns.size(); ++i) {
+    total_busy_ns += busy_ns[i];
+    oss << " " << PrettyDuration(busy_ns[i]);
+  }
+  double utilization = (wall_ns != 0u)
+      ? 100.0 * static_cast<double>(total_busy_ns) / static_cast<double>(wall_ns * busy_ns.size())
+      : 100.0;
+  LOG(INFO) << timing_name << ": " << num_work_items << " work items on " << busy_ns.size()
+            << " threads in " << PrettyDuration(wall_ns) << ", utilization " << utilization
+            << "%, busy time:" << oss.str();
+}
+
 template <typename CompileFn>
 static void CompileDexFile(CompilerDriver* driver,
                            jobject class_loader,
@@ -2569,7 +2731,12 @@ static void CompileDexFile(CompilerDriver* driver,
                                      dex_files,
                                      thread_pool);
 
-  auto compile = [&context, &compile_fn](size_t class_def_index) {
+  const std::vector<CompileWorkItem> work_items =
+      CollectCompileWorkItems(driver, dex_file, thread_count);
+
+  auto compile = [&context, &compile_fn, &work_items](size_t work_item_index) {
+    const CompileWorkItem& work_item = work_items[work_item_index];
+    const uint32_t class_def_index = work_item.class_def_index;
     const DexFile& dex_file = *context.GetDexFile();
     SCOPED_TRACE << "compile " << dex_file.GetLocation() << "@" << class_def_index;
     ClassLinker* class_linker = context.GetClassLinker();
@@ -2611,9 +2778,16 @@ static void CompileDexFile(CompilerDriver* driver,
     // Go to native so that we don't block GC during compilation.
     ScopedThreadSuspension sts(soa.Self(), kNative);
 
-    // Compile direct and virtual methods.
+    // Compile direct and virtual methods of this work item.
     int64_t previous_method_idx = -1;
+    uint32_t method_index = 0u;
     for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      if (method_index++ < work_item.begin_method) {
+        continue;
+      }
+      if (method_index > work_item.end_method) {
+        break;
+      }
       const uint32_t method_idx = method.GetIndex();
       if (method_idx == previous_method_idx) {
         // smali can create dex files with two encoded_methods sharing the same method_idx
@@ -2633,7 +2807,12 @@ static void CompileDexFile(CompilerDriver* driver,
                  dex_cache);
     }
   };
-  context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
+  const uint64_t start_ns = NanoTime();
+  context.ForAllLambda(0, work_items.size(), compile, thread_count);
+  if (driver->GetCompilerOptions().GetDumpTimings() || VLOG_IS_ON(compiler)) {
+    DumpWorkerUtilization(
+        timing_name, work_items.size(), NanoTime() - start_ns, context.GetWorkerBusyTimes());
+  }
 }
 
 void CompilerDriver::Compile(jobject class_loader,
@@ -2648,6 +2827,11 @@ void CompilerDriver::Compile(jobject class_loader,
             : profile_compilation_info->DumpInfo(dex_files));
   }
 
+  if (compiled_method_cache_ != nullptr) {
+    TimingLogger::ScopedTiming t("Prepare compiled method cache", timings);
+    compiled_method_cache_->PrepareForCompilation(this, dex_files);
+  }
+
   for (const DexFile* dex_file : dex_files) {
     CHECK(dex_file != nullptr);
     CompileDexFile(this,
@@ -2665,6 +2849,10 @@ void CompilerDriver::Compile(jobject class_loader,
     Runtime::Current()->ReclaimArenaPoolMemory();
   }
 
+  if (compiled_method_cache_ != nullptr) {
+    VLOG(compiler) << "Reused " << compiled_method_cache_->GetNumberOfReusedMethods()
+                   << " methods from the compiled method cache";
+  }
   VLOG(compiler) << "Compile: " << GetMemoryUsageString(false);
 }
 
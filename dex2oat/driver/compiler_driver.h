@@ -59,6 +59,7 @@ class VerifierDepsTest;
 class ArtField;
 class BitVector;
 class CompiledMethod;
+class CompiledMethodCache;
 class CompilerOptions;
 class DexCompilationUnit;
 class DexFile;
@@ -222,6 +223,15 @@ class CompilerDriver {
     return &compiled_method_storage_;
   }
 
+  // Reuse unchanged methods from, and record compiled methods to, `cache`. May be null.
+  void SetCompiledMethodCache(CompiledMethodCache* cache) {
+    compiled_method_cache_ = cache;
+  }
+
+  CompiledMethodCache* GetCompiledMethodCache() const {
+    return compiled_method_cache_;
+  }
+
  private:
   void LoadImageClasses(TimingLogger* timings, /*inout*/ HashSet<std::string>* image_classes)
       REQUIRES(!Locks::mutator_lock_);
@@ -329,6 +339,8 @@ class CompilerDriver {
 
   CompiledMethodStorage compiled_method_storage_;
 
+  CompiledMethodCache* compiled_method_cache_;
+
   size_t max_arena_alloc_;
 
   friend class CommonCompilerDriverTest;
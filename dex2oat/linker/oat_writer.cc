@@ -484,7 +484,8 @@ OatWriter::OatWriter(const CompilerOptions& compiler_options,
     size_string_bss_mappings_(0u),
     relative_patcher_(nullptr),
     profile_compilation_info_(info),
-    compact_dex_level_(compact_dex_level) {
+    compact_dex_level_(compact_dex_level),
+    release_written_methods_(false) {
   // If we have a profile, always use at least the default compact dex level. The reason behind
   // this is that CompactDex conversion is not more expensive than normal dexlayout.
   if (info != nullptr && compact_dex_level_ == CompactDexLevel::kCompactDexLevelNone) {
@@ -804,6 +805,11 @@ void OatWriter::PrepareLayout(MultiOatRelativePatcher* relative_patcher) {
   oat_size_ = offset;  // .bss does not count towards oat_size_.
   bss_start_ = (bss_size_ != 0u) ? RoundUp(oat_size_, kPageSize) : 0u;
 
+  if (release_written_methods_) {
+    TimingLogger::ScopedTiming split("ReleaseMethodMaps", timings_);
+    ReleaseMethodMaps();
+  }
+
   CHECK_EQ(dex_files_->size(), oat_dex_files_.size());
 
   write_state_ = WriteState::kWriteRoData;
@@ -1728,7 +1734,9 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
 
     // No thread suspension since dex_cache_ that may get invalidated if that occurs.
     ScopedAssertNoThreadSuspension tsc(__FUNCTION__);
-    DCHECK(HasCompiledCode(compiled_method)) << method_ref.PrettyMethod();
+    // The code of a duplicate method may have been released after its first visit.
+    DCHECK(HasCompiledCode(compiled_method) || writer_->release_written_methods_)
+        << method_ref.PrettyMethod();
 
     // TODO: cleanup DCHECK_OFFSET_ to accept file_offset as parameter.
     size_t file_offset = file_offset_;  // Used by DCHECK_OFFSET_ macro.
@@ -1740,6 +1748,7 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
     // Deduplicate code arrays.
     const OatMethodOffsets& method_offsets = oat_class->method_offsets_[method_offsets_index];
     if (method_offsets.code_offset_ > offset_) {
+      DCHECK(HasCompiledCode(compiled_method)) << method_ref.PrettyMethod();
       offset_ = writer_->relative_patcher_->WriteThunks(out, offset_);
       if (offset_ == 0u) {
         ReportWriteFailure("relative call thunk", method_ref);
@@ -1914,6 +1923,11 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
     }
     DCHECK_OFFSET_();
 
+    if (writer_->release_written_methods_) {
+      // The code is in the output, written for this method or for one with the same code.
+      compiled_method->ReleaseCodeAndPatches();
+    }
+
     return true;
   }
 
@@ -2376,6 +2390,26 @@ size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
   return offset;
 }
 
+void OatWriter::ReleaseMethodMaps() {
+  // The stack maps have been copied to `code_info_data_` and the code layout no longer compares
+  // them. Only the full debug info reads them again, mini-debug-info just needs the CFI.
+  const CompilerOptions& compiler_options = GetCompilerOptions();
+  if (ordered_methods_ == nullptr || compiler_options.GetGenerateDebugInfo()) {
+    return;
+  }
+  bool release_cfi = !compiler_options.GenerateAnyDebugInfo();
+  for (const OrderedMethodData& method_data : *ordered_methods_) {
+    method_data.compiled_method->ReleaseVmapTable();
+    if (release_cfi) {
+      method_data.compiled_method->ReleaseCFIInfo();
+    }
+  }
+  // Do not leave dangling pointers to the released stack maps.
+  for (debug::MethodDebugInfo& info : method_info_) {
+    info.code_info = nullptr;
+  }
+}
+
 size_t OatWriter::InitDataBimgRelRoLayout(size_t offset) {
   DCHECK_EQ(data_bimg_rel_ro_size_, 0u);
   if (data_bimg_rel_ro_entries_.empty()) {
@@ -2798,6 +2832,9 @@ size_t OatWriter::WriteMaps(OutputStream* out, size_t file_offset, size_t relati
     relative_offset += code_info_data_.size();
     size_vmap_table_ = code_info_data_.size();
     DCHECK_OFFSET();
+    if (release_written_methods_) {
+      std::vector<uint8_t>().swap(code_info_data_);
+    }
   }
 
   return relative_offset;
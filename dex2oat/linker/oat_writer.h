@@ -243,6 +243,14 @@ class OatWriter {
     return compiler_options_;
   }
 
+  // Release the stack maps, code and linker patches of the compiled methods as soon as they have
+  // been written, instead of keeping them until the compiler driver is destroyed. This bounds the
+  // peak memory of the compilation, as the data is not held together with the image and debug
+  // info written afterwards. The compiled methods have no code after WriteCode().
+  void SetReleaseWrittenMethods(bool release_written_methods) {
+    release_written_methods_ = release_written_methods;
+  }
+
  private:
   class ChecksumUpdatingOutputStream;
   class DexFileSource;
@@ -310,6 +318,7 @@ class OatWriter {
   size_t InitOatCode(size_t offset);
   size_t InitOatCodeDexFiles(size_t offset);
   size_t InitDataBimgRelRoLayout(size_t offset);
+  void ReleaseMethodMaps();
   void InitBssLayout(InstructionSet instruction_set);
 
   size_t WriteClassOffsets(OutputStream* out, size_t file_offset, size_t relative_offset);
@@ -556,6 +565,9 @@ class OatWriter {
   // Compact dex level that is generated.
   CompactDexLevel compact_dex_level_;
 
+  // Whether to release the data of compiled methods once written, see SetReleaseWrittenMethods().
+  bool release_written_methods_;
+
   using OrderedMethodList = std::vector<OrderedMethodData>;
 
   // List of compiled methods, sorted by the order defined in OrderedMethodData.
@@ -481,6 +481,41 @@ class HashSet {
     return const_iterator(this, FindIndex(key, hash));
   }
 
+  // Support for lookups that do not hold the lock serializing modifications of the set.
+  // GetBuckets() returns the bucket array; the owner can publish it with NumBuckets() to such
+  // readers, which search it with FindInBuckets(). The owner must keep the array alive while
+  // readers may use it and must not let the set expand in place, e.g. by moving the elements
+  // to a larger set instead. Each slot is read once, so T must be copyable with a single atomic
+  // read. Readers may or may not see concurrent insertions, and they can miss elements that
+  // erase() moves, which the owner must detect.
+  const T* GetBuckets() const {
+    return data_;
+  }
+
+  template <typename K>
+  static bool FindInBuckets(const T* buckets,
+                            size_t num_buckets,
+                            const K& key,
+                            size_t hash,
+                            /*out*/ T* result) {
+    EmptyFn emptyfn;
+    Pred pred;
+    size_t index = (num_buckets != 0u) ? hash % num_buckets : 0u;
+    // Bound the probe sequence, the array may be modified concurrently.
+    for (size_t i = 0; i != num_buckets; ++i) {
+      T slot = buckets[index];
+      if (emptyfn.IsEmpty(slot)) {
+        return false;
+      }
+      if (pred(slot, key)) {
+        *result = slot;
+        return true;
+      }
+      index = (index + 1u != num_buckets) ? index + 1u : 0u;
+    }
+    return false;
+  }
+
   // Insert an element with hint.
   // Note: The hint is not very useful for a HashSet<> unless there are many hash conflicts
   // and in that case the use of HashSet<> itself should be reconsidered.
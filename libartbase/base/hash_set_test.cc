@@ -335,6 +335,28 @@ TEST_F(HashSetTest, TestLookupByAlternateKeyType) {
   ASSERT_NE(hash_set.end(), hash_set.find(std::forward_list<int>({1, 2, 3, 4})));
 }
 
+TEST_F(HashSetTest, FindInBuckets) {
+  using IntSet = HashSet<int>;
+  IntSet hash_set;
+  std::hash<int> hash;
+  for (int i = 1; i <= 100; ++i) {
+    hash_set.insert(i * 7);
+  }
+  for (int i = 1; i <= 100; ++i) {
+    int result = 0;
+    ASSERT_TRUE(IntSet::FindInBuckets(
+        hash_set.GetBuckets(), hash_set.NumBuckets(), i * 7, hash(i * 7), &result));
+    ASSERT_EQ(i * 7, result);
+  }
+  int result = 0;
+  ASSERT_FALSE(IntSet::FindInBuckets(
+      hash_set.GetBuckets(), hash_set.NumBuckets(), 3, hash(3), &result));
+  // A set without storage has no buckets to search.
+  IntSet empty_set;
+  ASSERT_FALSE(IntSet::FindInBuckets(
+      empty_set.GetBuckets(), empty_set.NumBuckets(), 7, hash(7), &result));
+}
+
 TEST_F(HashSetTest, TestReserve) {
   HashSet<std::string, IsEmptyFnString> hash_set;
   std::vector<size_t> sizes = {1, 10, 25, 55, 128, 1024, 4096};
@@ -27,6 +27,7 @@
 #include <queue>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -53,6 +54,7 @@
 #include "base/string_view_cpp20.h"
 #include "base/systrace.h"
 #include "base/time_utils.h"
+#include "base/timing_logger.h"
 #include "base/unix_file/fd_file.h"
 #include "base/utils.h"
 #include "base/value_object.h"
@@ -144,6 +146,7 @@
 #include "thread-inl.h"
 #include "thread.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "trace.h"
 #include "transaction.h"
 #include "vdex_file.h"
@@ -1466,23 +1469,64 @@ size_t CountInternedStringReferences(gc::space::ImageSpace& space,
   return visitor.GetCount();
 }
 
+// Calls `fn(begin, end)` for disjoint ranges covering [0, count). If the runtime thread pool
+// exists and `count` is at least `min_parallel_count`, the ranges are processed in parallel by
+// the pool workers and the calling thread. Each range is processed by a single thread, so the
+// result does not depend on the number of workers as long as `fn` writes only to the memory of
+// the elements in its range.
+//
+// The calling thread waits for the workers in the native state, so the caller must keep the GC
+// from moving the objects that `fn` uses, see gc::ScopedGCCriticalSection. `fn` runs on other
+// threads and must not use ObjPtr<> or handles created by the calling thread.
+template <typename Fn>
+static void ForEachRangeInParallel(size_t count, size_t min_parallel_count, const Fn& fn)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  Thread* const self = Thread::Current();
+  Runtime::ScopedThreadPoolUsage stpu;
+  ThreadPool* const pool = stpu.GetThreadPool();
+  if (pool == nullptr || count < min_parallel_count) {
+    fn(0u, count);
+    return;
+  }
+  const size_t num_ranges = pool->GetThreadCount() + 1u;
+  const size_t range_size = (count + num_ranges - 1u) / num_ranges;
+  for (size_t begin = 0u; begin != count; ) {
+    size_t end = std::min(begin + range_size, count);
+    pool->AddTask(self, new FunctionTask([&fn, begin, end](Thread* worker) {
+      ScopedObjectAccess soa(worker);
+      fn(begin, end);
+    }));
+    begin = end;
+  }
+  ScopedTrace trace("Waiting for workers");
+  // Go to native since we don't want to suspend while holding the mutator lock.
+  ScopedThreadSuspension sts(self, kNative);
+  pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+}
+
+static size_t GetNumberOfInternedStringReferences(gc::space::ImageSpace* space) {
+  const ImageSection& sro_section =
+      space->GetImageHeader().GetImageStringReferenceOffsetsSection();
+  return sro_section.Size() / sizeof(AppImageReferenceOffsetInfo);
+}
+
+// Visits the string references [begin, end) recorded in the image string reference offsets
+// section and replaces each with the string returned by `visitor`.
 template <typename Visitor>
 static void VisitInternedStringReferences(
     gc::space::ImageSpace* space,
+    size_t begin,
+    size_t end,
     const Visitor& visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
   const uint8_t* target_base = space->Begin();
   const ImageSection& sro_section =
       space->GetImageHeader().GetImageStringReferenceOffsetsSection();
-  const size_t num_string_offsets = sro_section.Size() / sizeof(AppImageReferenceOffsetInfo);
-
-  VLOG(image)
-      << "ClassLinker:AppImage:InternStrings:imageStringReferenceOffsetCount = "
-      << num_string_offsets;
+  DCHECK_LE(end, GetNumberOfInternedStringReferences(space));
 
   const auto* sro_base =
       reinterpret_cast<const AppImageReferenceOffsetInfo*>(target_base + sro_section.Offset());
 
-  for (size_t offset_index = 0; offset_index < num_string_offsets; ++offset_index) {
+  for (size_t offset_index = begin; offset_index < end; ++offset_index) {
     uint32_t base_offset = sro_base[offset_index].first;
 
     uint32_t raw_member_offset = sro_base[offset_index].second;
@@ -1509,6 +1553,17 @@ static void VisitInternedStringReferences(
   }
 }
 
+template <typename Visitor>
+static void VisitInternedStringReferences(
+    gc::space::ImageSpace* space,
+    const Visitor& visitor) REQUIRES_SHARED(Locks::mutator_lock_) {
+  const size_t num_string_offsets = GetNumberOfInternedStringReferences(space);
+  VLOG(image)
+      << "ClassLinker:AppImage:InternStrings:imageStringReferenceOffsetCount = "
+      << num_string_offsets;
+  VisitInternedStringReferences(space, /*begin=*/ 0u, num_string_offsets, visitor);
+}
+
 static void VerifyInternedStringReferences(gc::space::ImageSpace* space)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   InternTable::UnorderedSet image_interns;
@@ -1543,11 +1598,12 @@ class AppImageLoadingHelper {
       ClassLinker* class_linker,
       gc::space::ImageSpace* space,
       Handle<mirror::ClassLoader> class_loader,
-      Handle<mirror::ObjectArray<mirror::DexCache>> dex_caches)
+      Handle<mirror::ObjectArray<mirror::DexCache>> dex_caches,
+      TimingLogger* logger)
       REQUIRES(!Locks::dex_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  static void HandleAppImageStrings(gc::space::ImageSpace* space)
+  static void HandleAppImageStrings(gc::space::ImageSpace* space, TimingLogger* logger)
       REQUIRES_SHARED(Locks::mutator_lock_);
 };
 
@@ -1555,7 +1611,8 @@ void AppImageLoadingHelper::Update(
     ClassLinker* class_linker,
     gc::space::ImageSpace* space,
     Handle<mirror::ClassLoader> class_loader,
-    Handle<mirror::ObjectArray<mirror::DexCache>> dex_caches)
+    Handle<mirror::ObjectArray<mirror::DexCache>> dex_caches,
+    TimingLogger* logger)
     REQUIRES(!Locks::dex_lock_)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   ScopedTrace app_image_timing("AppImage:Updating");
@@ -1572,6 +1629,7 @@ void AppImageLoadingHelper::Update(
   const ImageHeader& header = space->GetImageHeader();
   {
     // Register dex caches with the class loader.
+    TimingLogger::ScopedTiming timing("RegisterDexCaches", logger);
     WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
     for (auto dex_cache : dex_caches.Iterate<mirror::DexCache>()) {
       const DexFile* const dex_file = dex_cache->GetDexFile();
@@ -1584,11 +1642,11 @@ void AppImageLoadingHelper::Update(
   }
 
   if (ClassLinker::kAppImageMayContainStrings) {
-    HandleAppImageStrings(space);
+    HandleAppImageStrings(space, logger);
   }
 
   if (kVerifyArtMethodDeclaringClasses) {
-    ScopedTrace timing("AppImage:VerifyDeclaringClasses");
+    TimingLogger::ScopedTiming timing("AppImage:VerifyDeclaringClasses", logger);
     ReaderMutexLock rmu(self, *Locks::heap_bitmap_lock_);
     gc::accounting::HeapBitmap* live_bitmap = heap->GetLiveBitmap();
     header.VisitPackedArtMethods([&](ArtMethod& method)
@@ -1601,19 +1659,26 @@ void AppImageLoadingHelper::Update(
   }
 }
 
-void AppImageLoadingHelper::HandleAppImageStrings(gc::space::ImageSpace* space) {
+void AppImageLoadingHelper::HandleAppImageStrings(gc::space::ImageSpace* space,
+                                                  TimingLogger* logger) {
   // Iterate over the string reference offsets stored in the image and intern
   // the strings they point to.
   ScopedTrace timing("AppImage:InternString");
 
+  Thread* const self = Thread::Current();
   Runtime* const runtime = Runtime::Current();
   InternTable* const intern_table = runtime->GetInternTable();
+  // The remap below refers to strings outside of the image by raw pointers and runs while the
+  // calling thread waits in the native state, keep the GC from moving them.
+  gc::ScopedGCCriticalSection gcs(self, gc::kGcCauseClassLinker, gc::kCollectorTypeClassLinker);
 
-  // Add the intern table, removing any conflicts. For conflicts, store the new address in a map
-  // for faster lookup.
+  // Add the intern table as an immutable layer. Conflicts are recorded as duplicates that
+  // lookups skip instead of being removed from the mapped table. For conflicts, store the new
+  // address in a map for faster lookup.
   // TODO: Optimize with a bitmap or bloom filter
   SafeMap<mirror::String*, mirror::String*> intern_remap;
-  auto func = [&](InternTable::UnorderedSet& interns)
+  auto func = [&](const InternTable::UnorderedSet& interns,
+                  InternTable::UnorderedSet* duplicates)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(Locks::intern_table_lock_) {
     const size_t non_boot_image_strings = intern_table->CountInterns(
@@ -1623,20 +1688,19 @@ void AppImageLoadingHelper::HandleAppImageStrings(gc::space::ImageSpace* space)
     VLOG(image) << "AppImage:nonBootImageInternStrings = " << non_boot_image_strings;
     // Visit the smaller of the two sets to compute the intersection.
     if (interns.size() < non_boot_image_strings) {
-      for (auto it = interns.begin(); it != interns.end(); ) {
-        ObjPtr<mirror::String> string = it->Read();
+      for (const GcRoot<mirror::String>& root : interns) {
+        ObjPtr<mirror::String> string = root.Read();
         ObjPtr<mirror::String> existing = intern_table->LookupWeakLocked(string);
         if (existing == nullptr) {
           existing = intern_table->LookupStrongLocked(string);
         }
         if (existing != nullptr) {
           intern_remap.Put(string.Ptr(), existing.Ptr());
-          it = interns.erase(it);
-        } else {
-          ++it;
+          duplicates->insert(root);
         }
       }
     } else {
+      // Duplicates of earlier app images are not visited, only the interns they resolve to.
       intern_table->VisitInterns([&](const GcRoot<mirror::String>& root)
           REQUIRES_SHARED(Locks::mutator_lock_)
           REQUIRES(Locks::intern_table_lock_) {
@@ -1644,31 +1708,49 @@ void AppImageLoadingHelper::HandleAppImageStrings(gc::space::ImageSpace* space)
         if (it != interns.end()) {
           ObjPtr<mirror::String> existing = root.Read();
           intern_remap.Put(it->Read(), existing.Ptr());
-          it = interns.erase(it);
+          duplicates->insert(*it);
         }
       }, /*visit_boot_images=*/false, /*visit_non_boot_images=*/true);
     }
     // Consistency check to ensure correctness.
     if (kIsDebugBuild) {
-      for (GcRoot<mirror::String>& root : interns) {
+      for (const GcRoot<mirror::String>& root : interns) {
         ObjPtr<mirror::String> string = root.Read();
-        CHECK(intern_table->LookupWeakLocked(string) == nullptr) << string->ToModifiedUtf8();
-        CHECK(intern_table->LookupStrongLocked(string) == nullptr) << string->ToModifiedUtf8();
+        if (duplicates->find(root) == duplicates->end()) {
+          CHECK(intern_table->LookupWeakLocked(string) == nullptr) << string->ToModifiedUtf8();
+          CHECK(intern_table->LookupStrongLocked(string) == nullptr) << string->ToModifiedUtf8();
+        }
       }
     }
   };
-  intern_table->AddImageStringsToTable(space, func);
+  {
+    // Merging the image interns holds the intern table lock, it is not split across threads.
+    TimingLogger::ScopedTiming timing2("AppImage:MergeInternTable", logger);
+    intern_table->AddAppImageStringsToTable(space, func);
+  }
   if (!intern_remap.empty()) {
-    VLOG(image) << "AppImage:conflictingInternStrings = " << intern_remap.size();
-    VisitInternedStringReferences(
-        space,
-        [&intern_remap](ObjPtr<mirror::String> str) REQUIRES_SHARED(Locks::mutator_lock_) {
-          auto it = intern_remap.find(str.Ptr());
-          if (it != intern_remap.end()) {
-            return ObjPtr<mirror::String>(it->second);
-          }
-          return str;
-        });
+    // Each recorded reference is a distinct field and the remap is read-only, so the
+    // references are split across the thread pool.
+    static constexpr size_t kMinParallelStringReferences = 16 * KB;
+    TimingLogger::ScopedTiming timing2("AppImage:RemapInternStrings", logger);
+    const size_t num_string_offsets = GetNumberOfInternedStringReferences(space);
+    VLOG(image) << "AppImage:conflictingInternStrings = " << intern_remap.size()
+                << " imageStringReferenceOffsetCount = " << num_string_offsets;
+    auto remap = [space, &intern_remap](size_t begin, size_t end)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      VisitInternedStringReferences(
+          space,
+          begin,
+          end,
+          [&intern_remap](ObjPtr<mirror::String> str) REQUIRES_SHARED(Locks::mutator_lock_) {
+            auto it = intern_remap.find(str.Ptr());
+            if (it != intern_remap.end()) {
+              return ObjPtr<mirror::String>(it->second);
+            }
+            return str;
+          });
+    };
+    ForEachRangeInParallel(num_string_offsets, kMinParallelStringReferences, remap);
   }
 }
 
@@ -2033,25 +2115,40 @@ bool ClassLinker::AddImageSpace(
                                     &read_count);
     VLOG(image) << "Adding class table classes took " << PrettyDuration(NanoTime() - start_time2);
   }
+  TimingLogger logger("AppImage:AddImageSpace", /*precise=*/ true, VLOG_IS_ON(image));
   if (app_image) {
-    AppImageLoadingHelper::Update(this, space, class_loader, dex_caches);
+    AppImageLoadingHelper::Update(this, space, class_loader, dex_caches, &logger);
 
     {
-      ScopedTrace trace("AppImage:UpdateClassLoaders");
+      TimingLogger::ScopedTiming timing("AppImage:UpdateClassLoaders", &logger);
       // Update class loader and resolved strings. If added_class_table is false, the resolved
       // strings were forwarded UpdateAppImageClassLoadersAndDexCaches.
-      ObjPtr<mirror::ClassLoader> loader(class_loader.Get());
-      for (const ClassTable::TableSlot& root : temp_set) {
-        // Note: We probably don't need the read barrier unless we copy the app image objects into
-        // the region space.
-        ObjPtr<mirror::Class> klass(root.Read());
-        // Do not update class loader for boot image classes where the app image
-        // class loader is only the initiating loader but not the defining loader.
-        // Avoid read barrier since we are comparing against null.
-        if (klass->GetClassLoader<kDefaultVerifyFlags, kWithoutReadBarrier>() != nullptr) {
-          klass->SetClassLoader(loader);
+      // Each class is in a single slot of the set, so the slots are split across the thread
+      // pool. The class loader is passed by raw pointer and must not move meanwhile.
+      static constexpr size_t kMinParallelClassSlots = 16 * KB;
+      gc::ScopedGCCriticalSection gcs(self,
+                                      gc::kGcCauseClassLinker,
+                                      gc::kCollectorTypeClassLinker);
+      mirror::ClassLoader* const loader = class_loader.Get();
+      const ClassTable::TableSlot* const slots = temp_set.GetBuckets();
+      auto update_class_loaders = [loader, slots](size_t begin, size_t end)
+          REQUIRES_SHARED(Locks::mutator_lock_) {
+        for (size_t i = begin; i != end; ++i) {
+          if (slots[i].IsNull()) {
+            continue;
+          }
+          // Note: We probably don't need the read barrier unless we copy the app image objects
+          // into the region space.
+          ObjPtr<mirror::Class> klass(slots[i].Read());
+          // Do not update class loader for boot image classes where the app image
+          // class loader is only the initiating loader but not the defining loader.
+          // Avoid read barrier since we are comparing against null.
+          if (klass->GetClassLoader<kDefaultVerifyFlags, kWithoutReadBarrier>() != nullptr) {
+            klass->SetClassLoader(loader);
+          }
         }
-      }
+      };
+      ForEachRangeInParallel(temp_set.NumBuckets(), kMinParallelClassSlots, update_class_loaders);
     }
 
     if (kBitstringSubtypeCheckEnabled) {
@@ -2066,7 +2163,7 @@ bool ClassLinker::AddImageSpace(
       // Force every app image class's SubtypeCheck to be at least kIninitialized.
       //
       // See also ImageWriter::FixupClass.
-      ScopedTrace trace("AppImage:RecacluateSubtypeCheckBitstrings");
+      TimingLogger::ScopedTiming timing("AppImage:RecalculateSubtypeCheckBitstrings", &logger);
       MutexLock subtype_check_lock(Thread::Current(), *Locks::subtype_check_lock_);
       for (const ClassTable::TableSlot& root : temp_set) {
         SubtypeCheck<ObjPtr<mirror::Class>>::EnsureInitialized(root.Read());
@@ -2079,6 +2176,8 @@ bool ClassLinker::AddImageSpace(
   }
 
   if (added_class_table) {
+    // Adding the set moves it into the class table, the classes are not inserted one by one.
+    TimingLogger::ScopedTiming timing("AddClassSet", &logger);
     WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
     class_table->AddClassSet(std::move(temp_set));
   }
@@ -2089,6 +2188,9 @@ bool ClassLinker::AddImageSpace(
     ScopedTrace trace("AppImage:Verify");
     VerifyAppImage(header, class_loader, class_table, space);
   }
+  if (app_image && VLOG_IS_ON(image)) {
+    logger.Dump(LOG_STREAM(INFO));
+  }
 
   VLOG(class_linker) << "Adding image space took " << PrettyDuration(NanoTime() - start_time);
   return true;
@@ -2621,6 +2723,21 @@ ClassPathEntry FindInClassPath(const char* descriptor,
   return ClassPathEntry(nullptr, nullptr);
 }
 
+// Returns the sorted descriptor hashes of the classes defined by `dex_files`.
+static std::vector<uint32_t> GetClassDescriptorHashes(
+    const std::vector<const DexFile*>& dex_files) {
+  std::vector<uint32_t> hashes;
+  for (const DexFile* dex_file : dex_files) {
+    for (size_t i = 0; i != dex_file->NumClassDefs(); ++i) {
+      const dex::ClassDef& class_def = dex_file->GetClassDef(i);
+      hashes.push_back(ComputeModifiedUtf8Hash(dex_file->GetClassDescriptor(class_def)));
+    }
+  }
+  std::sort(hashes.begin(), hashes.end());
+  hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+  return hashes;
+}
+
 // Helper macro to make sure each class loader lookup call handles the case the
 // class loader is not recognized, or the lookup threw an exception.
 #define RETURN_IF_UNRECOGNIZED_OR_FOUND_OR_EXCEPTION(call_, result_, thread_) \
@@ -2774,6 +2891,19 @@ bool ClassLinker::FindClassInBootClassLoaderClassPath(Thread* self,
                                                       const char* descriptor,
                                                       size_t hash,
                                                       /*out*/ ObjPtr<mirror::Class>* result) {
+  // Most lookups of app classes miss in the boot class path, skip searching it if no boot class
+  // has the descriptor hash. The boot class path only grows, so its size identifies it.
+  ClassTable* const boot_class_table = ClassTableForClassLoader(nullptr);
+  bool may_define;
+  if (!boot_class_table->LookupClassPathHash(
+          nullptr, boot_class_path_.size(), static_cast<uint32_t>(hash), &may_define)) {
+    boot_class_table->SetClassPathHashes(
+        nullptr, boot_class_path_.size(), GetClassDescriptorHashes(boot_class_path_));
+  } else if (!may_define) {
+    // The boot classloader is always a known lookup.
+    return true;
+  }
+
   ClassPathEntry pair = FindInClassPath(descriptor, hash, boot_class_path_);
   if (pair.second != nullptr) {
     ObjPtr<mirror::Class> klass = LookupClass(self, descriptor, hash, nullptr);
@@ -2807,6 +2937,41 @@ bool ClassLinker::FindClassInBaseDexClassLoaderClassPath(
          IsDelegateLastClassLoader(soa, class_loader))
       << "Unexpected class loader for descriptor " << descriptor;
 
+  // Skip searching the dex files if none of them has a class with the descriptor hash. The
+  // hashes are recorded for the `dexElements` array of the DexPathList, which is replaced
+  // when dex files are added to the class loader.
+  ObjPtr<mirror::Object> dex_path_list =
+      jni::DecodeArtField(WellKnownClasses::dalvik_system_BaseDexClassLoader_pathList)->
+          GetObject(class_loader.Get());
+  ObjPtr<mirror::Object> dex_elements = (dex_path_list != nullptr)
+      ? jni::DecodeArtField(WellKnownClasses::dalvik_system_DexPathList_dexElements)->
+            GetObject(dex_path_list)
+      : nullptr;
+  if (dex_elements != nullptr) {
+    ClassTable* class_table = ClassTableForClassLoader(class_loader.Get());
+    if (class_table == nullptr) {
+      WriterMutexLock mu(soa.Self(), *Locks::classlinker_classes_lock_);
+      class_table = InsertClassTableForClassLoader(class_loader.Get());
+    }
+    size_t num_dex_elements = dex_elements->AsObjectArray<mirror::Object>()->GetLength();
+    bool may_define;
+    if (!class_table->LookupClassPathHash(
+            dex_elements, num_dex_elements, static_cast<uint32_t>(hash), &may_define)) {
+      std::vector<const DexFile*> dex_files;
+      VisitClassLoaderDexFiles(soa,
+                               class_loader,
+                               [&](const DexFile* cp_dex_file) {
+                                 dex_files.push_back(cp_dex_file);
+                                 return true;  // Continue with other dex files.
+                               });
+      class_table->SetClassPathHashes(
+          dex_elements, num_dex_elements, GetClassDescriptorHashes(dex_files));
+    } else if (!may_define) {
+      // A BaseDexClassLoader is always a known lookup.
+      return true;
+    }
+  }
+
   const DexFile* dex_file = nullptr;
   const dex::ClassDef* class_def = nullptr;
   ObjPtr<mirror::Class> ret;
@@ -3021,6 +3186,182 @@ ObjPtr<mirror::Class> ClassLinker::FindClass(Thread* self,
   return result_ptr;
 }
 
+std::vector<std::vector<size_t>> ClassLinker::GetPreloadWaves(
+    Thread* self,
+    const std::vector<std::string>& descriptors,
+    Handle<mirror::ClassLoader> class_loader) {
+  ScopedObjectAccessUnchecked soa(self);
+  const bool is_base_dex_class_loader =
+      class_loader != nullptr &&
+      (IsPathOrDexClassLoader(soa, class_loader) ||
+       IsInMemoryDexClassLoader(soa, class_loader) ||
+       IsDelegateLastClassLoader(soa, class_loader));
+  const size_t num_classes = descriptors.size();
+  std::map<std::string_view, size_t> indexes;
+  for (size_t i = 0; i != num_classes; ++i) {
+    indexes.emplace(descriptors[i], i);
+  }
+  std::vector<std::vector<size_t>> supertypes(num_classes);
+  for (size_t i = 0; i != num_classes; ++i) {
+    const char* descriptor = descriptors[i].c_str();
+    const size_t hash = ComputeModifiedUtf8Hash(descriptor);
+    ClassPathEntry entry = FindInClassPath(descriptor, hash, boot_class_path_);
+    if (entry.second == nullptr && is_base_dex_class_loader) {
+      auto find_class_def = [&](const DexFile* dex_file) REQUIRES_SHARED(Locks::mutator_lock_) {
+        const dex::ClassDef* class_def = OatDexFile::FindClassDef(*dex_file, descriptor, hash);
+        if (class_def != nullptr) {
+          entry = ClassPathEntry(dex_file, class_def);
+          return false;  // Found a class definition, stop visit.
+        }
+        return true;  // Continue with the next DexFile.
+      };
+      VisitClassLoaderDexFiles(soa, class_loader, find_class_def);
+    }
+    if (entry.second == nullptr) {
+      continue;
+    }
+    const DexFile& dex_file = *entry.first;
+    const dex::ClassDef& class_def = *entry.second;
+    auto add_supertype = [&](dex::TypeIndex type_idx) {
+      auto it = indexes.find(dex_file.StringByTypeIdx(type_idx));
+      if (it != indexes.end() && it->second != i) {
+        supertypes[i].push_back(it->second);
+      }
+    };
+    if (class_def.superclass_idx_.IsValid()) {
+      add_supertype(class_def.superclass_idx_);
+    }
+    const dex::TypeList* interfaces = dex_file.GetInterfacesList(class_def);
+    if (interfaces != nullptr) {
+      for (size_t j = 0; j != interfaces->Size(); ++j) {
+        add_supertype(interfaces->GetTypeItem(j).type_idx_);
+      }
+    }
+  }
+
+  // Put each class in the wave after its latest supertype. Class hierarchies are shallow so this
+  // takes few passes, the bound only matters for circular definitions which fail to load anyway.
+  std::vector<size_t> wave_of(num_classes, 0u);
+  bool changed = true;
+  for (size_t pass = 0; changed && pass != num_classes; ++pass) {
+    changed = false;
+    for (size_t i = 0; i != num_classes; ++i) {
+      for (size_t supertype : supertypes[i]) {
+        if (wave_of[i] <= wave_of[supertype]) {
+          wave_of[i] = wave_of[supertype] + 1u;
+          changed = true;
+        }
+      }
+    }
+  }
+  std::vector<std::vector<size_t>> waves;
+  for (size_t i = 0; i != num_classes; ++i) {
+    if (wave_of[i] >= waves.size()) {
+      waves.resize(wave_of[i] + 1u);
+    }
+    waves[wave_of[i]].push_back(i);
+  }
+  return waves;
+}
+
+size_t ClassLinker::PreloadClasses(Thread* self,
+                                   const std::vector<std::string>& descriptors,
+                                   Handle<mirror::ClassLoader> class_loader,
+                                   bool verify) {
+  ScopedTrace trace(__FUNCTION__);
+  // Below this number of classes, starting a temporary thread pool costs more than it saves.
+  static constexpr size_t kMinClassesForTemporaryPool = 64u;
+  enum class PreloadStatus : uint8_t { kPending, kLoaded, kFailed };
+  const size_t num_classes = descriptors.size();
+  const std::vector<std::vector<size_t>> waves = GetPreloadWaves(self, descriptors, class_loader);
+  // Each class is preloaded by a single task, which only writes its own entry.
+  std::vector<PreloadStatus> status(num_classes, PreloadStatus::kPending);
+
+  // Load the class and its supertypes, and verify it. Concurrent definitions of the same class
+  // are handled by the class linker, a thread that needs a class being loaded by another thread
+  // waits for it on the class' ObjectLock.
+  auto preload = [&](Thread* thread, jobject jclass_loader, size_t index) {
+    ScopedObjectAccess soa(thread);
+    StackHandleScope<2> hs(thread);
+    Handle<mirror::ClassLoader> loader = hs.NewHandle(
+        soa.Decode<mirror::ClassLoader>(jclass_loader));
+    Handle<mirror::Class> klass =
+        hs.NewHandle(FindClass(thread, descriptors[index].c_str(), loader));
+    if (klass == nullptr) {
+      thread->ClearException();
+      // Runtime threads cannot call into class loaders implemented in Java, leave the class to
+      // the calling thread.
+      status[index] = thread->IsRuntimeThread() ? PreloadStatus::kPending : PreloadStatus::kFailed;
+      return;
+    }
+    if (verify && !klass->IsVerified() && !klass->IsErroneous()) {
+      VerifyClass(thread, /*verifier_deps=*/ nullptr, klass);
+      if (thread->IsExceptionPending()) {
+        thread->ClearException();
+      }
+    }
+    status[index] = PreloadStatus::kLoaded;
+  };
+
+  JavaVMExt* const vm = self->GetJniEnv()->GetVm();
+  // Create a global ref for `class_loader` because it will be accessed from other threads.
+  jobject jclass_loader = vm->AddGlobalRef(self, class_loader.Get());
+  {
+    Runtime::ScopedThreadPoolUsage stpu;
+    // Go to native since we don't want to suspend while holding the mutator lock.
+    ScopedThreadSuspension sts(self, kNative);
+    ThreadPool* pool = stpu.GetThreadPool();
+    std::unique_ptr<ThreadPool> temporary_pool;
+    const size_t num_cpus = std::thread::hardware_concurrency();
+    if (pool == nullptr && num_cpus > 1u && num_classes >= kMinClassesForTemporaryPool) {
+      // The calling thread works too, see ThreadPool::Wait().
+      temporary_pool.reset(new ThreadPool("Class preloading thread pool", num_cpus - 1u));
+      temporary_pool->StartWorkers(self);
+      pool = temporary_pool.get();
+    }
+    for (const std::vector<size_t>& wave : waves) {
+      if (pool == nullptr || wave.size() == 1u) {
+        for (size_t index : wave) {
+          preload(self, jclass_loader, index);
+        }
+        continue;
+      }
+      for (size_t index : wave) {
+        pool->AddTask(self, new FunctionTask([&preload, jclass_loader, index](Thread* thread) {
+          preload(thread, jclass_loader, index);
+        }));
+      }
+      pool->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+    }
+  }
+  vm->DeleteGlobalRef(self, jclass_loader);
+
+  size_t num_loaded = 0u;
+  for (size_t i = 0; i != num_classes; ++i) {
+    if (status[i] == PreloadStatus::kPending) {
+      ObjPtr<mirror::Class> klass = FindClass(self, descriptors[i].c_str(), class_loader);
+      if (klass == nullptr) {
+        self->ClearException();
+        continue;
+      }
+      if (verify && !klass->IsVerified() && !klass->IsErroneous()) {
+        StackHandleScope<1> hs(self);
+        VerifyClass(self, /*verifier_deps=*/ nullptr, hs.NewHandle(klass));
+        if (self->IsExceptionPending()) {
+          self->ClearException();
+        }
+      }
+      status[i] = PreloadStatus::kLoaded;
+    }
+    if (status[i] == PreloadStatus::kLoaded) {
+      ++num_loaded;
+    }
+  }
+  VLOG(class_linker) << "Preloaded " << num_loaded << " of " << num_classes << " classes in "
+                     << waves.size() << " waves";
+  return num_loaded;
+}
+
 // Helper for maintaining DefineClass counting. We need to notify callbacks when we start/end a
 // define-class and how many recursive DefineClasses we are at in order to allow for doing  things
 // like pausing class definition.
@@ -6014,6 +6355,28 @@ bool ClassLinker::LinkClass(Thread* self,
         }
       }
     }
+    // Otherwise, share the IMT of another class of the class loader with the same entries, which
+    // is common for classes implementing the same interfaces with inherited methods. Only such
+    // IMTs are recorded: an IMT holding a method declared or copied into this class cannot match
+    // the IMT of any other class, and IMTs with conflict methods are not shared as the conflict
+    // methods get updated for their class.
+    ClassTable* const class_table = ClassTableForClassLoader(klass->GetClassLoader());
+    ArtMethod* const unimplemented_method = Runtime::Current()->GetImtUnimplementedMethod();
+    bool shareable_imt = (imt == nullptr && class_table != nullptr);
+    bool has_implemented_entry = false;
+    for (size_t i = 0; i < ImTable::kSize && shareable_imt; ++i) {
+      ArtMethod* const method = imt_data[i];
+      if (method != unimplemented_method) {
+        has_implemented_entry = true;
+        shareable_imt = !method->IsRuntimeMethod() &&
+                        !method->IsCopied() &&
+                        method->GetDeclaringClass() != klass.Get();
+      }
+    }
+    shareable_imt = shareable_imt && has_implemented_entry;
+    if (shareable_imt) {
+      imt = class_table->LookupImt(imt_data, image_pointer_size_);
+    }
     if (imt == nullptr) {
       LinearAlloc* allocator = GetAllocatorForClassLoader(klass->GetClassLoader());
       imt = reinterpret_cast<ImTable*>(
@@ -6022,6 +6385,9 @@ bool ClassLinker::LinkClass(Thread* self,
         return false;
       }
       imt->Populate(imt_data, image_pointer_size_);
+      if (shareable_imt) {
+        class_table->InsertImt(imt_data, imt);
+      }
     }
   }
 
@@ -6460,6 +6826,71 @@ class LinkVirtualHashTable {
 const uint32_t LinkVirtualHashTable::invalid_index_ = std::numeric_limits<uint32_t>::max();
 const uint32_t LinkVirtualHashTable::removed_index_ = std::numeric_limits<uint32_t>::max() - 1;
 
+// Index by name hash of the methods searched for interface method implementations in
+// LinkInterfaceMethods(). Without it, each interface method is searched linearly in the vtable,
+// which is quadratic for large classes implementing many interface methods. Methods with the
+// same name and signature are found from the highest index down, like the linear search does.
+class InterfaceMethodImplementationIndex {
+ public:
+  InterfaceMethodImplementationIndex() : hash_size_(0u) {}
+
+  bool IsBuilt() const {
+    return hash_size_ != 0u;
+  }
+
+  // Indexes the methods `get_method(0)` .. `get_method(num_methods - 1)`. The name hashes of the
+  // first methods may be provided in `name_hashes`.
+  template <typename GetMethod>
+  void Build(size_t num_methods,
+             const GetMethod& get_method,
+             ArrayRef<const uint32_t> name_hashes,
+             PointerSize pointer_size) REQUIRES_SHARED(Locks::mutator_lock_) {
+    hash_size_ = num_methods * 2u + 1u;
+    hash_table_.assign(hash_size_, kInvalidIndex);
+    // Insert from the highest index so that methods with the same name are probed from the
+    // highest index down.
+    for (size_t k = num_methods; k != 0u; ) {
+      --k;
+      uint32_t hash = (k < name_hashes.size())
+          ? name_hashes[k]
+          : ComputeModifiedUtf8Hash(
+                get_method(k)->GetInterfaceMethodIfProxy(pointer_size)->GetName());
+      size_t index = hash % hash_size_;
+      while (hash_table_[index] != kInvalidIndex) {
+        index = (index + 1u != hash_size_) ? index + 1u : 0u;
+      }
+      hash_table_[index] = k;
+    }
+  }
+
+  // Returns the highest index of a method with the same name and signature as the method of
+  // `comparator`, or -1 if there is none.
+  template <typename GetMethod>
+  int32_t Find(MethodNameAndSignatureComparator& comparator,
+               uint32_t hash,
+               const GetMethod& get_method,
+               PointerSize pointer_size) const REQUIRES_SHARED(Locks::mutator_lock_) {
+    DCHECK(IsBuilt());
+    DCHECK_EQ(hash, ComputeModifiedUtf8Hash(comparator.GetName()));
+    for (size_t index = hash % hash_size_;
+         hash_table_[index] != kInvalidIndex;
+         index = (index + 1u != hash_size_) ? index + 1u : 0u) {
+      uint32_t k = hash_table_[index];
+      ArtMethod* method = get_method(k)->GetInterfaceMethodIfProxy(pointer_size);
+      if (comparator.HasSameNameAndSignature(method)) {
+        return static_cast<int32_t>(k);
+      }
+    }
+    return -1;
+  }
+
+ private:
+  static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+  size_t hash_size_;
+  std::vector<uint32_t> hash_table_;
+};
+
 bool ClassLinker::LinkVirtualMethods(
     Thread* self,
     Handle<mirror::Class> klass,
@@ -8178,6 +8609,11 @@ bool ClassLinker::LinkInterfaceMethods(
   }
 
   LinkInterfaceMethodsHelper helper(this, klass, self, runtime);
+  // Indexes of the declared virtual methods and of the vtable, built on first use by an
+  // interface with enough methods to make it pay off.
+  static constexpr size_t kMinComparisonsForIndex = 1024u;
+  InterfaceMethodImplementationIndex virtuals_index;
+  InterfaceMethodImplementationIndex vtable_index;
 
   auto* old_cause = self->StartAssertNoThreadSuspension(
       "Copying ArtMethods for LinkInterfaceMethods");
@@ -8225,6 +8661,20 @@ bool ClassLinker::LinkInterfaceMethods(
         input_vtable_array = vtable;
         input_array_length = input_vtable_array->GetLength();
       }
+      auto get_input_method = [&](size_t k) REQUIRES_SHARED(Locks::mutator_lock_) {
+        return using_virtuals
+            ? &input_virtual_methods[k]
+            : input_vtable_array->GetElementPtrSize<ArtMethod*>(k, image_pointer_size_);
+      };
+      InterfaceMethodImplementationIndex& index = using_virtuals ? virtuals_index : vtable_index;
+      if (!index.IsBuilt() &&
+          num_methods * static_cast<size_t>(input_array_length) >= kMinComparisonsForIndex) {
+        // Vtable entries of java.lang.Object methods have the names of these methods.
+        ArrayRef<const uint32_t> name_hashes = using_virtuals
+            ? ArrayRef<const uint32_t>()
+            : ArrayRef<const uint32_t>(object_virtual_method_hashes_);
+        index.Build(input_array_length, get_input_method, name_hashes, image_pointer_size_);
+      }
 
       // For each method in interface
       for (size_t j = 0; j < num_methods; ++j) {
@@ -8245,44 +8695,48 @@ bool ClassLinker::LinkInterfaceMethods(
         // To find defaults we need to do the same but also go over interfaces.
         bool found_impl = false;
         ArtMethod* vtable_impl = nullptr;
-        for (int32_t k = input_array_length - 1; k >= 0; --k) {
-          ArtMethod* vtable_method = using_virtuals ?
-              &input_virtual_methods[k] :
-              input_vtable_array->GetElementPtrSize<ArtMethod*>(k, image_pointer_size_);
-          ArtMethod* vtable_method_for_name_comparison =
-              vtable_method->GetInterfaceMethodIfProxy(image_pointer_size_);
+        int32_t k = input_array_length - 1;
+        if (index.IsBuilt()) {
+          k = index.Find(interface_name_comparator,
+                         ComputeModifiedUtf8Hash(interface_name_comparator.GetName()),
+                         get_input_method,
+                         image_pointer_size_);
+        } else {
+          while (k >= 0 &&
+                 !interface_name_comparator.HasSameNameAndSignature(
+                     get_input_method(k)->GetInterfaceMethodIfProxy(image_pointer_size_))) {
+            --k;
+          }
+        }
+        if (k >= 0) {
+          ArtMethod* vtable_method = get_input_method(k);
           DCHECK(!vtable_method->IsStatic()) << vtable_method->PrettyMethod();
-          if (interface_name_comparator.HasSameNameAndSignature(
-              vtable_method_for_name_comparison)) {
-            if (!vtable_method->IsAbstract() && !vtable_method->IsPublic()) {
-              // Must do EndAssertNoThreadSuspension before throw since the throw can cause
-              // allocations.
-              self->EndAssertNoThreadSuspension(old_cause);
-              ThrowIllegalAccessError(klass.Get(),
-                  "Method '%s' implementing interface method '%s' is not public",
-                  vtable_method->PrettyMethod().c_str(),
-                  interface_method->PrettyMethod().c_str());
-              return false;
-            } else if (UNLIKELY(vtable_method->IsOverridableByDefaultMethod())) {
-              // We might have a newer, better, default method for this, so we just skip it. If we
-              // are still using this we will select it again when scanning for default methods. To
-              // obviate the need to copy the method again we will make a note that we already found
-              // a default here.
-              // TODO This should be much cleaner.
-              vtable_impl = vtable_method;
-              break;
-            } else {
-              found_impl = true;
-              if (LIKELY(fill_tables)) {
-                method_array->SetElementPtrSize(j, vtable_method, image_pointer_size_);
-                // Place method in imt if entry is empty, place conflict otherwise.
-                SetIMTRef(unimplemented_method,
-                          imt_conflict_method,
-                          vtable_method,
-                          /*out*/out_new_conflict,
-                          /*out*/imt_ptr);
-              }
-              break;
+          if (!vtable_method->IsAbstract() && !vtable_method->IsPublic()) {
+            // Must do EndAssertNoThreadSuspension before throw since the throw can cause
+            // allocations.
+            self->EndAssertNoThreadSuspension(old_cause);
+            ThrowIllegalAccessError(klass.Get(),
+                "Method '%s' implementing interface method '%s' is not public",
+                vtable_method->PrettyMethod().c_str(),
+                interface_method->PrettyMethod().c_str());
+            return false;
+          } else if (UNLIKELY(vtable_method->IsOverridableByDefaultMethod())) {
+            // We might have a newer, better, default method for this, so we just skip it. If we
+            // are still using this we will select it again when scanning for default methods. To
+            // obviate the need to copy the method again we will make a note that we already found
+            // a default here.
+            // TODO This should be much cleaner.
+            vtable_impl = vtable_method;
+          } else {
+            found_impl = true;
+            if (LIKELY(fill_tables)) {
+              method_array->SetElementPtrSize(j, vtable_method, image_pointer_size_);
+              // Place method in imt if entry is empty, place conflict otherwise.
+              SetIMTRef(unimplemented_method,
+                        imt_conflict_method,
+                        vtable_method,
+                        /*out*/out_new_conflict,
+                        /*out*/imt_ptr);
             }
           }
         }
@@ -212,6 +212,18 @@ class ClassLinker {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::dex_lock_);
 
+  // Loads and links the classes with the given descriptors using `class_loader`, and verifies
+  // them if `verify` is true. Independent classes are loaded in parallel on the runtime thread
+  // pool, or on a temporary pool if there is none. A class is only scheduled once the superclass
+  // and interfaces it has in `descriptors` are loaded. Classes that cannot be loaded are skipped
+  // and their exceptions cleared. Returns the number of classes loaded.
+  size_t PreloadClasses(Thread* self,
+                        const std::vector<std::string>& descriptors,
+                        Handle<mirror::ClassLoader> class_loader,
+                        bool verify)
+      REQUIRES_SHARED(Locks::mutator_lock_)
+      REQUIRES(!Locks::dex_lock_);
+
   // Returns true if the class linker is initialized.
   bool IsInitialized() const {
     return init_done_;
@@ -1036,6 +1048,14 @@ class ClassLinker {
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::dex_lock_);
 
+  // Splits the classes to preload into waves, where the superclass and interfaces of a class
+  // that are also being preloaded are in earlier waves. Only used for scheduling, so supertypes
+  // are only looked up in the boot class path and in the dex files of a BaseDexClassLoader.
+  std::vector<std::vector<size_t>> GetPreloadWaves(Thread* self,
+                                                   const std::vector<std::string>& descriptors,
+                                                   Handle<mirror::ClassLoader> class_loader)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Finds the class in the boot class loader.
   // If the class is found the method updates `result`.
   // The method always returns true, to notify to the caller the
@@ -19,12 +19,15 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
+#include "android-base/stringprintf.h"
 #include "android-base/strings.h"
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "base/enums.h"
+#include "base/time_utils.h"
 #include "class_linker-inl.h"
 #include "class_root-inl.h"
 #include "common_runtime_test.h"
@@ -35,6 +38,7 @@
 #include "experimental_flags.h"
 #include "gc/heap.h"
 #include "handle_scope-inl.h"
+#include "imtable-inl.h"
 #include "mirror/array-alloc-inl.h"
 #include "mirror/accessible_object.h"
 #include "mirror/call_site.h"
@@ -1624,6 +1628,84 @@ TEST_F(ClassLinkerTest, CreateWellKnownClassLoader) {
   LoadDexInDelegateLastClassLoader("Interfaces", class_loader_c);
 }
 
+TEST_F(ClassLinkerTest, PreloadClasses) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<1> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader = hs.NewHandle(
+      soa.Decode<mirror::ClassLoader>(LoadDexInPathClassLoader("Interfaces", nullptr)));
+  // Subtypes come first, they are scheduled after their supertypes.
+  std::vector<std::string> descriptors = {
+      "LInterfaces$B;",
+      "LInterfaces$L;",
+      "LInterfaces$A;",
+      "LInterfaces$K;",
+      "LInterfaces$J;",
+      "LInterfaces$I;",
+      "LInterfaces;",
+      "LInterfaces$DoesNotExist;",
+  };
+  EXPECT_EQ(class_linker_->PreloadClasses(soa.Self(), descriptors, class_loader, /*verify=*/ true),
+            descriptors.size() - 1u);
+  EXPECT_FALSE(soa.Self()->IsExceptionPending());
+  for (size_t i = 0; i != descriptors.size() - 1u; ++i) {
+    ObjPtr<mirror::Class> klass =
+        class_linker_->LookupClass(soa.Self(), descriptors[i].c_str(), class_loader.Get());
+    ASSERT_TRUE(klass != nullptr) << descriptors[i];
+    EXPECT_TRUE(klass->IsResolved()) << descriptors[i];
+    EXPECT_TRUE(klass->IsVerified()) << descriptors[i];
+  }
+  EXPECT_TRUE(class_linker_->LookupClass(
+      soa.Self(), descriptors.back().c_str(), class_loader.Get()) == nullptr);
+}
+
+// Links a deep hierarchy of classes with large vtables and many interface methods, and reports
+// how long it takes.
+TEST_F(ClassLinkerTest, LinkDeepHierarchy) {
+  static constexpr size_t kDepth = 16u;
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<3> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(
+      hs.NewHandle(soa.Decode<mirror::ClassLoader>(LoadDex("DeepHierarchy"))));
+  const uint64_t start_ns = NanoTime();
+  Handle<mirror::Class> klass = hs.NewHandle(
+      class_linker_->FindClass(soa.Self(), "LDeepHierarchy$C15;", class_loader));
+  const uint64_t duration_ns = NanoTime() - start_ns;
+  ASSERT_TRUE(klass != nullptr);
+  EXPECT_GT(klass->GetVTableLength(), 1000);
+  LOG(INFO) << "Linked " << kDepth << " classes with up to " << klass->GetVTableLength()
+            << " vtable entries in " << PrettyDuration(duration_ns);
+
+  // Each interface is implemented by the class that declares it.
+  for (size_t i = 0; i != kDepth; ++i) {
+    std::string interface_descriptor = android::base::StringPrintf("LDeepHierarchy$I%zu;", i);
+    std::string class_descriptor = android::base::StringPrintf("LDeepHierarchy$C%zu;", i);
+    ObjPtr<mirror::Class> interface =
+        class_linker_->FindClass(soa.Self(), interface_descriptor.c_str(), class_loader);
+    ASSERT_TRUE(interface != nullptr);
+    for (ArtMethod& method : interface->GetVirtualMethods(kRuntimePointerSize)) {
+      ArtMethod* implementation =
+          klass->FindVirtualMethodForInterface(&method, kRuntimePointerSize);
+      ASSERT_TRUE(implementation != nullptr) << method.PrettyMethod();
+      EXPECT_STREQ(implementation->GetDeclaringClassDescriptor(), class_descriptor.c_str());
+      EXPECT_STREQ(implementation->GetName(), method.GetName());
+    }
+  }
+
+  // Classes implementing an interface with the same inherited methods share their IMT. The
+  // interface methods must not conflict in the IMT, which would prevent the sharing.
+  Handle<mirror::Class> shared_a = hs.NewHandle(
+      class_linker_->FindClass(soa.Self(), "LDeepHierarchy$SharedA;", class_loader));
+  ASSERT_TRUE(shared_a != nullptr);
+  ObjPtr<mirror::Class> shared_b =
+      class_linker_->FindClass(soa.Self(), "LDeepHierarchy$SharedB;", class_loader);
+  ASSERT_TRUE(shared_b != nullptr);
+  ObjPtr<mirror::Class> shared = mirror::Class::GetDirectInterface(soa.Self(), shared_a.Get(), 0);
+  ASSERT_TRUE(shared != nullptr);
+  ASSERT_NE(shared->GetVirtualMethod(0u, kRuntimePointerSize)->GetImtIndex(),
+            shared->GetVirtualMethod(1u, kRuntimePointerSize)->GetImtIndex());
+  EXPECT_EQ(shared_a->GetImt(kRuntimePointerSize), shared_b->GetImt(kRuntimePointerSize));
+}
+
 TEST_F(ClassLinkerTest, PrettyClass) {
   ScopedObjectAccess soa(Thread::Current());
   EXPECT_EQ("null", mirror::Class::PrettyClass(nullptr));
@@ -126,6 +126,13 @@ class ClassLoaderContext {
   std::string EncodeContextForOatFile(const std::string& base_dir,
                                       ClassLoaderContext* stored_context = nullptr) const;
 
+  // Returns true if the checksums of the dex files of the context are known, that is if
+  // OpenDexFiles() succeeded or the context was created from a class loader. The encoding of
+  // the context then identifies the dex files it refers to.
+  bool HasDexFileChecksums() const {
+    return dex_files_state_ == kDexFilesChecksumsRead || dex_files_state_ == kDexFilesOpened;
+  }
+
   // Encodes the context as a string suitable to be passed to dex2oat.
   // This is the same as EncodeContextForOatFile but without adding the checksums
   // and only adding each dex files once (no multidex).
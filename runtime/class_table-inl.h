@@ -77,6 +77,7 @@ void ClassTable::VisitRoots(Visitor& visitor) {
   for (GcRoot<mirror::Object>& root : strong_roots_) {
     visitor.VisitRoot(root.AddressWithoutBarrier());
   }
+  visitor.VisitRootIfNonNull(class_path_.AddressWithoutBarrier());
   for (const OatFile* oat_file : oat_files_) {
     for (GcRoot<mirror::Object>& root : oat_file->GetBssGcRoots()) {
       visitor.VisitRootIfNonNull(root.AddressWithoutBarrier());
@@ -95,6 +96,7 @@ void ClassTable::VisitRoots(const Visitor& visitor) {
   for (GcRoot<mirror::Object>& root : strong_roots_) {
     visitor.VisitRoot(root.AddressWithoutBarrier());
   }
+  visitor.VisitRootIfNonNull(class_path_.AddressWithoutBarrier());
   for (const OatFile* oat_file : oat_files_) {
     for (GcRoot<mirror::Object>& root : oat_file->GetBssGcRoots()) {
       visitor.VisitRootIfNonNull(root.AddressWithoutBarrier());
@@ -16,21 +16,57 @@
 
 #include "class_table-inl.h"
 
+#include <algorithm>
+
 #include "base/stl_util.h"
+#include "imtable-inl.h"
 #include "mirror/class-inl.h"
 #include "oat_file.h"
 
 namespace art {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      lookup_view_(nullptr),
+      removal_count_(0u),
+      class_path_size_(0u),
+      has_class_path_hashes_(false) {
   Runtime* const runtime = Runtime::Current();
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
+  PublishLookupView();
 }
 
 void ClassTable::FreezeSnapshot() {
   WriterMutexLock mu(Thread::Current(), lock_);
   classes_.push_back(ClassSet());
+  PublishLookupView();
+}
+
+void ClassTable::PublishLookupView() {
+  std::unique_ptr<LookupView> view(new LookupView());
+  view->reserve(classes_.size());
+  for (const ClassSet& class_set : classes_) {
+    view->push_back(Buckets{class_set.GetBuckets(), class_set.NumBuckets()});
+  }
+  lookup_view_.store(view.get(), std::memory_order_release);
+  // Lookups may still use the previous views, they are freed with the table.
+  lookup_views_.push_back(std::move(view));
+}
+
+void ClassTable::GrowLatestClassSet() {
+  ClassSet& latest = classes_.back();
+  ClassSet grown(latest.GetMinLoadFactor(), latest.GetMaxLoadFactor());
+  // Grow as much as the set would when expanding on its own, see HashSet::Expand().
+  grown.reserve(static_cast<size_t>(
+      latest.size() * latest.GetMaxLoadFactor() / latest.GetMinLoadFactor()));
+  for (const TableSlot& slot : latest) {
+    grown.insert(slot);
+  }
+  // Lookups may still search the old bucket array, keep it until the table is deleted.
+  retired_class_sets_.push_back(std::move(latest));
+  latest = std::move(grown);
+  PublishLookupView();
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
@@ -56,6 +92,8 @@ ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
   VerifyObject(klass);
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
   // doesn't change.
+  // Make the new class visible to lookups that do not take the lock before publishing it.
+  std::atomic_thread_fence(std::memory_order_release);
   *existing_it = TableSlot(klass, hash);
   return existing;
 }
@@ -101,6 +139,21 @@ size_t ClassTable::NumReferencedNonZygoteClasses() const {
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
+  // Search the published bucket arrays first. A class found there is always a valid result,
+  // but a miss is only trusted if no class was being removed during the search.
+  uint32_t removal_count = removal_count_.load(std::memory_order_acquire);
+  if ((removal_count & 1u) == 0u) {
+    TableSlot slot;
+    for (const Buckets& buckets : *lookup_view_.load(std::memory_order_acquire)) {
+      if (ClassSet::FindInBuckets(buckets.data, buckets.num_buckets, pair, hash, &slot)) {
+        return slot.Read();
+      }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (removal_count_.load(std::memory_order_relaxed) == removal_count) {
+      return nullptr;
+    }
+  }
   ReaderMutexLock mu(Thread::Current(), lock_);
   for (ClassSet& class_set : classes_) {
     auto it = class_set.FindWithHash(pair, hash);
@@ -117,6 +170,12 @@ void ClassTable::Insert(ObjPtr<mirror::Class> klass) {
 
 void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
+  if (classes_.back().size() >= classes_.back().ElementsUntilExpand()) {
+    GrowLatestClassSet();
+  }
+  DCHECK_LT(classes_.back().size(), classes_.back().ElementsUntilExpand());
+  // Make the class visible to lookups that do not take the lock before publishing it.
+  std::atomic_thread_fence(std::memory_order_release);
   classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
 }
 
@@ -126,7 +185,11 @@ bool ClassTable::Remove(const char* descriptor) {
   for (ClassSet& class_set : classes_) {
     auto it = class_set.find(pair);
     if (it != class_set.end()) {
+      // Erasing may move other classes, make concurrent lookups that miss them retry.
+      removal_count_.fetch_add(1u, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
       class_set.erase(it);
+      removal_count_.fetch_add(1u, std::memory_order_release);
       return true;
     }
   }
@@ -168,6 +231,61 @@ bool ClassTable::InsertOatFileLocked(const OatFile* oat_file) {
   return true;
 }
 
+static size_t HashImtEntries(ArtMethod* const* imt_data) {
+  size_t hash = 0u;
+  for (size_t i = 0; i != ImTable::kSize; ++i) {
+    hash = hash * 31u + reinterpret_cast<uintptr_t>(imt_data[i]);
+  }
+  return hash;
+}
+
+ImTable* ClassTable::LookupImt(ArtMethod* const* imt_data, PointerSize pointer_size) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  auto range = shared_imts_.equal_range(HashImtEntries(imt_data));
+  for (auto it = range.first; it != range.second; ++it) {
+    ImTable* imt = it->second;
+    bool equals = true;
+    for (size_t i = 0; equals && i != ImTable::kSize; ++i) {
+      equals = (imt->Get(i, pointer_size) == imt_data[i]);
+    }
+    if (equals) {
+      return imt;
+    }
+  }
+  return nullptr;
+}
+
+void ClassTable::InsertImt(ArtMethod* const* imt_data, ImTable* imt) {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  shared_imts_.emplace(HashImtEntries(imt_data), imt);
+}
+
+bool ClassTable::LookupClassPathHash(ObjPtr<mirror::Object> class_path,
+                                     size_t class_path_size,
+                                     uint32_t hash,
+                                     /*out*/ bool* may_define) {
+  ReaderMutexLock mu(Thread::Current(), lock_);
+  if (!has_class_path_hashes_ ||
+      class_path_.Read() != class_path ||
+      class_path_size_ != class_path_size) {
+    return false;
+  }
+  *may_define =
+      std::binary_search(class_path_hashes_.begin(), class_path_hashes_.end(), hash);
+  return true;
+}
+
+void ClassTable::SetClassPathHashes(ObjPtr<mirror::Object> class_path,
+                                    size_t class_path_size,
+                                    std::vector<uint32_t>&& hashes) {
+  DCHECK(std::is_sorted(hashes.begin(), hashes.end()));
+  WriterMutexLock mu(Thread::Current(), lock_);
+  class_path_ = GcRoot<mirror::Object>(class_path);
+  class_path_size_ = class_path_size;
+  class_path_hashes_ = std::move(hashes);
+  has_class_path_hashes_ = true;
+}
+
 size_t ClassTable::ReadFromMemory(uint8_t* ptr) {
   size_t read_count = 0;
   AddClassSet(ClassSet(ptr, /*make copy*/false, &read_count));
@@ -177,6 +295,7 @@ size_t ClassTable::ReadFromMemory(uint8_t* ptr) {
 void ClassTable::AddClassSet(ClassSet&& set) {
   WriterMutexLock mu(Thread::Current(), lock_);
   classes_.insert(classes_.begin(), std::move(set));
+  PublishLookupView();
 }
 
 void ClassTable::ClearStrongRoots() {
@@ -17,11 +17,15 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "base/allocator.h"
+#include "base/atomic.h"
+#include "base/enums.h"
 #include "base/hash_set.h"
 #include "base/macros.h"
 #include "base/mutex.h"
@@ -30,6 +34,8 @@
 
 namespace art {
 
+class ArtMethod;
+class ImTable;
 class OatFile;
 
 namespace linker {
@@ -199,6 +205,7 @@ class ClassTable {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Return the first class that matches the descriptor. Returns null if there are none.
+  // Does not take the lock unless a class is being removed concurrently.
   ObjPtr<mirror::Class> Lookup(const char* descriptor, size_t hash)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -232,6 +239,37 @@ class ClassTable {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return a recorded IMT with the given entries, or null if there is none. Lets classes of the
+  // class loader that implement the same interface methods the same way share their IMT.
+  ImTable* LookupImt(ArtMethod* const* imt_data, PointerSize pointer_size)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Record `imt`, which holds the entries `imt_data`, for sharing. The IMT must not contain
+  // conflict methods, they are specific to the class and updated when the IMT is used. Neither
+  // should it contain methods of the class itself, which no other class can share.
+  void InsertImt(ArtMethod* const* imt_data, ImTable* imt)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Look up `hash` in the descriptor hashes recorded for the class path `class_path` of
+  // `class_path_size` entries. Returns false if no hashes are recorded for that class path,
+  // otherwise sets `may_define` to whether a class of the class path may have that hash.
+  bool LookupClassPathHash(ObjPtr<mirror::Object> class_path,
+                           size_t class_path_size,
+                           uint32_t hash,
+                           /*out*/ bool* may_define)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Record the sorted descriptor hashes of the classes defined by the class path `class_path`
+  // of `class_path_size` entries, replacing the hashes of any previous class path.
+  void SetClassPathHashes(ObjPtr<mirror::Object> class_path,
+                          size_t class_path_size,
+                          std::vector<uint32_t>&& hashes)
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Read a table from ptr and put it at the front of the class set.
   size_t ReadFromMemory(uint8_t* ptr)
       REQUIRES(!lock_)
@@ -268,6 +306,22 @@ class ClassTable {
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Replace the latest class set with a larger copy instead of letting it expand in place.
+  void GrowLatestClassSet()
+      REQUIRES(lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Publish the bucket arrays of `classes_` for lookups that do not take the lock. Must be
+  // called whenever a class set is added or replaced.
+  void PublishLookupView() REQUIRES(lock_);
+
+  // The bucket array of a class set, as searched by lookups that do not take the lock.
+  struct Buckets {
+    const TableSlot* data;
+    size_t num_buckets;
+  };
+  using LookupView = std::vector<Buckets>;
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
   // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
@@ -279,6 +333,31 @@ class ClassTable {
   // Keep track of oat files with GC roots associated with dex caches in `strong_roots_`.
   std::vector<const OatFile*> oat_files_ GUARDED_BY(lock_);
 
+  // Lookups search the bucket arrays in `lookup_view_` without taking the lock. Bucket arrays
+  // are never freed or moved while the table is alive: the latest class set grows into a new
+  // set and the old one is kept in `retired_class_sets_`, and views are kept in `lookup_views_`.
+  // Removing a class may move other classes within a bucket array, so removals bump
+  // `removal_count_` to an odd value while in progress and to an even value when done, and a
+  // lookup that missed during a removal searches again with the lock held.
+  Atomic<const LookupView*> lookup_view_;
+  std::vector<std::unique_ptr<const LookupView>> lookup_views_ GUARDED_BY(lock_);
+  std::vector<ClassSet> retired_class_sets_ GUARDED_BY(lock_);
+  Atomic<uint32_t> removal_count_;
+
+  // IMTs that classes of the class loader may share, by hash of their entries. Only IMTs made
+  // of inherited implementations are recorded. The IMTs are allocated in the LinearAlloc of the
+  // class loader, which lives as long as the table.
+  std::unordered_multimap<size_t, ImTable*> shared_imts_ GUARDED_BY(lock_);
+
+  // Descriptor hashes of the classes of the class path of the class loader, used to skip
+  // searching its dex files for classes it does not define. The class path is identified by
+  // its `dexElements` array, which DexPathList replaces when dex files are added, and by its
+  // size. The array is held strongly so that a new array cannot reuse its address.
+  GcRoot<mirror::Object> class_path_ GUARDED_BY(lock_);
+  size_t class_path_size_ GUARDED_BY(lock_);
+  std::vector<uint32_t> class_path_hashes_ GUARDED_BY(lock_);
+  bool has_class_path_hashes_ GUARDED_BY(lock_);
+
   friend class linker::ImageWriter;  // for InsertWithoutLocks.
 };
 
@@ -18,15 +18,20 @@
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
+#include "base/atomic.h"
+#include "base/time_utils.h"
 #include "class_linker-inl.h"
 #include "common_runtime_test.h"
 #include "dex/dex_file.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/heap.h"
 #include "handle_scope-inl.h"
+#include "jni/jni_internal.h"
 #include "mirror/class-alloc-inl.h"
 #include "obj_ptr.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
+#include "well_known_classes.h"
 
 namespace art {
 namespace mirror {
@@ -66,6 +71,39 @@ class CollectRootVisitor {
 };
 
 
+class LookupTask final : public Task {
+ public:
+  LookupTask(ClassTable* table,
+             const std::vector<std::string>* descriptors,
+             size_t iterations,
+             Atomic<size_t>* found)
+      : table_(table), descriptors_(descriptors), iterations_(iterations), found_(found) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    size_t found = 0u;
+    for (size_t i = 0; i != iterations_; ++i) {
+      for (const std::string& descriptor : *descriptors_) {
+        const char* d = descriptor.c_str();
+        if (table_->Lookup(d, ComputeModifiedUtf8Hash(d)) != nullptr) {
+          ++found;
+        }
+      }
+    }
+    found_->fetch_add(found, std::memory_order_relaxed);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ClassTable* const table_;
+  const std::vector<std::string>* const descriptors_;
+  const size_t iterations_;
+  Atomic<size_t>* const found_;
+};
+
 class ClassTableTest : public CommonRuntimeTest {};
 
 TEST_F(ClassTableTest, ClassTable) {
@@ -161,5 +199,125 @@ TEST_F(ClassTableTest, ClassTable) {
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
+// Looks up classes from 1 to 64 threads while another thread inserts more classes, growing the
+// class set under the lookups, and reports the lookup throughput.
+TEST_F(ClassTableTest, LookupContention) {
+  static constexpr size_t kMaxClasses = 2000u;
+  static constexpr size_t kIterations = 20u;
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  VariableSizedHandleScope hs(self);
+  std::vector<Handle<mirror::Class>> classes;
+  ClassFuncVisitor visitor([&](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (klass->GetClassLoader() == nullptr) {
+      classes.push_back(hs.NewHandle(klass));
+    }
+    return classes.size() != kMaxClasses;
+  });
+  class_linker_->VisitClasses(&visitor);
+  ASSERT_GE(classes.size(), 2u);
+  // Look up the first half of the classes while inserting the second half.
+  const size_t num_looked_up = classes.size() / 2u;
+  std::vector<std::string> descriptors;
+  for (size_t i = 0; i != num_looked_up; ++i) {
+    std::string temp;
+    descriptors.push_back(classes[i]->GetDescriptor(&temp));
+  }
+
+  for (size_t num_threads : {1u, 2u, 4u, 8u, 16u, 32u, 64u}) {
+    ClassTable table;
+    for (size_t i = 0; i != num_looked_up; ++i) {
+      table.Insert(classes[i].Get());
+    }
+    Atomic<size_t> found(0u);
+    uint64_t duration_ns;
+    {
+      ScopedThreadSuspension sts(self, kSuspended);
+      ThreadPool thread_pool("Class table lookup thread pool", num_threads);
+      for (size_t i = 0; i != num_threads; ++i) {
+        thread_pool.AddTask(self, new LookupTask(&table, &descriptors, kIterations, &found));
+      }
+      uint64_t start_ns = NanoTime();
+      thread_pool.StartWorkers(self);
+      {
+        ScopedObjectAccess soa2(self);
+        for (size_t i = num_looked_up; i != classes.size(); ++i) {
+          table.Insert(classes[i].Get());
+        }
+      }
+      thread_pool.Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+      duration_ns = NanoTime() - start_ns;
+    }
+    const size_t num_lookups = num_threads * kIterations * descriptors.size();
+    EXPECT_EQ(found.load(std::memory_order_relaxed), num_lookups);
+    for (Handle<mirror::Class> klass : classes) {
+      EXPECT_OBJ_PTR_EQ(table.LookupByDescriptor(klass.Get()), klass.Get());
+    }
+    LOG(INFO) << num_threads << " threads: " << num_lookups << " lookups in "
+              << PrettyDuration(duration_ns) << ", "
+              << num_lookups * 1000u / std::max<uint64_t>(duration_ns / 1000u, 1u)
+              << " lookups/ms";
+  }
+}
+
+TEST_F(ClassTableTest, ClassPathHashes) {
+  ScopedObjectAccess soa(Thread::Current());
+  jobject jclass_loader = LoadDex("XandY");
+  VariableSizedHandleScope hs(soa.Self());
+  Handle<ClassLoader> class_loader(hs.NewHandle(soa.Decode<ClassLoader>(jclass_loader)));
+  Handle<mirror::Class> h_X(
+      hs.NewHandle(class_linker_->FindClass(soa.Self(), "LX;", class_loader)));
+  ASSERT_TRUE(h_X != nullptr);
+  Handle<mirror::Object> obj_1 = hs.NewHandle(h_X->AllocObject(soa.Self()));
+  Handle<mirror::Object> obj_2 = hs.NewHandle(h_X->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj_1 != nullptr);
+  ASSERT_TRUE(obj_2 != nullptr);
+
+  ClassTable table;
+  bool may_define = false;
+  EXPECT_FALSE(table.LookupClassPathHash(obj_1.Get(), 1u, 42u, &may_define));
+  table.SetClassPathHashes(obj_1.Get(), 1u, {7u, 42u, 100u});
+  ASSERT_TRUE(table.LookupClassPathHash(obj_1.Get(), 1u, 42u, &may_define));
+  EXPECT_TRUE(may_define);
+  ASSERT_TRUE(table.LookupClassPathHash(obj_1.Get(), 1u, 43u, &may_define));
+  EXPECT_FALSE(may_define);
+  // A different or grown class path does not use the recorded hashes.
+  EXPECT_FALSE(table.LookupClassPathHash(obj_2.Get(), 1u, 42u, &may_define));
+  EXPECT_FALSE(table.LookupClassPathHash(obj_1.Get(), 2u, 42u, &may_define));
+  // The class path is held live by the table.
+  CollectRootVisitor roots;
+  table.VisitRoots(roots);
+  EXPECT_TRUE(roots.roots_.find(obj_1.Get()) != roots.roots_.end());
+  table.SetClassPathHashes(obj_2.Get(), 1u, {43u});
+  EXPECT_FALSE(table.LookupClassPathHash(obj_1.Get(), 1u, 43u, &may_define));
+  ASSERT_TRUE(table.LookupClassPathHash(obj_2.Get(), 1u, 43u, &may_define));
+  EXPECT_TRUE(may_define);
+
+  // A lookup of a missing class records the hashes of the class loader dex files, which
+  // then answer for both the missing and the defined classes.
+  const char* descriptor_missing = "LMissing;";
+  EXPECT_TRUE(class_linker_->FindClass(soa.Self(), descriptor_missing, class_loader) == nullptr);
+  soa.Self()->ClearException();
+  ClassTable* const loader_table = class_linker_->ClassTableForClassLoader(class_loader.Get());
+  ASSERT_TRUE(loader_table != nullptr);
+  ArtField* path_list_field =
+      jni::DecodeArtField(WellKnownClasses::dalvik_system_BaseDexClassLoader_pathList);
+  ArtField* dex_elements_field =
+      jni::DecodeArtField(WellKnownClasses::dalvik_system_DexPathList_dexElements);
+  ObjPtr<mirror::Object> dex_elements =
+      dex_elements_field->GetObject(path_list_field->GetObject(class_loader.Get()));
+  ASSERT_TRUE(dex_elements != nullptr);
+  size_t num_dex_elements = dex_elements->AsObjectArray<mirror::Object>()->GetLength();
+  ASSERT_TRUE(loader_table->LookupClassPathHash(dex_elements,
+                                                num_dex_elements,
+                                                ComputeModifiedUtf8Hash(descriptor_missing),
+                                                &may_define));
+  EXPECT_FALSE(may_define);
+  ASSERT_TRUE(loader_table->LookupClassPathHash(
+      dex_elements, num_dex_elements, ComputeModifiedUtf8Hash("LY;"), &may_define));
+  EXPECT_TRUE(may_define);
+  EXPECT_TRUE(class_linker_->FindClass(soa.Self(), "LY;", class_loader) != nullptr);
+}
+
 }  // namespace mirror
 }  // namespace art
@@ -3496,6 +3496,13 @@ collector::GcType Heap::WaitForGcToCompleteLocked(GcCause cause, Thread* self) {
 void Heap::DumpForSigQuit(std::ostream& os) {
   os << "Heap: " << GetPercentFree() << "% free, " << PrettySize(GetBytesAllocated()) << "/"
      << PrettySize(GetTotalMemory()) << "; " << GetObjectsAllocated() << " objects\n";
+  if (!boot_image_spaces_.empty()) {
+    size_t max_relocated_pages = 0u;
+    for (space::ImageSpace* space : boot_image_spaces_) {
+      max_relocated_pages += space->GetMaxRelocatedPageCount();
+    }
+    os << "Relocated boot image pages (upper bound): " << max_relocated_pages << "\n";
+  }
   DumpGcPerformanceInfo(os);
 }
 
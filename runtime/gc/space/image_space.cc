@@ -60,6 +60,7 @@
 #include "profile/profile_compilation_info.h"
 #include "runtime.h"
 #include "space-inl.h"
+#include "startup_page_map.h"
 
 namespace art {
 namespace gc {
@@ -90,10 +91,42 @@ ImageSpace::ImageSpace(const std::string& image_filename,
       live_bitmap_(std::move(live_bitmap)),
       oat_file_non_owned_(nullptr),
       image_location_(image_location),
-      profile_file_(profile_file) {
+      profile_file_(profile_file),
+      max_relocated_page_count_(0u) {
   DCHECK(live_bitmap_.IsValid());
 }
 
+// Returns an upper bound of the number of pages of an image that relocation writes to, i.e. the
+// number of pages spanned by the objects and the native data referring to objects or code. Pages
+// without any reference to relocate are counted too, even though relocation leaves them clean.
+static size_t EstimateMaxRelocatedPages(const ImageHeader& header) {
+  static constexpr ImageHeader::ImageSections kRelocatedSections[] = {
+      ImageHeader::kSectionObjects,
+      ImageHeader::kSectionArtFields,
+      ImageHeader::kSectionArtMethods,
+      ImageHeader::kSectionRuntimeMethods,
+      ImageHeader::kSectionImTables,
+      ImageHeader::kSectionIMTConflictTables,
+      ImageHeader::kSectionInternedStrings,
+      ImageHeader::kSectionClassTable,
+  };
+  size_t count = 0u;
+  size_t next_page = 0u;  // Do not count pages shared by adjacent sections twice.
+  for (ImageHeader::ImageSections section_type : kRelocatedSections) {
+    const ImageSection& section = header.GetImageSection(section_type);
+    if (section.Size() == 0u) {
+      continue;
+    }
+    size_t begin_page = std::max<size_t>(section.Offset() / kPageSize, next_page);
+    size_t end_page = RoundUp(section.End(), kPageSize) / kPageSize;
+    if (end_page > begin_page) {
+      count += end_page - begin_page;
+      next_page = end_page;
+    }
+  }
+  return count;
+}
+
 static int32_t ChooseRelocationOffsetDelta(int32_t min_delta, int32_t max_delta) {
   CHECK_ALIGNED(min_delta, kPageSize);
   CHECK_ALIGNED(max_delta, kPageSize);
@@ -545,17 +578,21 @@ class ImageSpace::Loader {
                                                      space->GetMemMap()->Begin(),
                                                      space->GetLiveBitmap(),
                                                      oat_file,
+                                                     &space->max_relocated_page_count_,
                                                      error_msg);
         } else {
           result = RelocateInPlace<PointerSize::k32>(boot_image_begin,
                                                      space->GetMemMap()->Begin(),
                                                      space->GetLiveBitmap(),
                                                      oat_file,
+                                                     &space->max_relocated_page_count_,
                                                      error_msg);
         }
         if (!result) {
           return nullptr;
         }
+        VLOG(image) << "Relocated at most " << space->GetMaxRelocatedPageCount()
+                    << " pages of app image " << image_filename;
       }
 
       DCHECK_LE(boot_image_space_dependencies, boot_image_spaces.size());
@@ -929,17 +966,22 @@ class ImageSpace::Loader {
     const bool is_compressed = image_header.HasCompressedBlock();
     if (!is_compressed && allow_direct_mapping) {
       uint8_t* address = (image_reservation != nullptr) ? image_reservation->Begin() : nullptr;
-      return MemMap::MapFileAtAddress(address,
-                                      image_header.GetImageSize(),
-                                      PROT_READ | PROT_WRITE,
-                                      MAP_PRIVATE,
-                                      fd,
-                                      /*start=*/ 0,
-                                      /*low_4gb=*/ true,
-                                      image_filename,
-                                      /*reuse=*/ false,
-                                      image_reservation,
-                                      error_msg);
+      MemMap map = MemMap::MapFileAtAddress(address,
+                                            image_header.GetImageSize(),
+                                            PROT_READ | PROT_WRITE,
+                                            MAP_PRIVATE,
+                                            fd,
+                                            /*start=*/ 0,
+                                            /*low_4gb=*/ true,
+                                            image_filename,
+                                            /*reuse=*/ false,
+                                            image_reservation,
+                                            error_msg);
+      Runtime* runtime = Runtime::Current();
+      if (map.IsValid() && runtime != nullptr && runtime->GetStartupPageMap() != nullptr) {
+        runtime->GetStartupPageMap()->Prefetch(image_filename, map.Begin(), map.End());
+      }
+      return map;
     }
 
     // Reserve output and copy/decompress into it.
@@ -1154,16 +1196,57 @@ class ImageSpace::Loader {
     Forward forward_;
   };
 
+  // Fix up the objects starting in [objects_begin, objects_end) that are not marked in `visited`.
+  // Large images are split into page aligned regions fixed up in parallel by the runtime thread
+  // pool. Objects are fixed up by the region they start in and the words of the visited bitmap
+  // do not straddle page boundaries, so the regions do not write to the same memory.
+  template <typename Forward>
+  static void FixupObjects(uintptr_t objects_begin,
+                           uintptr_t objects_end,
+                           accounting::ContinuousSpaceBitmap* bitmap,
+                           accounting::ContinuousSpaceBitmap* visited,
+                           const Forward& forward) REQUIRES_SHARED(Locks::mutator_lock_) {
+    static constexpr size_t kMinParallelFixupSize = 1 * MB;
+    Thread* const self = Thread::Current();
+    Runtime::ScopedThreadPoolUsage stpu;
+    ThreadPool* const pool = stpu.GetThreadPool();
+    if (pool == nullptr || objects_end - objects_begin < kMinParallelFixupSize) {
+      FixupObjectVisitor<Forward> fixup_object_visitor(visited, forward);
+      bitmap->VisitMarkedRange(objects_begin, objects_end, fixup_object_visitor);
+      return;
+    }
+    const size_t num_regions = pool->GetThreadCount() + 1u;
+    const size_t region_size = (objects_end - objects_begin + num_regions - 1u) / num_regions;
+    for (uintptr_t begin = objects_begin; begin != objects_end; ) {
+      uintptr_t end = std::min(RoundUp(begin + region_size, kPageSize), objects_end);
+      auto function = [=](Thread* worker) {
+        ScopedObjectAccess soa(worker);
+        ScopedDebugDisallowReadBarriers sddrb(worker);
+        FixupObjectVisitor<Forward> fixup_object_visitor(visited, forward);
+        bitmap->VisitMarkedRange(begin, end, fixup_object_visitor);
+      };
+      pool->AddTask(self, new FunctionTask(std::move(function)));
+      begin = end;
+    }
+    ScopedTrace trace("Waiting for workers");
+    // Go to native since we don't want to suspend while holding the mutator lock.
+    ScopedThreadSuspension sts(self, kNative);
+    pool->Wait(self, true, false);
+  }
+
   // Relocate an image space mapped at target_base which possibly used to be at a different base
   // address. In place means modifying a single ImageSpace in place rather than relocating from
-  // one ImageSpace to another.
+  // one ImageSpace to another. Stores an upper bound of the number of pages written to in
+  // `max_relocated_pages`.
   template <PointerSize kPointerSize>
   static bool RelocateInPlace(uint32_t boot_image_begin,
                               uint8_t* target_base,
                               accounting::ContinuousSpaceBitmap* bitmap,
                               const OatFile* app_oat_file,
+                              /*out*/ size_t* max_relocated_pages,
                               std::string* error_msg) {
     DCHECK(error_msg != nullptr);
+    *max_relocated_pages = 0u;
     // Set up sections.
     ImageHeader* image_header = reinterpret_cast<ImageHeader*>(target_base);
     const uint32_t boot_image_size = image_header->GetBootImageSize();
@@ -1284,8 +1367,7 @@ class ImageSpace::Loader {
       // Need to update the image to be at the target base.
       uintptr_t objects_begin = reinterpret_cast<uintptr_t>(target_base + objects_section.Offset());
       uintptr_t objects_end = reinterpret_cast<uintptr_t>(target_base + objects_section.End());
-      FixupObjectVisitor<ForwardObject> fixup_object_visitor(&visited_bitmap, forward_object);
-      bitmap->VisitMarkedRange(objects_begin, objects_end, fixup_object_visitor);
+      FixupObjects(objects_begin, objects_end, bitmap, &visited_bitmap, forward_object);
       // Fixup image roots.
       CHECK(app_image_objects.InSource(reinterpret_cast<uintptr_t>(
           image_header->GetImageRoots<kWithoutReadBarrier>().Ptr())));
@@ -1352,6 +1434,7 @@ class ImageSpace::Loader {
         }, /*is_boot_image=*/ false);
       }
     }
+    *max_relocated_pages = EstimateMaxRelocatedPages(*image_header);
     if (VLOG_IS_ON(image)) {
       logger.Dump(LOG_STREAM(INFO));
     }
@@ -2680,6 +2763,9 @@ class ImageSpace::BootImageLoader {
       DCHECK(!patched_objects->Test(class_roots.Ptr()));
       patched_objects->Set(class_roots.Ptr());
     }
+    for (const std::unique_ptr<ImageSpace>& space : spaces) {
+      space->max_relocated_page_count_ = EstimateMaxRelocatedPages(space->GetImageHeader());
+    }
   }
 
   void MaybeRelocateSpaces(const std::vector<std::unique_ptr<ImageSpace>>& spaces,
@@ -2702,6 +2788,13 @@ class ImageSpace::BootImageLoader {
     } else {
       DoRelocateSpaces<PointerSize::k32>(spaces_ref, base_diff64);
     }
+    if (VLOG_IS_ON(image)) {
+      size_t max_relocated_pages = 0u;
+      for (const std::unique_ptr<ImageSpace>& space : spaces) {
+        max_relocated_pages += space->GetMaxRelocatedPageCount();
+      }
+      LOG(INFO) << "Relocated at most " << max_relocated_pages << " boot image pages";
+    }
   }
 
   void DeduplicateInternedStrings(ArrayRef<const std::unique_ptr<ImageSpace>> spaces,
@@ -193,6 +193,13 @@ class ImageSpace : public MemMapSpace {
     return GetImageHeader().GetComponentCount();
   }
 
+  // Returns an upper bound of the number of pages of the image written when relocating it during
+  // loading, or zero if the image was mapped at the address it was compiled for. This is the
+  // number of pages spanned by the relocated sections, not a count of the pages actually dirtied.
+  size_t GetMaxRelocatedPageCount() const {
+    return max_relocated_page_count_;
+  }
+
   void Dump(std::ostream& os) const override;
 
   // Sweeping image spaces is a NOP.
@@ -315,6 +322,9 @@ class ImageSpace : public MemMapSpace {
   const std::string image_location_;
   const std::string profile_file_;
 
+  // See GetMaxRelocatedPageCount().
+  size_t max_relocated_page_count_;
+
   friend class Space;
 
  private:
@@ -86,6 +86,36 @@ inline void InternTable::AddImageStringsToTable(gc::space::ImageSpace* image_spa
   }
 }
 
+template <typename Visitor>
+inline void InternTable::AddAppImageStringsToTable(gc::space::ImageSpace* image_space,
+                                                   const Visitor& visitor) {
+  DCHECK(image_space != nullptr);
+  const ImageHeader& header = image_space->GetImageHeader();
+  DCHECK(header.IsAppImage());
+  const ImageSection& section = header.GetInternedStringsSection();
+  if (section.Size() > 0) {
+    AddImmutableTableFromMemory(image_space->Begin() + section.Offset(), visitor);
+  }
+}
+
+template <typename Visitor>
+inline size_t InternTable::AddImmutableTableFromMemory(const uint8_t* ptr,
+                                                       const Visitor& visitor) {
+  size_t read_count = 0;
+  UnorderedSet set(ptr, /*make copy*/false, &read_count);
+  UnorderedSet duplicates;
+  {
+    // Hold the lock while calling the visitor so that the duplicates cannot change before the
+    // table is added.
+    MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+    visitor(static_cast<const UnorderedSet&>(set), &duplicates);
+    if (set.size() != duplicates.size()) {
+      strong_interns_.AddImmutableInternStrings(std::move(set), std::move(duplicates));
+    }
+  }
+  return read_count;
+}
+
 template <typename Visitor>
 inline size_t InternTable::AddTableFromMemory(const uint8_t* ptr,
                                               const Visitor& visitor,
@@ -122,6 +152,28 @@ inline void InternTable::Table::AddInternStrings(UnorderedSet&& intern_strings,
                  InternalTable(std::move(intern_strings), is_boot_image));
 }
 
+inline void InternTable::Table::AddImmutableInternStrings(UnorderedSet&& intern_strings,
+                                                          UnorderedSet&& duplicates) {
+  static constexpr bool kCheckDuplicates = kIsDebugBuild;
+  if (kCheckDuplicates) {
+    // Avoid doing read barriers since the space might not yet be added to the heap.
+    for (GcRoot<mirror::String>& string : intern_strings) {
+      const bool is_duplicate = duplicates.find(string) != duplicates.end();
+      CHECK_EQ(Find(string.Read<kWithoutReadBarrier>()) != nullptr, is_duplicate)
+          << string.Read<kWithoutReadBarrier>()->ToModifiedUtf8();
+    }
+  }
+  // Insert at the front since we add new interns into the back. Lookups skip the duplicates,
+  // they find the existing interns in the other tables.
+  tables_.insert(tables_.begin(),
+                 InternalTable(std::move(intern_strings), std::move(duplicates)));
+}
+
+inline bool InternTable::Table::InternalTable::IsDuplicate(
+    const GcRoot<mirror::String>& entry) const {
+  return !duplicates_.empty() && duplicates_.find(entry) != duplicates_.end();
+}
+
 template <typename Visitor>
 inline void InternTable::VisitInterns(const Visitor& visitor,
                                       bool visit_boot_images,
@@ -135,7 +187,9 @@ inline void InternTable::VisitInterns(const Visitor& visitor,
           (visit_non_boot_images && !table.IsBootImage());
       if (visit) {
         for (auto& intern : table.set_) {
-          visitor(intern);
+          if (!table.IsDuplicate(intern)) {
+            visitor(intern);
+          }
         }
       }
     }
@@ -155,7 +209,7 @@ inline size_t InternTable::CountInterns(bool visit_boot_images,
           (visit_boot_images && table.IsBootImage()) ||
           (visit_non_boot_images && !table.IsBootImage());
       if (visit) {
-        ret += table.set_.size();
+        ret += table.Size();
       }
     }
   };
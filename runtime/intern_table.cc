@@ -310,7 +310,7 @@ void InternTable::SweepInternTableWeaks(IsMarkedVisitor* visitor) {
 void InternTable::Table::Remove(ObjPtr<mirror::String> s) {
   for (InternalTable& table : tables_) {
     auto it = table.set_.find(GcRoot<mirror::String>(s));
-    if (it != table.set_.end()) {
+    if (it != table.set_.end() && !table.IsDuplicate(*it)) {
       table.set_.erase(it);
       return;
     }
@@ -318,26 +318,24 @@ void InternTable::Table::Remove(ObjPtr<mirror::String> s) {
   LOG(FATAL) << "Attempting to remove non-interned string " << s->ToModifiedUtf8();
 }
 
-ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s) {
+template <typename Key>
+ObjPtr<mirror::String> InternTable::Table::FindInTables(const Key& key) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
   for (InternalTable& table : tables_) {
-    auto it = table.set_.find(GcRoot<mirror::String>(s));
-    if (it != table.set_.end()) {
+    auto it = table.set_.find(key);
+    if (it != table.set_.end() && !table.IsDuplicate(*it)) {
       return it->Read();
     }
   }
   return nullptr;
 }
 
+ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s) {
+  return FindInTables(GcRoot<mirror::String>(s));
+}
+
 ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string) {
-  Locks::intern_table_lock_->AssertHeld(Thread::Current());
-  for (InternalTable& table : tables_) {
-    auto it = table.set_.find(string);
-    if (it != table.set_.end()) {
-      return it->Read();
-    }
-  }
-  return nullptr;
+  return FindInTables(string);
 }
 
 void InternTable::Table::AddNewTable() {
@@ -199,6 +199,15 @@ class InternTable {
                               const Visitor& visitor)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::intern_table_lock_);
 
+  // Add the intern table of an app image as an immutable layer that stays in the image mapping.
+  // The visitor is called with the image interns and must add those that duplicate existing
+  // interns to the set passed as second argument, lookups then skip them in the image layer.
+  // This avoids removing the duplicates from the mapped table, which would dirty its pages.
+  template <typename Visitor>
+  void AddAppImageStringsToTable(gc::space::ImageSpace* image_space,
+                                 const Visitor& visitor)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!Locks::intern_table_lock_);
+
   // Add a new intern table for inserting to, previous intern tables are still there but no
   // longer inserted into and ideally unmodified. This is done to prevent dirty pages.
   void AddNewTable()
@@ -218,27 +227,37 @@ class InternTable {
       InternalTable() = default;
       InternalTable(UnorderedSet&& set, bool is_boot_image)
           : set_(std::move(set)), is_boot_image_(is_boot_image) {}
+      InternalTable(UnorderedSet&& set, UnorderedSet&& duplicates)
+          : set_(std::move(set)), duplicates_(std::move(duplicates)) {}
 
       bool Empty() const {
-        return set_.empty();
+        return Size() == 0u;
       }
 
       size_t Size() const {
-        return set_.size();
+        return set_.size() - duplicates_.size();
       }
 
       bool IsBootImage() const {
         return is_boot_image_;
       }
 
+      // Returns whether `entry` of `set_` is hidden by an intern of another table.
+      bool IsDuplicate(const GcRoot<mirror::String>& entry) const
+          REQUIRES_SHARED(Locks::mutator_lock_);
+
      private:
       UnorderedSet set_;
+      // Entries of an app image table that duplicate interns of other tables. They are app image
+      // strings and do not move, so they are not visited as roots.
+      UnorderedSet duplicates_;
       bool is_boot_image_ = false;
 
       friend class InternTable;
       friend class linker::ImageWriter;
       friend class Table;
       ART_FRIEND_TEST(InternTableTest, CrossHash);
+      ART_FRIEND_TEST(InternTableTest, ImmutableTable);
     };
 
     Table();
@@ -266,6 +285,11 @@ class InternTable {
         REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
    private:
+    // Returns the entry of `tables_` equal to `key` that is not a duplicate, or null.
+    template <typename Key>
+    ObjPtr<mirror::String> FindInTables(const Key& key)
+        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
 
@@ -273,6 +297,10 @@ class InternTable {
     void AddInternStrings(UnorderedSet&& intern_strings, bool is_boot_image)
         REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+    // Add an app image table to the front of the tables vector, see AddAppImageStringsToTable().
+    void AddImmutableInternStrings(UnorderedSet&& intern_strings, UnorderedSet&& duplicates)
+        REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
     std::vector<InternalTable> tables_;
@@ -280,6 +308,7 @@ class InternTable {
     friend class InternTable;
     friend class linker::ImageWriter;
     ART_FRIEND_TEST(InternTableTest, CrossHash);
+    ART_FRIEND_TEST(InternTableTest, ImmutableTable);
   };
 
   // Insert if non null, otherwise return null. Must be called holding the mutator lock.
@@ -293,6 +322,11 @@ class InternTable {
   size_t AddTableFromMemory(const uint8_t* ptr, const Visitor& visitor, bool is_boot_image)
       REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Add an immutable table from memory to the strong interns, see AddAppImageStringsToTable().
+  template <typename Visitor>
+  size_t AddImmutableTableFromMemory(const uint8_t* ptr, const Visitor& visitor)
+      REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
   ObjPtr<mirror::String> InsertStrong(ObjPtr<mirror::String> s)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
   ObjPtr<mirror::String> InsertWeak(ObjPtr<mirror::String> s)
@@ -340,6 +374,7 @@ class InternTable {
   friend class linker::ImageWriter;
   friend class Transaction;
   ART_FRIEND_TEST(InternTableTest, CrossHash);
+  ART_FRIEND_TEST(InternTableTest, ImmutableTable);
   DISALLOW_COPY_AND_ASSIGN(InternTable);
 };
 
@@ -84,6 +84,60 @@ TEST_F(InternTableTest, CrossHash) {
   }
 }
 
+TEST_F(InternTableTest, ImmutableTable) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable t;
+  StackHandleScope<6> hs(soa.Self());
+  Handle<mirror::String> foo(hs.NewHandle(t.InternStrong(3, "foo")));
+  Handle<mirror::String> bar(hs.NewHandle(t.InternWeak("bar")));
+  Handle<mirror::String> image_foo(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "foo")));
+  Handle<mirror::String> image_bar(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "bar")));
+  Handle<mirror::String> image_baz(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), "baz")));
+  ASSERT_TRUE(foo != nullptr);
+  ASSERT_TRUE(bar != nullptr);
+  ASSERT_TRUE(image_foo != nullptr);
+  ASSERT_TRUE(image_bar != nullptr);
+  ASSERT_TRUE(image_baz != nullptr);
+
+  // Write a table with the three image strings to memory, as the image writer does.
+  InternTable::UnorderedSet image_set;
+  image_set.insert(GcRoot<mirror::String>(image_foo.Get()));
+  image_set.insert(GcRoot<mirror::String>(image_bar.Get()));
+  image_set.insert(GcRoot<mirror::String>(image_baz.Get()));
+  std::vector<uint8_t> data(image_set.WriteToMemory(nullptr));
+  image_set.WriteToMemory(data.data());
+  const std::vector<uint8_t> original_data = data;
+
+  t.AddImmutableTableFromMemory(
+      data.data(),
+      [&](const InternTable::UnorderedSet& interns, InternTable::UnorderedSet* duplicates)
+          REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_) {
+        EXPECT_EQ(3u, interns.size());
+        for (const GcRoot<mirror::String>& root : interns) {
+          if (t.LookupStrongLocked(root.Read()) != nullptr ||
+              t.LookupWeakLocked(root.Read()) != nullptr) {
+            duplicates->insert(root);
+          }
+        }
+      });
+  // The table in memory is not modified.
+  EXPECT_TRUE(data == original_data);
+  // The duplicates resolve to the existing interns, a weak intern is not hidden by the strong
+  // image layer.
+  EXPECT_OBJ_PTR_EQ(foo.Get(), t.LookupStrong(soa.Self(), 3, "foo"));
+  EXPECT_TRUE(t.LookupStrong(soa.Self(), 3, "bar") == nullptr);
+  EXPECT_OBJ_PTR_EQ(bar.Get(), t.LookupWeak(soa.Self(), image_bar.Get()));
+  EXPECT_OBJ_PTR_EQ(image_baz.Get(), t.LookupStrong(soa.Self(), 3, "baz"));
+  EXPECT_EQ(3u, t.Size());
+  // Interning a duplicate strongly promotes the existing weak intern.
+  EXPECT_OBJ_PTR_EQ(bar.Get(), t.InternStrong(image_bar.Get()));
+  EXPECT_OBJ_PTR_EQ(bar.Get(), t.LookupStrong(soa.Self(), 3, "bar"));
+  EXPECT_EQ(3u, t.Size());
+}
+
 class TestPredicate : public IsMarkedVisitor {
  public:
   mirror::Object* IsMarked(mirror::Object* s) override REQUIRES_SHARED(Locks::mutator_lock_) {
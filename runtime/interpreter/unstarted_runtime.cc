@@ -1145,6 +1145,11 @@ void UnstartedRuntime::UnstartedMathPow(
                    shadow_frame->GetVRegDouble(arg_offset + 2)));
 }
 
+void UnstartedRuntime::UnstartedMathSqrt(
+    Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  result->SetD(sqrt(shadow_frame->GetVRegDouble(arg_offset)));
+}
+
 void UnstartedRuntime::UnstartedObjectHashCode(
     Thread* self ATTRIBUTE_UNUSED, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
   mirror::Object* obj = shadow_frame->GetVRegReference(arg_offset);
@@ -1309,6 +1314,28 @@ void UnstartedRuntime::UnstartedStringCharAt(
   result->SetC(string->CharAt(index));
 }
 
+// This allows string concatenation in class initializers, e.g. for constants built from other
+// constants, during compilation.
+void UnstartedRuntime::UnstartedStringConcat(
+    Thread* self, ShadowFrame* shadow_frame, JValue* result, size_t arg_offset) {
+  StackHandleScope<2> hs(self);
+  Handle<mirror::String> string_this =
+      hs.NewHandle(shadow_frame->GetVRegReference(arg_offset)->AsString());
+  ObjPtr<mirror::Object> arg = shadow_frame->GetVRegReference(arg_offset + 1);
+  if (arg == nullptr) {
+    AbortTransactionOrFail(self, "String.concat with null argument");
+    return;
+  }
+  Handle<mirror::String> string_arg = hs.NewHandle(arg->AsString());
+  if (string_arg->GetLength() == 0) {
+    result->SetL(string_this.Get());
+  } else if (string_this->GetLength() == 0) {
+    result->SetL(string_arg.Get());
+  } else {
+    result->SetL(mirror::String::DoConcat(self, string_this, string_arg));
+  }
+}
+
 // This allows creating String objects with replaced characters during compilation.
 // String.doReplace(char, char) is called from String.replace(char, char) when there is a match.
 void UnstartedRuntime::UnstartedStringDoReplace(
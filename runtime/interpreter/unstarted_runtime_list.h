@@ -50,6 +50,7 @@
   V(MathSin, "Ljava/lang/Math;", "sin", "(D)D") \
   V(MathCos, "Ljava/lang/Math;", "cos", "(D)D") \
   V(MathPow, "Ljava/lang/Math;", "pow", "(DD)D") \
+  V(MathSqrt, "Ljava/lang/Math;", "sqrt", "(D)D") \
   V(ObjectHashCode, "Ljava/lang/Object;", "hashCode", "()I") \
   V(DoubleDoubleToRawLongBits, "Ljava/lang/Double;", "doubleToRawLongBits", "(D)J") \
   V(MemoryPeekByte, "Llibcore/io/Memory;", "peekByte", "(J)B") \
@@ -63,6 +64,7 @@
   V(RuntimeAvailableProcessors, "Ljava/lang/Runtime;", "availableProcessors", "()I") \
   V(StringGetCharsNoCheck, "Ljava/lang/String;", "getCharsNoCheck", "(II[CI)V") \
   V(StringCharAt, "Ljava/lang/String;", "charAt", "(I)C") \
+  V(StringConcat, "Ljava/lang/String;", "concat", "(Ljava/lang/String;)Ljava/lang/String;") \
   V(StringDoReplace, "Ljava/lang/String;", "doReplace", "(CC)Ljava/lang/String;") \
   V(StringFactoryNewStringFromChars, "Ljava/lang/StringFactory;", "newStringFromChars", "(II[C)Ljava/lang/String;") \
   V(StringFactoryNewStringFromString, "Ljava/lang/StringFactory;", "newStringFromString", "(Ljava/lang/String;)Ljava/lang/String;") \
@@ -391,6 +391,33 @@ TEST_F(UnstartedRuntimeTest, StringCharAt) {
   }
 }
 
+TEST_F(UnstartedRuntimeTest, StringConcat) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<3> hs(self);
+  Handle<mirror::String> abc = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "abc"));
+  Handle<mirror::String> def = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, "def"));
+  Handle<mirror::String> empty = hs.NewHandle(mirror::String::AllocFromModifiedUtf8(self, ""));
+
+  JValue result;
+  UniqueDeoptShadowFramePtr tmp = CreateShadowFrame(10, nullptr, nullptr, 0);
+
+  tmp->SetVRegReference(0, abc.Get());
+  tmp->SetVRegReference(1, def.Get());
+  UnstartedStringConcat(self, tmp.get(), &result, 0);
+  ASSERT_TRUE(result.GetL() != nullptr);
+  EXPECT_EQ("abcdef", result.GetL()->AsString()->ToModifiedUtf8());
+
+  // Concatenating an empty string returns the other string.
+  tmp->SetVRegReference(1, empty.Get());
+  UnstartedStringConcat(self, tmp.get(), &result, 0);
+  EXPECT_OBJ_PTR_EQ(abc.Get(), result.GetL());
+  tmp->SetVRegReference(0, empty.Get());
+  tmp->SetVRegReference(1, def.Get());
+  UnstartedStringConcat(self, tmp.get(), &result, 0);
+  EXPECT_OBJ_PTR_EQ(def.Get(), result.GetL());
+}
+
 TEST_F(UnstartedRuntimeTest, StringInit) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
@@ -872,6 +899,26 @@ TEST_F(UnstartedRuntimeTest, Pow) {
   EXPECT_EQ(UINT64_C(0x3f8c5c51326aa7ee), lresult);
 }
 
+TEST_F(UnstartedRuntimeTest, Sqrt) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+
+  UniqueDeoptShadowFramePtr tmp = CreateShadowFrame(10, nullptr, nullptr, 0);
+
+  constexpr double test_pairs[][2] = {
+      { 0.0, 0.0 },
+      { 1.0, 1.0 },
+      { 2.25, 1.5 },
+      { 1e300, 1e150 },
+  };
+  for (const double (&pair)[2] : test_pairs) {
+    tmp->SetVRegDouble(0, pair[0]);
+    JValue result;
+    UnstartedMathSqrt(self, tmp.get(), &result, 0);
+    EXPECT_EQ(pair[1], result.GetD());
+  }
+}
+
 TEST_F(UnstartedRuntimeTest, IsAnonymousClass) {
   Thread* self = Thread::Current();
   ScopedObjectAccess soa(self);
@@ -19,6 +19,7 @@
 
 #include <vector>
 
+#include "arch/instruction_set.h"
 #include "base/macros.h"
 #include "base/value_object.h"
 #include "gc_root.h"
@@ -59,6 +60,51 @@ class InlineCache {
   DISALLOW_COPY_AND_ASSIGN(InlineCache);
 };
 
+// Structure to store the number of times a conditional branch was taken and not taken.
+// The counters saturate at the maximum value of uint16_t.
+class BranchCache {
+ public:
+  // Returns whether baseline JIT code for `isa` updates the branch caches. Other
+  // instruction sets do not need to allocate them or materialize branch conditions.
+  static constexpr bool IsRecordedBy(InstructionSet isa) {
+    return isa == InstructionSet::kArm64 || isa == InstructionSet::kX86_64;
+  }
+
+  // The compiled code indexes the counters by the value of the condition (0 or 1).
+  static constexpr MemberOffset FalseOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, false_));
+  }
+
+  static constexpr MemberOffset TrueOffset() {
+    return MemberOffset(OFFSETOF_MEMBER(BranchCache, true_));
+  }
+
+  uint32_t GetDexPc() const {
+    return dex_pc_;
+  }
+
+  uint16_t GetFalse() const {
+    return false_;
+  }
+
+  uint16_t GetTrue() const {
+    return true_;
+  }
+
+  uint32_t GetExecutionCount() const {
+    return static_cast<uint32_t>(false_) + static_cast<uint32_t>(true_);
+  }
+
+ private:
+  uint32_t dex_pc_;
+  uint16_t false_;
+  uint16_t true_;
+
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(BranchCache);
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
@@ -82,6 +128,18 @@ class ProfilingInfo {
 
   InlineCache* GetInlineCache(uint32_t dex_pc);
 
+  // Returns the branch cache for the conditional branch at `dex_pc`, or null if
+  // the branch is not profiled.
+  BranchCache* GetBranchCache(uint32_t dex_pc);
+
+  // Returns the number of bytes needed for a ProfilingInfo with the given number
+  // of inline and branch caches.
+  static size_t ComputeSize(uint32_t number_of_inline_caches, uint32_t number_of_branch_caches) {
+    return sizeof(ProfilingInfo) +
+        number_of_inline_caches * sizeof(InlineCache) +
+        number_of_branch_caches * sizeof(BranchCache);
+  }
+
   // Increments the number of times this method is currently being inlined.
   // Returns whether it was successful, that is it could increment without
   // overflowing.
@@ -115,7 +173,14 @@ class ProfilingInfo {
   }
 
  private:
-  ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
+  ProfilingInfo(ArtMethod* method,
+                const std::vector<uint32_t>& inline_cache_entries,
+                const std::vector<uint32_t>& branch_cache_entries);
+
+  // The branch caches are allocated right after the inline caches.
+  BranchCache* GetBranchCaches() {
+    return reinterpret_cast<BranchCache*>(&cache_[number_of_inline_caches_]);
+  }
 
   // Hotness count for methods compiled with the JIT baseline compiler. Once
   // a threshold is hit (currentily the maximum value of uint16_t), we will
@@ -130,11 +195,15 @@ class ProfilingInfo {
   // Number of instructions we are profiling in the ArtMethod.
   const uint32_t number_of_inline_caches_;
 
+  // Number of conditional branches we are profiling in the ArtMethod.
+  const uint32_t number_of_branch_caches_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
-  // Dynamically allocated array of size `number_of_inline_caches_`.
+  // Dynamically allocated array of size `number_of_inline_caches_`, followed
+  // by an array of `number_of_branch_caches_` BranchCache entries.
   InlineCache cache_[0];
 
   friend class jit::JitCodeCache;
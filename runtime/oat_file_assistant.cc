@@ -43,6 +43,7 @@
 #include "gc/space/image_space.h"
 #include "image.h"
 #include "oat.h"
+#include "oat_file_manager.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "vdex_file.h"
@@ -772,11 +773,28 @@ OatFileAssistant::OatStatus OatFileAssistant::OatFileInfo::Status() {
   ScopedTrace trace("Status");
   if (!status_attempted_) {
     status_attempted_ = true;
+    // Stamp the files before and after opening them, and only use a cached status if they
+    // did not change in between.
+    std::string file_stamps = load_attempted_ ? std::string() : GetFileStamps();
     const OatFile* file = GetFile();
     if (file == nullptr) {
       status_ = kOatCannotOpen;
     } else {
-      status_ = oat_file_assistant_->GivenOatFileStatus(*file);
+      std::string cache_key;
+      if (!file_stamps.empty() && file_stamps == GetFileStamps()) {
+        cache_key = oat_file_assistant_->GetStatusCacheKey(file_stamps);
+      }
+      int cached_status;
+      if (!cache_key.empty() &&
+          Runtime::Current()->GetOatFileManager().LookupOatFileStatus(cache_key,
+                                                                      &cached_status)) {
+        status_ = static_cast<OatStatus>(cached_status);
+      } else {
+        status_ = oat_file_assistant_->GivenOatFileStatus(*file);
+        if (!cache_key.empty()) {
+          Runtime::Current()->GetOatFileManager().RecordOatFileStatus(cache_key, status_);
+        }
+      }
       VLOG(oat) << file->GetLocation() << " is " << status_
           << " with filter " << file->GetCompilerFilter();
     }
@@ -915,6 +933,56 @@ bool OatFileAssistant::OatFileInfo::CompilerFilterIsOkay(
     CompilerFilter::IsAsGoodAs(current, target);
 }
 
+// Returns the stat data identifying the current version of the file at `filename`, or an
+// empty string if the file cannot be stat'ed.
+static std::string GetFileStamp(const std::string& filename) {
+  struct stat st;
+  if (TEMP_FAILURE_RETRY(stat(filename.c_str(), &st)) != 0) {
+    return std::string();
+  }
+  std::ostringstream stamp;
+  stamp << filename << '@' << st.st_dev << ':' << st.st_ino << ':' << st.st_size << ':'
+        << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec << ':'
+        << st.st_ctim.tv_sec << '.' << st.st_ctim.tv_nsec;
+  return stamp.str();
+}
+
+std::string OatFileAssistant::OatFileInfo::GetFileStamps() {
+  ClassLoaderContext* context = oat_file_assistant_->context_;
+  if (!filename_provided_ ||
+      use_fd_ ||
+      Runtime::Current() == nullptr ||
+      (context != nullptr && !context->HasDexFileChecksums())) {
+    return std::string();
+  }
+  std::vector<std::string> filenames = { filename_, oat_file_assistant_->dex_location_ };
+  if (!android::base::EndsWith(filename_, kVdexExtension)) {
+    filenames.push_back(GetVdexFilename(filename_));
+  }
+  std::string file_stamps;
+  for (const std::string& filename : filenames) {
+    std::string file_stamp = GetFileStamp(filename);
+    if (file_stamp.empty()) {
+      return std::string();
+    }
+    file_stamps += file_stamp + ';';
+  }
+  return file_stamps;
+}
+
+std::string OatFileAssistant::GetStatusCacheKey(const std::string& file_stamps) {
+  // The status also depends on the boot class path and the runtime options, which do not
+  // change during the lifetime of the OatFileManager holding the cache.
+  std::ostringstream key;
+  key << file_stamps
+      << isa_ << ';'
+      << only_load_trusted_executable_ << ';'
+      << (context_ != nullptr
+              ? context_->EncodeContextForOatFile(android::base::Dirname(dex_location_))
+              : std::string());
+  return key.str();
+}
+
 bool OatFileAssistant::ClassLoaderContextIsOkay(const OatFile& oat_file) const {
   if (oat_file.IsBackedByVdexOnly()) {
     // Only a vdex file, we don't depend on the class loader context.
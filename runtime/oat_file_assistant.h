@@ -347,6 +347,11 @@ class OatFileAssistant {
     // compiler filter.
     bool CompilerFilterIsOkay(CompilerFilter::Filter target, bool profile_changed, bool downgrade);
 
+    // Returns the stat data of the oat, vdex and dex files, which identifies the versions of
+    // the files a status is computed for. Returns an empty string if the status of this file
+    // should not be cached by OatFileManager.
+    std::string GetFileStamps();
+
     // Release the loaded oat file.
     // Returns null if the oat file hasn't been loaded.
     //
@@ -409,6 +414,10 @@ class OatFileAssistant {
   // dex_location_ dex file.
   const std::vector<uint32_t>* GetRequiredDexChecksums();
 
+  // Returns the key under which OatFileManager caches the status of the oat file with the
+  // given file stamps, see OatFileInfo::GetFileStamps().
+  std::string GetStatusCacheKey(const std::string& file_stamps);
+
   // Validates the boot class path checksum of an OatFile.
   bool ValidateBootClassPathChecksums(const OatFile& oat_file);
 
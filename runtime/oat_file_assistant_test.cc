@@ -830,6 +830,45 @@ TEST_F(OatFileAssistantTest, VdexDexOutOfDate) {
       GetDexOptNeeded(&oat_file_assistant, CompilerFilter::kSpeed));
 }
 
+// Case: We load the same up to date ODEX file with several OatFileAssistants.
+// Expect: The status computed by the first one is reused until the dex file changes.
+TEST_F(OatFileAssistantTest, OdexStatusCached) {
+  std::string dex_location = GetScratchDir() + "/OdexStatusCached.jar";
+  std::string odex_location = GetOdexDir() + "/OdexStatusCached.odex";
+  Copy(GetDexSrc1(), dex_location);
+  GenerateOdexForTest(dex_location, odex_location, CompilerFilter::kSpeed);
+
+  OatFileManager& oat_file_manager = Runtime::Current()->GetOatFileManager();
+  size_t hits = oat_file_manager.GetOatFileStatusCacheHits();
+  {
+    OatFileAssistant oat_file_assistant(dex_location.c_str(),
+                                        kRuntimeISA,
+                                        default_context_.get(),
+                                        /*load_executable=*/ false);
+    EXPECT_EQ(OatFileAssistant::kOatUpToDate, oat_file_assistant.OdexFileStatus());
+  }
+  EXPECT_EQ(hits, oat_file_manager.GetOatFileStatusCacheHits());
+  {
+    OatFileAssistant oat_file_assistant(dex_location.c_str(),
+                                        kRuntimeISA,
+                                        default_context_.get(),
+                                        /*load_executable=*/ false);
+    EXPECT_EQ(OatFileAssistant::kOatUpToDate, oat_file_assistant.OdexFileStatus());
+  }
+  EXPECT_EQ(hits + 1u, oat_file_manager.GetOatFileStatusCacheHits());
+
+  // Replacing the dex file invalidates the cached status.
+  Copy(GetDexSrc2(), dex_location);
+  {
+    OatFileAssistant oat_file_assistant(dex_location.c_str(),
+                                        kRuntimeISA,
+                                        default_context_.get(),
+                                        /*load_executable=*/ false);
+    EXPECT_EQ(OatFileAssistant::kOatDexOutOfDate, oat_file_assistant.OdexFileStatus());
+  }
+  EXPECT_EQ(hits + 1u, oat_file_manager.GetOatFileStatusCacheHits());
+}
+
 // Case: We have a MultiDEX (ODEX) VDEX file where the non-main multidex entry
 // is out of date and there is no corresponding ODEX file.
 TEST_F(OatFileAssistantTest, VdexMultiDexNonMainOutOfDate) {
@@ -141,8 +141,20 @@ std::vector<const OatFile*> OatFileManager::GetBootOatFiles() const {
   return oat_files;
 }
 
+std::vector<const OatFile*> OatFileManager::GetOatFiles() const {
+  ReaderMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+  std::vector<const OatFile*> oat_files;
+  oat_files.reserve(oat_files_.size());
+  for (const std::unique_ptr<const OatFile>& oat_file : oat_files_) {
+    oat_files.push_back(oat_file.get());
+  }
+  return oat_files;
+}
+
 OatFileManager::OatFileManager()
-    : only_use_system_oat_files_(false) {}
+    : oat_file_status_cache_hits_(0u),
+      oat_file_status_cache_misses_(0u),
+      only_use_system_oat_files_(false) {}
 
 OatFileManager::~OatFileManager() {
   // Explicitly clear oat_files_ since the OatFile destructor calls back into OatFileManager for
@@ -831,6 +843,30 @@ void OatFileManager::DumpForSigQuit(std::ostream& os) {
     }
     os << oat_file->GetLocation() << ": " << oat_file->GetCompilerFilter() << "\n";
   }
+  os << "Oat file status cache: " << oat_file_status_cache_.size() << " entries, "
+     << GetOatFileStatusCacheHits() << " hits, "
+     << GetOatFileStatusCacheMisses() << " misses\n";
+}
+
+bool OatFileManager::LookupOatFileStatus(const std::string& key, /*out*/ int* status) {
+  ReaderMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+  auto it = oat_file_status_cache_.find(key);
+  if (it == oat_file_status_cache_.end()) {
+    oat_file_status_cache_misses_.fetch_add(1u, std::memory_order_relaxed);
+    return false;
+  }
+  oat_file_status_cache_hits_.fetch_add(1u, std::memory_order_relaxed);
+  *status = it->second;
+  return true;
+}
+
+void OatFileManager::RecordOatFileStatus(const std::string& key, int status) {
+  WriterMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+  if (oat_file_status_cache_.size() >= kMaxOatFileStatusCacheSize) {
+    // Statuses of replaced files are never looked up again, start over rather than track them.
+    oat_file_status_cache_.clear();
+  }
+  oat_file_status_cache_[key] = status;
 }
 
 }  // namespace art
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_OAT_FILE_MANAGER_H_
 #define ART_RUNTIME_OAT_FILE_MANAGER_H_
 
+#include <atomic>
 #include <memory>
 #include <set>
 #include <string>
@@ -71,6 +72,9 @@ class OatFileManager {
   // Returns the boot image oat files.
   std::vector<const OatFile*> GetBootOatFiles() const;
 
+  // Returns all registered oat files.
+  std::vector<const OatFile*> GetOatFiles() const REQUIRES(!Locks::oat_file_manager_lock_);
+
   // Returns the oat files for the images, registers the oat files.
   // Takes ownership of the imagespace's underlying oat files.
   std::vector<const OatFile*> RegisterImageOatFiles(
@@ -118,6 +122,25 @@ class OatFileManager {
 
   void DumpForSigQuit(std::ostream& os);
 
+  // Returns true and sets `status` if an OatFileAssistant::OatStatus was recorded for `key`.
+  // OatFileAssistant records the status of the oat files it validates, so that loading the
+  // same dex location with the same class loader context again does not repeat the dex
+  // checksum, boot class path and class loader context checks. The key includes the stat
+  // data of the files involved, so replacing any of them invalidates the status.
+  bool LookupOatFileStatus(const std::string& key, /*out*/ int* status)
+      REQUIRES(!Locks::oat_file_manager_lock_);
+
+  void RecordOatFileStatus(const std::string& key, int status)
+      REQUIRES(!Locks::oat_file_manager_lock_);
+
+  size_t GetOatFileStatusCacheHits() const {
+    return oat_file_status_cache_hits_.load(std::memory_order_relaxed);
+  }
+
+  size_t GetOatFileStatusCacheMisses() const {
+    return oat_file_status_cache_misses_.load(std::memory_order_relaxed);
+  }
+
   void SetOnlyUseTrustedOatFiles();
 
   // Spawn a background thread which verifies all classes in the given dex files.
@@ -154,6 +177,13 @@ class OatFileManager {
 
   std::set<std::unique_ptr<const OatFile>> oat_files_ GUARDED_BY(Locks::oat_file_manager_lock_);
 
+  // Statuses recorded by OatFileAssistant, see LookupOatFileStatus(). Cleared when full.
+  static constexpr size_t kMaxOatFileStatusCacheSize = 256u;
+  std::unordered_map<std::string, int> oat_file_status_cache_
+      GUARDED_BY(Locks::oat_file_manager_lock_);
+  std::atomic<size_t> oat_file_status_cache_hits_;
+  std::atomic<size_t> oat_file_status_cache_misses_;
+
   // Only use the compiled code in an OAT file when the file is on /system. If the OAT file
   // is not on /system, don't load it "executable".
   bool only_use_system_oat_files_;
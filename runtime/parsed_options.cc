@@ -243,6 +243,12 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XMadviseWillNeedArtFileSize:_")
           .WithType<unsigned int>()
           .IntoKey(M::MadviseWillNeedArtFileSize)
+      .Define("-XStartupPageMap:_")
+          .WithType<std::string>()
+          .IntoKey(M::StartupPageMap)
+      .Define("-Xpreloaded-classes:_")
+          .WithType<std::string>()
+          .IntoKey(M::PreloadedClasses)
       .Define("-Xusejit:_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
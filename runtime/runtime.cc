@@ -39,6 +39,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "android-base/file.h"
 #include "android-base/strings.h"
 
 #include "aot_class_linker.h"
@@ -74,6 +75,7 @@
 #include "compiler_callbacks.h"
 #include "debugger.h"
 #include "dex/art_dex_file_loader.h"
+#include "dex/descriptors_names.h"
 #include "dex/dex_file_loader.h"
 #include "elf_file.h"
 #include "entrypoints/runtime_asm_entrypoints.h"
@@ -164,6 +166,7 @@
 #include "sigchain.h"
 #include "signal_catcher.h"
 #include "signal_set.h"
+#include "startup_page_map.h"
 #include "thread.h"
 #include "thread_list.h"
 #include "ti/agent.h"
@@ -862,6 +865,35 @@ void Runtime::RunRootClinits(Thread* self) {
   }
 }
 
+// Loads, links and verifies the boot classes listed in `filename`, which has the binary name of
+// one class per line, e.g. "java.util.HashMap$Node". The classes are loaded in parallel with
+// ClassLinker::PreloadClasses(). This uses the same list format as the framework's class
+// preloading, which then only has to initialize the classes.
+static void PreloadBootClasses(Thread* self,
+                               ClassLinker* class_linker,
+                               const std::string& filename) {
+  ScopedTrace trace(__FUNCTION__);
+  std::string content;
+  if (!android::base::ReadFileToString(filename, &content)) {
+    PLOG(WARNING) << "Failed to read preloaded classes from " << filename;
+    return;
+  }
+  std::vector<std::string> descriptors;
+  for (const std::string& line : android::base::Split(content, "\n")) {
+    std::string name = android::base::Trim(line);
+    if (!name.empty() && name[0] != '#') {
+      descriptors.push_back(DotToDescriptor(name.c_str()));
+    }
+  }
+  ScopedObjectAccess soa(self);
+  size_t num_loaded = class_linker->PreloadClasses(self,
+                                                   descriptors,
+                                                   ScopedNullHandle<mirror::ClassLoader>(),
+                                                   /*verify=*/ true);
+  VLOG(startup) << "Preloaded " << num_loaded << " of " << descriptors.size()
+                << " classes from " << filename;
+}
+
 bool Runtime::Start() {
   VLOG(startup) << "Runtime::Start entering";
 
@@ -948,6 +980,10 @@ bool Runtime::Start() {
 
   system_class_loader_ = CreateSystemClassLoader(this);
 
+  if (is_zygote_ && !preloaded_classes_file_.empty()) {
+    PreloadBootClasses(self, class_linker_, preloaded_classes_file_);
+  }
+
   if (!is_zygote_) {
     if (is_native_bridge_loaded_) {
       PreInitializeNativeBridge(".");
@@ -1533,6 +1569,16 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   madvise_willneed_vdex_filesize_ = runtime_options.GetOrDefault(Opt::MadviseWillNeedVdexFileSize);
   madvise_willneed_odex_filesize_ = runtime_options.GetOrDefault(Opt::MadviseWillNeedOdexFileSize);
   madvise_willneed_art_filesize_ = runtime_options.GetOrDefault(Opt::MadviseWillNeedArtFileSize);
+  startup_page_map_file_ = runtime_options.GetOrDefault(Opt::StartupPageMap);
+  if (!startup_page_map_file_.empty()) {
+    // Load the page map before mapping the boot image so that it is prefetched too.
+    startup_page_map_.reset(new StartupPageMap());
+    std::string error_msg;
+    if (!startup_page_map_->Load(startup_page_map_file_, &error_msg)) {
+      VLOG(startup) << "No startup page map loaded: " << error_msg;
+    }
+  }
+  preloaded_classes_file_ = runtime_options.GetOrDefault(Opt::PreloadedClasses);
 
   jni_ids_indirection_ = runtime_options.GetOrDefault(Opt::OpaqueJniIds);
   automatically_set_jni_ids_indirection_ =
@@ -2232,6 +2278,9 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   }
   DumpDeoptimizations(os);
   TrackedAllocators::Dump(os);
+  if (startup_page_map_ != nullptr) {
+    startup_page_map_->DumpForSigQuit(os);
+  }
   GetMetrics()->DumpForSigQuit(os);
   os << "\n";
 
@@ -3194,6 +3243,19 @@ class Runtime::NotifyStartupCompletedTask : public gc::HeapTask {
       ScopedTrace trace2("Delete thread pool");
       runtime->DeleteThreadPool();
     }
+
+    StartupPageMap* startup_page_map = runtime->GetStartupPageMap();
+    if (startup_page_map != nullptr) {
+      bool changed;
+      {
+        ScopedObjectAccess soa(self);
+        changed = startup_page_map->RecordStartupPages(runtime);
+      }
+      std::string error_msg;
+      if (changed && !startup_page_map->Save(runtime->startup_page_map_file_, &error_msg)) {
+        LOG(WARNING) << "Failed to save startup page map: " << error_msg;
+      }
+    }
   }
 };
 
@@ -3283,6 +3345,11 @@ void Runtime::MadviseFileForRange(size_t madvise_size_limit_bytes,
   // Ideal blockTransferSize for madvising files (128KiB)
   static constexpr size_t kIdealIoTransferSizeBytes = 128*1024;
 
+  StartupPageMap* startup_page_map = Runtime::Current()->GetStartupPageMap();
+  if (startup_page_map != nullptr) {
+    startup_page_map->Prefetch(file_name, map_begin, map_end);
+  }
+
   size_t target_size_bytes = std::min<size_t>(map_size_bytes, madvise_size_limit_bytes);
 
   if (target_size_bytes > 0) {
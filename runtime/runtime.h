@@ -107,6 +107,7 @@ struct RuntimeArgumentMap;
 class RuntimeCallbacks;
 class SignalCatcher;
 class StackOverflowHandler;
+class StartupPageMap;
 class SuspensionHandler;
 class ThreadList;
 class ThreadPool;
@@ -924,6 +925,12 @@ class Runtime {
     return madvise_willneed_art_filesize_;
   }
 
+  // Returns the pages to prefetch when mapping oat, vdex and art files, or null if
+  // `-XStartupPageMap` was not specified.
+  StartupPageMap* GetStartupPageMap() const {
+    return startup_page_map_.get();
+  }
+
   const std::string& GetJdwpOptions() {
     return jdwp_options_;
   }
@@ -1025,6 +1032,8 @@ class Runtime {
 
   void RequestMetricsReport(bool synchronous = true);
 
+  // Advises the kernel to read the first `madvise_size_limit_bytes` of a file mapping, and the
+  // pages recorded for it in the startup page map.
   static void MadviseFileForRange(size_t madvise_size_limit_bytes,
                                   size_t map_size_bytes,
                                   const uint8_t* map_begin,
@@ -1337,6 +1346,15 @@ class Runtime {
   // A 0 for this will turn off madvising to MADV_WILLNEED
   size_t madvise_willneed_art_filesize_;
 
+  // Pages of oat, vdex and art files used during startup, loaded from and saved to
+  // `startup_page_map_file_`.
+  std::string startup_page_map_file_;
+  std::unique_ptr<StartupPageMap> startup_page_map_;
+
+  // Classes the zygote loads, links and verifies in parallel during Start(), so that its
+  // Java preloading only needs to initialize them. Empty if there is no such list.
+  std::string preloaded_classes_file_;
+
   // Whether the application should run in safe mode, that is, interpreter only.
   bool safe_mode_;
 
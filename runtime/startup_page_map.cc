@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_page_map.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <ostream>
+
+#include "android-base/file.h"
+#include "android-base/stringprintf.h"
+#include "android-base/unique_fd.h"
+
+#include "base/bit_utils.h"
+#include "base/casts.h"
+#include "base/globals.h"
+#include "base/leb128.h"
+#include "base/logging.h"
+#include "base/mem_map.h"
+#include "base/systrace.h"
+#include "gc/heap.h"
+#include "gc/space/image_space.h"
+#include "oat_file.h"
+#include "oat_file_manager.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+#include "vdex_file.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+static constexpr uint8_t kStartupPageMapMagic[] = { 's', 'p', 'm', '\n', '0', '0', '1', '\0' };
+
+// Upper bound for the number of pages of a single mapping, to reject corrupt files.
+static constexpr uint32_t kMaxMappingPages = 1u << 20;
+
+StartupPageMap::StartupPageMap()
+    : lock_("startup page map lock", LockLevel::kGenericBottomLock),
+      prefetched_pages_(0u),
+      startup_major_faults_(-1) {}
+
+bool StartupPageMap::Load(const std::string& filename, /*out*/ std::string* error_msg) {
+  std::string data;
+  if (!android::base::ReadFileToString(filename, &data)) {
+    *error_msg = StringPrintf("Failed to read %s: %s", filename.c_str(), strerror(errno));
+    return false;
+  }
+  const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data.data());
+  const uint8_t* const end = ptr + data.size();
+  if (data.size() < sizeof(kStartupPageMapMagic) ||
+      memcmp(ptr, kStartupPageMapMagic, sizeof(kStartupPageMapMagic)) != 0) {
+    *error_msg = "Invalid startup page map header in " + filename;
+    return false;
+  }
+  ptr += sizeof(kStartupPageMapMagic);
+
+  std::map<std::string, Entry> entries;
+  auto decode = [&](uint32_t* value) { return DecodeUnsignedLeb128Checked(&ptr, end, value); };
+  uint32_t num_entries;
+  if (!decode(&num_entries)) {
+    *error_msg = "Truncated startup page map " + filename;
+    return false;
+  }
+  for (uint32_t i = 0; i != num_entries; ++i) {
+    uint32_t name_size;
+    uint32_t map_size;
+    uint32_t num_ranges;
+    if (!decode(&name_size) ||
+        static_cast<size_t>(end - ptr) < name_size) {
+      *error_msg = "Truncated startup page map " + filename;
+      return false;
+    }
+    std::string name(reinterpret_cast<const char*>(ptr), name_size);
+    ptr += name_size;
+    if (!decode(&map_size) || !decode(&num_ranges)) {
+      *error_msg = "Truncated startup page map " + filename;
+      return false;
+    }
+    Entry entry;
+    entry.map_size = map_size;
+    // Ranges are stored as the distance from the end of the previous range and the length.
+    uint32_t next_page = 0u;
+    for (uint32_t j = 0; j != num_ranges; ++j) {
+      uint32_t gap;
+      uint32_t num_pages;
+      if (!decode(&gap) || !decode(&num_pages)) {
+        *error_msg = "Truncated startup page map " + filename;
+        return false;
+      }
+      if (num_pages == 0u ||
+          gap > kMaxMappingPages - next_page ||
+          num_pages > kMaxMappingPages - next_page - gap) {
+        *error_msg = "Invalid page range in startup page map " + filename;
+        return false;
+      }
+      entry.page_ranges.emplace_back(next_page + gap, num_pages);
+      next_page += gap + num_pages;
+    }
+    entries.emplace(std::move(name), std::move(entry));
+  }
+  if (ptr != end) {
+    *error_msg = "Unexpected data at the end of startup page map " + filename;
+    return false;
+  }
+
+  MutexLock mu(Thread::Current(), lock_);
+  entries_ = std::move(entries);
+  return true;
+}
+
+bool StartupPageMap::Save(const std::string& filename, /*out*/ std::string* error_msg) const {
+  std::vector<uint8_t> data(std::begin(kStartupPageMapMagic), std::end(kStartupPageMapMagic));
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    EncodeUnsignedLeb128(&data, dchecked_integral_cast<uint32_t>(entries_.size()));
+    for (const auto& [name, entry] : entries_) {
+      EncodeUnsignedLeb128(&data, dchecked_integral_cast<uint32_t>(name.size()));
+      data.insert(data.end(), name.begin(), name.end());
+      EncodeUnsignedLeb128(&data, dchecked_integral_cast<uint32_t>(entry.map_size));
+      EncodeUnsignedLeb128(&data, dchecked_integral_cast<uint32_t>(entry.page_ranges.size()));
+      uint32_t next_page = 0u;
+      for (const std::pair<uint32_t, uint32_t>& range : entry.page_ranges) {
+        EncodeUnsignedLeb128(&data, range.first - next_page);
+        EncodeUnsignedLeb128(&data, range.second);
+        next_page = range.first + range.second;
+      }
+    }
+  }
+
+  // Write to a temporary file and rename it so that a concurrent start never reads a
+  // partially written map. The pid keeps processes saving at the same time apart.
+  std::string temp_filename = StringPrintf("%s.%d.tmp", filename.c_str(), getpid());
+  if (!android::base::WriteStringToFile(
+          std::string(reinterpret_cast<const char*>(data.data()), data.size()), temp_filename)) {
+    *error_msg = StringPrintf("Failed to write %s: %s", temp_filename.c_str(), strerror(errno));
+    return false;
+  }
+  if (rename(temp_filename.c_str(), filename.c_str()) != 0) {
+    *error_msg = StringPrintf("Failed to rename %s: %s", temp_filename.c_str(), strerror(errno));
+    unlink(temp_filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+size_t StartupPageMap::Prefetch(const std::string& name, const uint8_t* begin, const uint8_t* end) {
+  if (!IsAligned<kPageSize>(begin)) {
+    return 0u;
+  }
+  const size_t map_size = end - begin;
+  std::vector<std::pair<uint32_t, uint32_t>> page_ranges;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    auto it = entries_.find(name);
+    if (it == entries_.end() || it->second.map_size != map_size) {
+      return 0u;
+    }
+    page_ranges = it->second.page_ranges;
+  }
+
+  ScopedTrace trace("Prefetching startup pages of " + name);
+  const size_t num_map_pages = RoundUp(map_size, kPageSize) / kPageSize;
+  size_t num_prefetched_pages = 0u;
+  for (const std::pair<uint32_t, uint32_t>& range : page_ranges) {
+    if (range.first >= num_map_pages) {
+      break;
+    }
+    size_t num_pages = std::min<size_t>(range.second, num_map_pages - range.first);
+    void* addr = const_cast<uint8_t*>(begin) + range.first * kPageSize;
+    if (madvise(addr, num_pages * kPageSize, MADV_WILLNEED) != 0) {
+      PLOG(WARNING) << "Failed to madvise startup pages of " << name;
+      break;
+    }
+    num_prefetched_pages += num_pages;
+  }
+  prefetched_pages_.fetch_add(num_prefetched_pages, std::memory_order_relaxed);
+  return num_prefetched_pages;
+}
+
+bool StartupPageMap::RecordResidentPages(const std::string& name,
+                                         const uint8_t* begin,
+                                         const uint8_t* end) {
+  const size_t map_size = end - begin;
+  const size_t num_map_pages = RoundUp(map_size, kPageSize) / kPageSize;
+  if (name.empty() ||
+      !IsAligned<kPageSize>(begin) ||
+      num_map_pages == 0u ||
+      num_map_pages >= kMaxMappingPages) {
+    return false;
+  }
+
+  // Use the present bit of the pagemap rather than mincore(), which reports pages in the page
+  // cache, no matter which process read them or whether they were only prefetched. See
+  // https://www.kernel.org/doc/Documentation/vm/pagemap.txt
+  android::base::unique_fd pagemap(open("/proc/self/pagemap", O_RDONLY | O_CLOEXEC));
+  if (pagemap.get() == -1) {
+    PLOG(WARNING) << "Failed to open /proc/self/pagemap";
+    return false;
+  }
+  std::vector<uint64_t> page_flags(num_map_pages);
+  const size_t pagemap_size = num_map_pages * sizeof(uint64_t);
+  const off_t pagemap_offset = (reinterpret_cast<uintptr_t>(begin) / kPageSize) * sizeof(uint64_t);
+  if (!android::base::ReadFullyAtOffset(
+          pagemap.get(), page_flags.data(), pagemap_size, pagemap_offset)) {
+    PLOG(WARNING) << "Failed to query resident pages of " << name;
+    return false;
+  }
+  //  * Bit  63    page present
+  auto is_present = [&](size_t page) { return (page_flags[page] & (UINT64_C(1) << 63)) != 0u; };
+  Entry entry;
+  entry.map_size = map_size;
+  for (size_t page = 0u; page != num_map_pages; ) {
+    if (!is_present(page)) {
+      ++page;
+      continue;
+    }
+    size_t first_page = page;
+    while (page != num_map_pages && is_present(page)) {
+      ++page;
+    }
+    entry.page_ranges.emplace_back(first_page, page - first_page);
+  }
+
+  MutexLock mu(Thread::Current(), lock_);
+  auto it = entries_.find(name);
+  if (it != entries_.end() &&
+      it->second.map_size == entry.map_size &&
+      it->second.page_ranges == entry.page_ranges) {
+    return false;
+  }
+  entries_.insert_or_assign(name, std::move(entry));
+  return true;
+}
+
+bool StartupPageMap::RecordStartupPages(Runtime* runtime) {
+  ScopedTrace trace("Recording startup pages");
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    startup_major_faults_.store(usage.ru_majflt, std::memory_order_relaxed);
+  }
+  bool changed = false;
+  for (const OatFile* oat_file : runtime->GetOatFileManager().GetOatFiles()) {
+    changed |= RecordResidentPages(oat_file->GetLocation(), oat_file->Begin(), oat_file->End());
+    const VdexFile* vdex_file = oat_file->GetVdexFile();
+    if (vdex_file != nullptr) {
+      changed |= RecordResidentPages(vdex_file->GetName(), vdex_file->Begin(), vdex_file->End());
+    }
+  }
+  for (gc::space::ContinuousSpace* space : runtime->GetHeap()->GetContinuousSpaces()) {
+    // Compressed images are decompressed into anonymous memory, do not record them.
+    if (space->IsImageSpace() &&
+        !space->AsImageSpace()->GetImageHeader().HasCompressedBlock()) {
+      const MemMap* map = space->GetMemMap();
+      changed |= RecordResidentPages(map->GetName(), map->Begin(), map->End());
+    }
+  }
+  return changed;
+}
+
+void StartupPageMap::DumpForSigQuit(std::ostream& os) const {
+  os << "Startup page map: " << GetNumberOfPrefetchedPages() << " pages prefetched";
+  int64_t major_faults = startup_major_faults_.load(std::memory_order_relaxed);
+  if (major_faults >= 0) {
+    os << ", " << major_faults << " major page faults until startup completed";
+  }
+  os << "\n";
+}
+
+}  // namespace art
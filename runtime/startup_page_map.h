@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_STARTUP_PAGE_MAP_H_
+#define ART_RUNTIME_STARTUP_PAGE_MAP_H_
+
+#include <atomic>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+class Runtime;
+
+// Pages of the oat, vdex and art files used during startup, see `-XStartupPageMap:<file>`.
+//
+// When startup completes, the runtime records which pages of its file mappings this process
+// has mapped in, and on the next start it asks the kernel to read exactly these pages as soon
+// as each file is mapped, instead of taking a page fault for each of them. MADV_WILLNEED only
+// starts the reads, so the prefetching does not block the thread mapping the file.
+//
+// Mappings are identified by file name and size. They are recorded again on every start, which
+// keeps the map up to date as the startup path changes. This is correct for prefetched mappings
+// too, as MADV_WILLNEED brings pages into the page cache without mapping them in the process.
+class StartupPageMap {
+ public:
+  StartupPageMap();
+
+  // Reads the page map from `filename`. Returns false and leaves the map empty if the file
+  // does not exist or is invalid.
+  bool Load(const std::string& filename, /*out*/ std::string* error_msg) REQUIRES(!lock_);
+
+  // Writes the page map to `filename`.
+  bool Save(const std::string& filename, /*out*/ std::string* error_msg) const REQUIRES(!lock_);
+
+  // Asks the kernel to read the pages recorded for the mapping of `name` at [begin, end).
+  // Returns the number of pages advised.
+  size_t Prefetch(const std::string& name, const uint8_t* begin, const uint8_t* end)
+      REQUIRES(!lock_);
+
+  // Records the pages of the mapping of `name` at [begin, end) that are present in the page
+  // table of this process. Returns true if the map changed.
+  bool RecordResidentPages(const std::string& name, const uint8_t* begin, const uint8_t* end)
+      REQUIRES(!lock_);
+
+  // Records the present pages of the oat, vdex and image files of `runtime`.
+  bool RecordStartupPages(Runtime* runtime)
+      REQUIRES(!lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  size_t GetNumberOfPrefetchedPages() const {
+    return prefetched_pages_.load(std::memory_order_relaxed);
+  }
+
+  // Prints the number of prefetched pages and the number of major page faults the process took
+  // until startup completed, to compare starts with and without a page map.
+  void DumpForSigQuit(std::ostream& os) const;
+
+ private:
+  struct Entry {
+    size_t map_size;
+    // Sorted, non-adjacent ranges of pages as (first page, number of pages).
+    std::vector<std::pair<uint32_t, uint32_t>> page_ranges;
+  };
+
+  mutable Mutex lock_;
+  std::map<std::string, Entry> entries_ GUARDED_BY(lock_);
+
+  std::atomic<size_t> prefetched_pages_;
+  // Major page faults when recording the startup pages, or -1 if not recorded yet.
+  std::atomic<int64_t> startup_major_faults_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupPageMap);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_STARTUP_PAGE_MAP_H_
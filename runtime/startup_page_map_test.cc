@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_page_map.h"
+
+#include <sys/mman.h>
+
+#include "android-base/file.h"
+
+#include "base/common_art_test.h"
+#include "base/globals.h"
+#include "base/mem_map.h"
+
+namespace art {
+
+class StartupPageMapTest : public CommonArtTest {};
+
+TEST_F(StartupPageMapTest, RecordSaveLoadAndPrefetch) {
+  std::string error_msg;
+  MemMap map = MemMap::MapAnonymous("startup page map test",
+                                    8 * kPageSize,
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ false,
+                                    &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  // Touch pages 1, 2 and 5, the others are never faulted in.
+  map.Begin()[1 * kPageSize] = 1u;
+  map.Begin()[2 * kPageSize] = 1u;
+  map.Begin()[5 * kPageSize] = 1u;
+
+  StartupPageMap page_map;
+  EXPECT_TRUE(page_map.RecordResidentPages("test", map.Begin(), map.End()));
+  // Recording the same pages again does not change the map.
+  EXPECT_FALSE(page_map.RecordResidentPages("test", map.Begin(), map.End()));
+  ScratchFile file;
+  ASSERT_TRUE(page_map.Save(file.GetFilename(), &error_msg)) << error_msg;
+
+  StartupPageMap loaded_page_map;
+  ASSERT_TRUE(loaded_page_map.Load(file.GetFilename(), &error_msg)) << error_msg;
+  // Mappings with a different name or size are not prefetched.
+  EXPECT_EQ(0u, loaded_page_map.Prefetch("other", map.Begin(), map.End()));
+  EXPECT_EQ(0u, loaded_page_map.Prefetch("test", map.Begin(), map.Begin() + 4 * kPageSize));
+  EXPECT_EQ(3u, loaded_page_map.Prefetch("test", map.Begin(), map.End()));
+  EXPECT_EQ(3u, loaded_page_map.GetNumberOfPrefetchedPages());
+  // Prefetching does not map pages in the process, recording again finds the same pages.
+  EXPECT_FALSE(loaded_page_map.RecordResidentPages("test", map.Begin(), map.End()));
+  // Newly used pages are recorded.
+  map.Begin()[7 * kPageSize] = 1u;
+  EXPECT_TRUE(loaded_page_map.RecordResidentPages("test", map.Begin(), map.End()));
+}
+
+TEST_F(StartupPageMapTest, LoadInvalid) {
+  std::string error_msg;
+  StartupPageMap page_map;
+  ScratchDir dir;
+  EXPECT_FALSE(page_map.Load(dir.GetPath() + "does-not-exist", &error_msg));
+
+  ScratchFile file;
+  ASSERT_TRUE(android::base::WriteStringToFile("not a startup page map", file.GetFilename()));
+  EXPECT_FALSE(page_map.Load(file.GetFilename(), &error_msg));
+
+  // A truncated map is rejected.
+  MemMap map = MemMap::MapAnonymous("startup page map test",
+                                    kPageSize,
+                                    PROT_READ | PROT_WRITE,
+                                    /*low_4gb=*/ false,
+                                    &error_msg);
+  ASSERT_TRUE(map.IsValid()) << error_msg;
+  map.Begin()[0] = 1u;
+  ASSERT_TRUE(page_map.RecordResidentPages("test", map.Begin(), map.End()));
+  ASSERT_TRUE(page_map.Save(file.GetFilename(), &error_msg)) << error_msg;
+  std::string data;
+  ASSERT_TRUE(android::base::ReadFileToString(file.GetFilename(), &data));
+  data.pop_back();
+  ASSERT_TRUE(android::base::WriteStringToFile(data, file.GetFilename()));
+  EXPECT_FALSE(page_map.Load(file.GetFilename(), &error_msg));
+}
+
+}  // namespace art
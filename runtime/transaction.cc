@@ -19,6 +19,7 @@
 #include <android-base/logging.h>
 
 #include "aot_class_linker.h"
+#include "art_field-inl.h"
 #include "base/mutex-inl.h"
 #include "base/stl_util.h"
 #include "dex/descriptors_names.h"
@@ -153,13 +154,32 @@ bool Transaction::WriteValueConstraint(Thread* self, ObjPtr<mirror::Object> valu
   }
 }
 
-bool Transaction::ReadConstraint(Thread* self, ObjPtr<mirror::Object> obj) {
+bool Transaction::ReadConstraint(Thread* self, ArtField* field) {
   // Read constraints are checked only for static field reads as there are
   // no constraints on reading instance fields and array elements.
-  DCHECK(obj->IsClass());
+  DCHECK(field->IsStatic());
+  ObjPtr<mirror::Class> klass = field->GetDeclaringClass();
   MutexLock mu(self, log_lock_);
   if (IsStrict()) {
-    return obj != root_;  // fail if not self-updating
+    if (klass == root_) {
+      return false;  // self-updating
+    }
+    // Final static fields of initialized boot image classes never change, so the value read
+    // here is the value the class initializer would read at runtime. The compiler makes the
+    // same assumption when it omits initialization checks for these classes.
+    if (!field->IsFinal() ||
+        !klass->IsInitialized() ||
+        !heap_->ObjectIsInBootImageSpace(klass)) {
+      return true;
+    }
+    // Some boot image classes are initialized only in this process, for example by
+    // `RunRootClinits()`, so a reference may point to an object created by this process
+    // instead of the object the runtime would read.
+    if (field->IsPrimitiveType()) {
+      return false;
+    }
+    ObjPtr<mirror::Object> value = field->GetObject(klass);
+    return value != nullptr && !heap_->ObjectIsInBootImageSpace(value);
   } else {
     // For boot image and boot image extension, allow reading any field.
     return false;
@@ -40,6 +40,7 @@ class DexCache;
 class Object;
 class String;
 }  // namespace mirror
+class ArtField;
 class InternTable;
 template<class MirrorType> class ObjPtr;
 
@@ -64,7 +65,7 @@ class Transaction final {
 
   // If the transaction is in strict mode, then all access of static fields will be constrained,
   // one class's clinit will not be allowed to read or modify another class's static fields, unless
-  // the transaction is aborted.
+  // the transaction is aborted. Final static fields of initialized boot image classes can be read.
   bool IsStrict() {
     return strict_;
   }
@@ -139,7 +140,8 @@ class Transaction final {
       REQUIRES(!log_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  bool ReadConstraint(Thread* self, ObjPtr<mirror::Object> obj)
+  // Returns true if reading the static `field` must abort the transaction.
+  bool ReadConstraint(Thread* self, ArtField* field)
       REQUIRES(!log_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -639,6 +639,18 @@ TEST_F(TransactionTest, Constraints) {
   ASSERT_TRUE(value_field != nullptr);
   ASSERT_FALSE(value_field->IsStatic());
 
+  ObjPtr<mirror::Class> vm_runtime_class =
+      class_linker_->FindClass(soa.Self(), "Ldalvik/system/VMRuntime;", class_loader);
+  ASSERT_TRUE(vm_runtime_class != nullptr);
+  ASSERT_TRUE(heap->ObjectIsInBootImageSpace(vm_runtime_class));
+  ArtField* non_final_field = mirror::Class::FindField(soa.Self(),
+                                                       vm_runtime_class,
+                                                       "nonSdkApiUsageConsumer",
+                                                       "Ljava/util/function/Consumer;");
+  ASSERT_TRUE(non_final_field != nullptr);
+  ASSERT_TRUE(non_final_field->IsStatic());
+  ASSERT_FALSE(non_final_field->IsFinal());
+
   Handle<mirror::Class> static_field_class(hs.NewHandle(
       class_linker_->FindClass(soa.Self(), "LTransaction$StaticFieldClass;", class_loader)));
   ASSERT_TRUE(static_field_class != nullptr);
@@ -703,16 +715,16 @@ TEST_F(TransactionTest, Constraints) {
   Transaction transaction(/*strict=*/ false, /*root=*/ nullptr);
   // Static field in boot image.
   EXPECT_TRUE(transaction.WriteConstraint(soa.Self(), boolean_class.Get()));
-  EXPECT_FALSE(transaction.ReadConstraint(soa.Self(), boolean_class.Get()));
+  EXPECT_FALSE(transaction.ReadConstraint(soa.Self(), true_field));
   // Instance field or array element in boot image.
-  // Do not check ReadConstraint(), it expects only static fields (checks for class object).
+  // Do not check ReadConstraint(), it expects only static fields.
   EXPECT_TRUE(transaction.WriteConstraint(soa.Self(), true_value.Get()));
   EXPECT_TRUE(transaction.WriteConstraint(soa.Self(), array_iftable.Get()));
   // Static field not in boot image.
   EXPECT_FALSE(transaction.WriteConstraint(soa.Self(), static_fields_test_class.Get()));
-  EXPECT_FALSE(transaction.ReadConstraint(soa.Self(), static_fields_test_class.Get()));
+  EXPECT_FALSE(transaction.ReadConstraint(soa.Self(), static_fields_test_int_field));
   // Instance field or array element not in boot image.
-  // Do not check ReadConstraint(), it expects only static fields (checks for class object).
+  // Do not check ReadConstraint(), it expects only static fields.
   EXPECT_FALSE(transaction.WriteConstraint(soa.Self(), instance_fields_test_object.Get()));
   EXPECT_FALSE(transaction.WriteConstraint(soa.Self(), long_array_dim3.Get()));
   // Write value constraints.
@@ -727,21 +739,34 @@ TEST_F(TransactionTest, Constraints) {
   Transaction strict_transaction(/*strict=*/ true, /*root=*/ static_field_class.Get());
   // Static field in boot image.
   EXPECT_TRUE(strict_transaction.WriteConstraint(soa.Self(), boolean_class.Get()));
-  EXPECT_TRUE(strict_transaction.ReadConstraint(soa.Self(), boolean_class.Get()));
+  // Final static field of an initialized class in boot image.
+  ASSERT_TRUE(true_field->IsFinal());
+  ASSERT_TRUE(boolean_class->IsInitialized());
+  EXPECT_FALSE(strict_transaction.ReadConstraint(soa.Self(), true_field));
+  // Final static field of an initialized class in boot image referencing an object that is not
+  // in boot image, as if the class was initialized only by this process. A null is allowed.
+  true_field->SetObject</*kTransactionActive=*/ false>(boolean_class.Get(),
+                                                       instance_fields_test_object.Get());
+  EXPECT_TRUE(strict_transaction.ReadConstraint(soa.Self(), true_field));
+  true_field->SetObject</*kTransactionActive=*/ false>(boolean_class.Get(), nullptr);
+  EXPECT_FALSE(strict_transaction.ReadConstraint(soa.Self(), true_field));
+  true_field->SetObject</*kTransactionActive=*/ false>(boolean_class.Get(), true_value.Get());
+  // Non-final static field of a class in boot image.
+  EXPECT_TRUE(strict_transaction.ReadConstraint(soa.Self(), non_final_field));
   // Instance field or array element in boot image.
-  // Do not check ReadConstraint(), it expects only static fields (checks for class object).
+  // Do not check ReadConstraint(), it expects only static fields.
   EXPECT_TRUE(strict_transaction.WriteConstraint(soa.Self(), true_value.Get()));
   EXPECT_TRUE(strict_transaction.WriteConstraint(soa.Self(), array_iftable.Get()));
   // Static field in another class not in boot image.
   EXPECT_TRUE(strict_transaction.WriteConstraint(soa.Self(), static_fields_test_class.Get()));
-  EXPECT_TRUE(strict_transaction.ReadConstraint(soa.Self(), static_fields_test_class.Get()));
+  EXPECT_TRUE(strict_transaction.ReadConstraint(soa.Self(), static_fields_test_int_field));
   // Instance field or array element not in boot image.
-  // Do not check ReadConstraint(), it expects only static fields (checks for class object).
+  // Do not check ReadConstraint(), it expects only static fields.
   EXPECT_FALSE(strict_transaction.WriteConstraint(soa.Self(), instance_fields_test_object.Get()));
   EXPECT_FALSE(strict_transaction.WriteConstraint(soa.Self(), long_array_dim3.Get()));
   // Static field in the same class.
   EXPECT_FALSE(strict_transaction.WriteConstraint(soa.Self(), static_field_class.Get()));
-  EXPECT_FALSE(strict_transaction.ReadConstraint(soa.Self(), static_field_class.Get()));
+  EXPECT_FALSE(strict_transaction.ReadConstraint(soa.Self(), int_field));
   // Write value constraints.
   EXPECT_FALSE(strict_transaction.WriteValueConstraint(soa.Self(), static_fields_test_class.Get()));
   EXPECT_FALSE(
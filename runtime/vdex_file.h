@@ -249,6 +249,7 @@ class VdexFile {
   const uint8_t* Begin() const { return mmap_.Begin(); }
   const uint8_t* End() const { return mmap_.End(); }
   size_t Size() const { return mmap_.Size(); }
+  const std::string& GetName() const { return mmap_.GetName(); }
   bool Contains(const uint8_t* pointer) const {
     return pointer >= Begin() && pointer < End();
   }
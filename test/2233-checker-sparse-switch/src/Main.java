@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+
+  /// CHECK-START: int Main.$noinline$binarySearch(int) builder (after)
+  /// CHECK-DAG:     <<Value:i\d+>> ParameterValue
+  /// CHECK-DAG:     <<Const50:i\d+>> IntConstant 50
+  /// CHECK-DAG:     <<Less:z\d+>>  LessThan [<<Value>>,<<Const50>>]
+  /// CHECK-DAG:                    If [<<Less>>]
+
+  /// CHECK-START: int Main.$noinline$binarySearch(int) builder (after)
+  /// CHECK-NOT:                    PackedSwitch
+  private static int $noinline$binarySearch(int value) {
+    switch (value) {
+      case 10: return 1;
+      case 20: return 2;
+      case 30: return 3;
+      case 40: return 4;
+      case 50: return 5;
+      case 60: return 6;
+      case 70: return 7;
+      case 80: return 8;
+      default: return 0;
+    }
+  }
+
+  /// CHECK-START: boolean Main.$noinline$isVowel(char) builder (after)
+  /// CHECK-DAG:     <<Value:c\d+>> ParameterValue
+  /// CHECK-DAG:     <<Const97:i\d+>> IntConstant 97
+  /// CHECK-DAG:     <<Const21:i\d+>> IntConstant 21
+  /// CHECK-DAG:     <<Offset:i\d+>> Sub [<<Value>>,<<Const97>>]
+  /// CHECK-DAG:     <<Range:z\d+>> Below [<<Offset>>,<<Const21>>]
+  /// CHECK-DAG:                    If [<<Range>>]
+  /// CHECK-DAG:     <<Shift:i\d+>> Shr [{{i\d+}},<<Offset>>]
+  /// CHECK-DAG:     <<Bit:i\d+>>   And [<<Shift>>,{{i\d+}}]
+  /// CHECK-DAG:     <<Test:z\d+>>  NotEqual [<<Bit>>,{{i\d+}}]
+  /// CHECK-DAG:                    If [<<Test>>]
+  private static boolean $noinline$isVowel(char c) {
+    switch (c) {
+      case 'a':
+      case 'e':
+      case 'i':
+      case 'o':
+      case 'u':
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /// CHECK-START: int Main.$noinline$jumpTableCluster(int) builder (after)
+  /// CHECK:                        LessThan
+  /// CHECK:                        PackedSwitch
+  private static int $noinline$jumpTableCluster(int value) {
+    switch (value) {
+      case -1000: return 1;
+      case 1: return 2;
+      case 2: return 3;
+      case 3: return 4;
+      case 5: return 5;
+      case 6: return 6;
+      case 1000: return 7;
+      case 100000: return 8;
+      default: return 0;
+    }
+  }
+
+  private static int expectedBinarySearch(int value) {
+    return (value >= 10 && value <= 80 && value % 10 == 0) ? value / 10 : 0;
+  }
+
+  private static boolean expectedIsVowel(char c) {
+    return "aeiou".indexOf(c) >= 0;
+  }
+
+  private static int expectedJumpTableCluster(int value) {
+    if (value == -1000) return 1;
+    if (value >= 1 && value <= 3) return value + 1;
+    if (value == 5 || value == 6) return value;
+    if (value == 1000) return 7;
+    if (value == 100000) return 8;
+    return 0;
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static void assertEquals(boolean expected, boolean actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  public static void main(String[] args) {
+    for (int i = -2000; i <= 2000; i++) {
+      assertEquals(expectedBinarySearch(i), $noinline$binarySearch(i));
+      assertEquals(expectedJumpTableCluster(i), $noinline$jumpTableCluster(i));
+    }
+    int[] extremes = { Integer.MIN_VALUE, Integer.MIN_VALUE + 1, 99999, 100000, 100001,
+                       Integer.MAX_VALUE - 1, Integer.MAX_VALUE };
+    for (int i : extremes) {
+      assertEquals(expectedBinarySearch(i), $noinline$binarySearch(i));
+      assertEquals(expectedJumpTableCluster(i), $noinline$jumpTableCluster(i));
+    }
+    for (char c = 0; c < 256; c++) {
+      assertEquals(expectedIsVowel(c), $noinline$isVowel(c));
+    }
+    System.out.println("passed");
+  }
+}
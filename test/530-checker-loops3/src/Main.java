@@ -292,6 +292,46 @@ public class Main {
   // Verifier.
   //
 
+  static class Holder {
+    int value;
+  }
+
+  /// CHECK-START: int Main.invariantFieldLoad(Main$Holder, int) BCE (before)
+  /// CHECK-DAG: NullCheck        loop:<<Loop:B\d+>>
+  /// CHECK-DAG: InstanceFieldGet loop:<<Loop>>
+  //
+  /// CHECK-START: int Main.invariantFieldLoad(Main$Holder, int) BCE (after)
+  /// CHECK-DAG: Deoptimize       loop:none
+  /// CHECK-DAG: InstanceFieldGet loop:none
+  //
+  /// CHECK-START: int Main.invariantFieldLoad(Main$Holder, int) BCE (after)
+  /// CHECK-NOT: NullCheck
+  public static int invariantFieldLoad(Holder h, int n) {
+    // Dynamic elimination of the null check on h exposes the invariant load.
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      sum += h.value;
+    }
+    return sum;
+  }
+
+  /// CHECK-START: int Main.guardedFieldLoad(Main$Holder, int) BCE (after)
+  /// CHECK-DAG: NullCheck        loop:<<Loop:B\d+>>
+  /// CHECK-DAG: InstanceFieldGet loop:<<Loop>>
+  //
+  /// CHECK-START: int Main.guardedFieldLoad(Main$Holder, int) BCE (after)
+  /// CHECK-NOT: Deoptimize
+  public static int guardedFieldLoad(Holder h, int n) {
+    // The null check is not executed on every iteration, so it is not speculated on.
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+      if (i == 3) {
+        sum += h.value;
+      }
+    }
+    return sum;
+  }
+
   public static void main(String[] args) {
     int[] a = new int[10];
     int b[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
@@ -401,6 +441,18 @@ public class Main {
       expectEquals(888, a[i]);
     }
 
+    Holder h = new Holder();
+    h.value = 3;
+    expectEquals(12, invariantFieldLoad(h, 4));
+    expectEquals(0, invariantFieldLoad(null, 0));
+    try {
+      invariantFieldLoad(null, 1);
+      throw new Error("Should throw NPE");
+    } catch (NullPointerException e) {
+    }
+    expectEquals(3, guardedFieldLoad(h, 4));
+    expectEquals(0, guardedFieldLoad(null, 3));
+
     System.out.println("passed");
   }
 
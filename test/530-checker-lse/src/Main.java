@@ -3964,6 +3964,127 @@ public class Main {
     return res;
   }
 
+  /// CHECK-START: int Main.$noinline$testPartialEscape2(boolean) load_store_elimination (before)
+  /// CHECK-DAG:     NewInstance
+  /// CHECK-DAG:     InstanceFieldGet field_name:{{.*TestClass4.intField}}
+  //
+  /// CHECK-START: int Main.$noinline$testPartialEscape2(boolean) load_store_elimination (after)
+  /// CHECK-DAG:     NewInstance
+  /// CHECK-DAG:     PredicatedInstanceFieldGet field_name:{{.*TestClass4.intField}}
+  private static int $noinline$testPartialEscape2(boolean escape) {
+    TestClass4 t = new TestClass4();
+    t.intField = 10;
+    if ($noinline$getBoolean(escape)) {
+      $noinline$Escape4(t);
+    }
+    return t.intField;
+  }
+
+  /// CHECK-START: int Main.$noinline$testSynchronizedLocal(int) monitor_elimination (before)
+  /// CHECK-DAG:     MonitorOperation kind:enter
+  /// CHECK-DAG:     MonitorOperation kind:exit
+  //
+  /// CHECK-START: int Main.$noinline$testSynchronizedLocal(int) monitor_elimination (after)
+  /// CHECK-NOT:     MonitorOperation
+  //
+  /// CHECK-START: int Main.$noinline$testSynchronizedLocal(int) load_store_elimination (after)
+  /// CHECK-NOT:     NewInstance
+  /// CHECK-NOT:     InstanceFieldGet
+  private static int $noinline$testSynchronizedLocal(int value) {
+    TestClass4 t = new TestClass4();
+    synchronized (t) {
+      t.intField = value;
+    }
+    return t.intField + 1;
+  }
+
+  /// CHECK-START: int Main.$noinline$testSynchronizedEscape(int) monitor_elimination (after)
+  /// CHECK-DAG:     MonitorOperation kind:enter
+  /// CHECK-DAG:     MonitorOperation kind:exit
+  private static int $noinline$testSynchronizedEscape(int value) {
+    TestClass4 t = new TestClass4();
+    synchronized (t) {
+      t.intField = value;
+      $noinline$Escape4(t);
+    }
+    return t.intField;
+  }
+
+  // The allocation is moved into the branch where the object escapes, and is
+  // initialized there with the values stored before the branch.
+  /// CHECK-START: int Main.$noinline$testPartialEscape3(boolean) load_store_elimination (before)
+  /// CHECK:         NewInstance
+  /// CHECK:         InstanceFieldSet field_name:{{.*TestClass4.intField}}
+  /// CHECK:         If
+  //
+  /// CHECK-START: int Main.$noinline$testPartialEscape3(boolean) load_store_elimination (after)
+  /// CHECK-NOT:     NewInstance
+  /// CHECK:         If
+  /// CHECK:         NewInstance
+  /// CHECK:         InstanceFieldSet field_name:{{.*TestClass4.intField}}
+  //
+  /// CHECK-START: int Main.$noinline$testPartialEscape3(boolean) load_store_elimination (after)
+  /// CHECK-NOT:     InstanceFieldGet field_name:{{.*TestClass4.intField}}
+  /// CHECK-NOT:     PredicatedInstanceFieldGet field_name:{{.*TestClass4.intField}}
+  private static int $noinline$testPartialEscape3(boolean escape) {
+    TestClass4 t = new TestClass4();
+    t.intField = 10;
+    if ($noinline$getBoolean(escape)) {
+      $noinline$Escape4(t);
+      return 0;
+    }
+    return t.intField;
+  }
+
+  // The object escapes on two paths which merge before the load. Each path gets
+  // its own allocation, and the load is predicated on the merged reference.
+  /// CHECK-START: int Main.$noinline$testPartialEscapeMerge(int) load_store_elimination (before)
+  /// CHECK:         NewInstance
+  /// CHECK-NOT:     NewInstance
+  //
+  /// CHECK-START: int Main.$noinline$testPartialEscapeMerge(int) load_store_elimination (before)
+  /// CHECK-DAG:     InstanceFieldGet field_name:{{.*TestClass4.intField}}
+  //
+  /// CHECK-START: int Main.$noinline$testPartialEscapeMerge(int) load_store_elimination (after)
+  /// CHECK-DAG:     NewInstance
+  /// CHECK-DAG:     NewInstance
+  /// CHECK-DAG:     PredicatedInstanceFieldGet field_name:{{.*TestClass4.intField}}
+  //
+  /// CHECK-START: int Main.$noinline$testPartialEscapeMerge(int) load_store_elimination (after)
+  /// CHECK-NOT:     InstanceFieldGet field_name:{{.*TestClass4.intField}}
+  private static int $noinline$testPartialEscapeMerge(int choice) {
+    TestClass4 t = new TestClass4();
+    t.intField = 10;
+    if (choice == 0) {
+      $noinline$Escape4(t);
+    } else if (choice == 1) {
+      $noinline$Escape4(t);
+      $noinline$Escape4(t);
+    }
+    return t.intField;
+  }
+
+  // An escape inside a loop makes the whole loop escaping, so the object is always
+  // materialized after the loop and the load is not predicated.
+  /// CHECK-START: int Main.$noinline$testPartialEscapeLoop(int) load_store_elimination (after)
+  /// CHECK-DAG:     NewInstance
+  /// CHECK-DAG:     InstanceFieldGet field_name:{{.*TestClass4.intField}}
+  //
+  /// CHECK-START: int Main.$noinline$testPartialEscapeLoop(int) load_store_elimination (after)
+  /// CHECK-NOT:     PredicatedInstanceFieldGet
+  private static int $noinline$testPartialEscapeLoop(int n) {
+    TestClass4 t = new TestClass4();
+    t.intField = 10;
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+      if (i == 3) {
+        $noinline$Escape4(t);
+      }
+      sum += i;
+    }
+    return sum + t.intField;
+  }
+
   private static void $noinline$clobberObservables() {}
 
   static void assertLongEquals(long result, long expected) {
@@ -4370,5 +4491,17 @@ public class Main {
     assertLongEquals(testOverlapLoop(50), 7778742049l);
     assertIntEquals($noinline$testPartialEscape1(new TestClass(), true), 1);
     assertIntEquals($noinline$testPartialEscape1(new TestClass(), false), 0);
+    assertIntEquals($noinline$testPartialEscape2(true), 11);
+    assertIntEquals($noinline$testPartialEscape2(false), 10);
+    assertIntEquals($noinline$testPartialEscape3(true), 0);
+    assertIntEquals($noinline$testPartialEscape3(false), 10);
+    assertIntEquals($noinline$testPartialEscapeMerge(0), 11);
+    assertIntEquals($noinline$testPartialEscapeMerge(1), 12);
+    assertIntEquals($noinline$testPartialEscapeMerge(2), 10);
+    assertIntEquals($noinline$testPartialEscapeLoop(0), 10);
+    assertIntEquals($noinline$testPartialEscapeLoop(2), 11);
+    assertIntEquals($noinline$testPartialEscapeLoop(5), 21);
+    assertIntEquals($noinline$testSynchronizedLocal(41), 42);
+    assertIntEquals($noinline$testSynchronizedEscape(41), 42);
   }
 }
@@ -331,6 +331,40 @@ public class Main {
     }
   }
 
+  /// CHECK-START: void Main.shortTripCount(byte[]) loop_optimization (before)
+  /// CHECK-DAG: <<I1:i\d+>>    IntConstant 1                        loop:none
+  /// CHECK-DAG: <<Phi:i\d+>>   Phi                                  loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG: <<Get:b\d+>>   ArrayGet [{{l\d+}},<<Phi>>]          loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Add:i\d+>>   Add [<<Get>>,<<I1>>]                 loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG: <<Cnv:b\d+>>   TypeConversion [<<Add>>]             loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                ArraySet [{{l\d+}},<<Phi>>,<<Cnv>>] loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-START-ARM64: void Main.shortTripCount(byte[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("sve")
+  //
+  //      A trip count below the vector length is handled by a single predicated
+  //      vector loop, without peeling or a scalar cleanup loop.
+  ///     CHECK-DAG: <<Phi:i\d+>>   Phi                                           loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<LoopP:j\d+>> VecPredWhile [<<Phi>>,{{i\d+}}]               loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Load:d\d+>>  VecLoad [{{l\d+}},<<Phi>>,<<LoopP>>]          loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>   VecAdd [<<Load>>,{{d\d+}},<<LoopP>>]         loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                VecStore [{{l\d+}},<<Phi>>,<<Add>>,<<LoopP>>] loop:<<Loop>>      outer_loop:none
+  //
+  /// CHECK-NOT:                    ArrayGet
+  /// CHECK-NOT:                    ArraySet
+  //
+  /// CHECK-ELSE:
+  //
+  //      Too few iterations for a fixed-width vector loop.
+  ///     CHECK-NOT:                VecLoad
+  //
+  /// CHECK-FI:
+  static void shortTripCount(byte[] x) {
+    for (int i = 0; i < 13; i++) {
+      x[i] += 1;
+    }
+  }
+
   static void testUnroll() {
     float[] x = new float[100];
     float[] y = new float[100];
@@ -405,12 +439,27 @@ public class Main {
     }
   }
 
+  static void testShortTripCount() {
+    byte[] x = new byte[16];
+    for (int i = 0; i < 16; i++) {
+      x[i] = (byte) i;
+    }
+    shortTripCount(x);
+    for (int i = 0; i < 13; i++) {
+      expectEquals(i + 1, x[i]);
+    }
+    for (int i = 13; i < 16; i++) {
+      expectEquals(i, x[i]);
+    }
+  }
+
   public static void main(String[] args) {
     testUnroll();
     testStencil1();
     testStencil2();
     testStencil3();
     testTypes();
+    testShortTripCount();
     System.out.println("passed");
   }
 
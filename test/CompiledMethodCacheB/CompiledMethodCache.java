@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Same as CompiledMethodCacheA, except for the body of edited(). It refers to new strings and
+// types that sort before those used by the other methods, so their string and type indexes
+// shift, as does the index of the Object constructor called by <init>.
+class CompiledMethodCache {
+  static String untouchedString() {
+    return "zzz";
+  }
+
+  static Class<?> untouchedType() {
+    return java.util.zip.CRC32.class;
+  }
+
+  static Object edited() {
+    return Integer.valueOf(1);
+  }
+}
@@ -0,0 +1,1667 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// A deep class hierarchy with large vtables and many interface methods, for measuring class
+// linking. Each class C<i> extends C<i-1>, implements interface I<i> and declares methods of its
+// own, so that the last class has more than a thousand vtable entries.
+class DeepHierarchy {
+  interface I0 {
+    void i0m0();
+    void i0m1();
+    void i0m2();
+    void i0m3();
+    void i0m4();
+    void i0m5();
+    void i0m6();
+    void i0m7();
+    void i0m8();
+    void i0m9();
+    void i0m10();
+    void i0m11();
+    void i0m12();
+    void i0m13();
+    void i0m14();
+    void i0m15();
+    void i0m16();
+    void i0m17();
+    void i0m18();
+    void i0m19();
+    void i0m20();
+    void i0m21();
+    void i0m22();
+    void i0m23();
+    void i0m24();
+    void i0m25();
+    void i0m26();
+    void i0m27();
+    void i0m28();
+    void i0m29();
+    void i0m30();
+    void i0m31();
+  }
+
+  interface I1 {
+    void i1m0();
+    void i1m1();
+    void i1m2();
+    void i1m3();
+    void i1m4();
+    void i1m5();
+    void i1m6();
+    void i1m7();
+    void i1m8();
+    void i1m9();
+    void i1m10();
+    void i1m11();
+    void i1m12();
+    void i1m13();
+    void i1m14();
+    void i1m15();
+    void i1m16();
+    void i1m17();
+    void i1m18();
+    void i1m19();
+    void i1m20();
+    void i1m21();
+    void i1m22();
+    void i1m23();
+    void i1m24();
+    void i1m25();
+    void i1m26();
+    void i1m27();
+    void i1m28();
+    void i1m29();
+    void i1m30();
+    void i1m31();
+  }
+
+  interface I2 {
+    void i2m0();
+    void i2m1();
+    void i2m2();
+    void i2m3();
+    void i2m4();
+    void i2m5();
+    void i2m6();
+    void i2m7();
+    void i2m8();
+    void i2m9();
+    void i2m10();
+    void i2m11();
+    void i2m12();
+    void i2m13();
+    void i2m14();
+    void i2m15();
+    void i2m16();
+    void i2m17();
+    void i2m18();
+    void i2m19();
+    void i2m20();
+    void i2m21();
+    void i2m22();
+    void i2m23();
+    void i2m24();
+    void i2m25();
+    void i2m26();
+    void i2m27();
+    void i2m28();
+    void i2m29();
+    void i2m30();
+    void i2m31();
+  }
+
+  interface I3 {
+    void i3m0();
+    void i3m1();
+    void i3m2();
+    void i3m3();
+    void i3m4();
+    void i3m5();
+    void i3m6();
+    void i3m7();
+    void i3m8();
+    void i3m9();
+    void i3m10();
+    void i3m11();
+    void i3m12();
+    void i3m13();
+    void i3m14();
+    void i3m15();
+    void i3m16();
+    void i3m17();
+    void i3m18();
+    void i3m19();
+    void i3m20();
+    void i3m21();
+    void i3m22();
+    void i3m23();
+    void i3m24();
+    void i3m25();
+    void i3m26();
+    void i3m27();
+    void i3m28();
+    void i3m29();
+    void i3m30();
+    void i3m31();
+  }
+
+  interface I4 {
+    void i4m0();
+    void i4m1();
+    void i4m2();
+    void i4m3();
+    void i4m4();
+    void i4m5();
+    void i4m6();
+    void i4m7();
+    void i4m8();
+    void i4m9();
+    void i4m10();
+    void i4m11();
+    void i4m12();
+    void i4m13();
+    void i4m14();
+    void i4m15();
+    void i4m16();
+    void i4m17();
+    void i4m18();
+    void i4m19();
+    void i4m20();
+    void i4m21();
+    void i4m22();
+    void i4m23();
+    void i4m24();
+    void i4m25();
+    void i4m26();
+    void i4m27();
+    void i4m28();
+    void i4m29();
+    void i4m30();
+    void i4m31();
+  }
+
+  interface I5 {
+    void i5m0();
+    void i5m1();
+    void i5m2();
+    void i5m3();
+    void i5m4();
+    void i5m5();
+    void i5m6();
+    void i5m7();
+    void i5m8();
+    void i5m9();
+    void i5m10();
+    void i5m11();
+    void i5m12();
+    void i5m13();
+    void i5m14();
+    void i5m15();
+    void i5m16();
+    void i5m17();
+    void i5m18();
+    void i5m19();
+    void i5m20();
+    void i5m21();
+    void i5m22();
+    void i5m23();
+    void i5m24();
+    void i5m25();
+    void i5m26();
+    void i5m27();
+    void i5m28();
+    void i5m29();
+    void i5m30();
+    void i5m31();
+  }
+
+  interface I6 {
+    void i6m0();
+    void i6m1();
+    void i6m2();
+    void i6m3();
+    void i6m4();
+    void i6m5();
+    void i6m6();
+    void i6m7();
+    void i6m8();
+    void i6m9();
+    void i6m10();
+    void i6m11();
+    void i6m12();
+    void i6m13();
+    void i6m14();
+    void i6m15();
+    void i6m16();
+    void i6m17();
+    void i6m18();
+    void i6m19();
+    void i6m20();
+    void i6m21();
+    void i6m22();
+    void i6m23();
+    void i6m24();
+    void i6m25();
+    void i6m26();
+    void i6m27();
+    void i6m28();
+    void i6m29();
+    void i6m30();
+    void i6m31();
+  }
+
+  interface I7 {
+    void i7m0();
+    void i7m1();
+    void i7m2();
+    void i7m3();
+    void i7m4();
+    void i7m5();
+    void i7m6();
+    void i7m7();
+    void i7m8();
+    void i7m9();
+    void i7m10();
+    void i7m11();
+    void i7m12();
+    void i7m13();
+    void i7m14();
+    void i7m15();
+    void i7m16();
+    void i7m17();
+    void i7m18();
+    void i7m19();
+    void i7m20();
+    void i7m21();
+    void i7m22();
+    void i7m23();
+    void i7m24();
+    void i7m25();
+    void i7m26();
+    void i7m27();
+    void i7m28();
+    void i7m29();
+    void i7m30();
+    void i7m31();
+  }
+
+  interface I8 {
+    void i8m0();
+    void i8m1();
+    void i8m2();
+    void i8m3();
+    void i8m4();
+    void i8m5();
+    void i8m6();
+    void i8m7();
+    void i8m8();
+    void i8m9();
+    void i8m10();
+    void i8m11();
+    void i8m12();
+    void i8m13();
+    void i8m14();
+    void i8m15();
+    void i8m16();
+    void i8m17();
+    void i8m18();
+    void i8m19();
+    void i8m20();
+    void i8m21();
+    void i8m22();
+    void i8m23();
+    void i8m24();
+    void i8m25();
+    void i8m26();
+    void i8m27();
+    void i8m28();
+    void i8m29();
+    void i8m30();
+    void i8m31();
+  }
+
+  interface I9 {
+    void i9m0();
+    void i9m1();
+    void i9m2();
+    void i9m3();
+    void i9m4();
+    void i9m5();
+    void i9m6();
+    void i9m7();
+    void i9m8();
+    void i9m9();
+    void i9m10();
+    void i9m11();
+    void i9m12();
+    void i9m13();
+    void i9m14();
+    void i9m15();
+    void i9m16();
+    void i9m17();
+    void i9m18();
+    void i9m19();
+    void i9m20();
+    void i9m21();
+    void i9m22();
+    void i9m23();
+    void i9m24();
+    void i9m25();
+    void i9m26();
+    void i9m27();
+    void i9m28();
+    void i9m29();
+    void i9m30();
+    void i9m31();
+  }
+
+  interface I10 {
+    void i10m0();
+    void i10m1();
+    void i10m2();
+    void i10m3();
+    void i10m4();
+    void i10m5();
+    void i10m6();
+    void i10m7();
+    void i10m8();
+    void i10m9();
+    void i10m10();
+    void i10m11();
+    void i10m12();
+    void i10m13();
+    void i10m14();
+    void i10m15();
+    void i10m16();
+    void i10m17();
+    void i10m18();
+    void i10m19();
+    void i10m20();
+    void i10m21();
+    void i10m22();
+    void i10m23();
+    void i10m24();
+    void i10m25();
+    void i10m26();
+    void i10m27();
+    void i10m28();
+    void i10m29();
+    void i10m30();
+    void i10m31();
+  }
+
+  interface I11 {
+    void i11m0();
+    void i11m1();
+    void i11m2();
+    void i11m3();
+    void i11m4();
+    void i11m5();
+    void i11m6();
+    void i11m7();
+    void i11m8();
+    void i11m9();
+    void i11m10();
+    void i11m11();
+    void i11m12();
+    void i11m13();
+    void i11m14();
+    void i11m15();
+    void i11m16();
+    void i11m17();
+    void i11m18();
+    void i11m19();
+    void i11m20();
+    void i11m21();
+    void i11m22();
+    void i11m23();
+    void i11m24();
+    void i11m25();
+    void i11m26();
+    void i11m27();
+    void i11m28();
+    void i11m29();
+    void i11m30();
+    void i11m31();
+  }
+
+  interface I12 {
+    void i12m0();
+    void i12m1();
+    void i12m2();
+    void i12m3();
+    void i12m4();
+    void i12m5();
+    void i12m6();
+    void i12m7();
+    void i12m8();
+    void i12m9();
+    void i12m10();
+    void i12m11();
+    void i12m12();
+    void i12m13();
+    void i12m14();
+    void i12m15();
+    void i12m16();
+    void i12m17();
+    void i12m18();
+    void i12m19();
+    void i12m20();
+    void i12m21();
+    void i12m22();
+    void i12m23();
+    void i12m24();
+    void i12m25();
+    void i12m26();
+    void i12m27();
+    void i12m28();
+    void i12m29();
+    void i12m30();
+    void i12m31();
+  }
+
+  interface I13 {
+    void i13m0();
+    void i13m1();
+    void i13m2();
+    void i13m3();
+    void i13m4();
+    void i13m5();
+    void i13m6();
+    void i13m7();
+    void i13m8();
+    void i13m9();
+    void i13m10();
+    void i13m11();
+    void i13m12();
+    void i13m13();
+    void i13m14();
+    void i13m15();
+    void i13m16();
+    void i13m17();
+    void i13m18();
+    void i13m19();
+    void i13m20();
+    void i13m21();
+    void i13m22();
+    void i13m23();
+    void i13m24();
+    void i13m25();
+    void i13m26();
+    void i13m27();
+    void i13m28();
+    void i13m29();
+    void i13m30();
+    void i13m31();
+  }
+
+  interface I14 {
+    void i14m0();
+    void i14m1();
+    void i14m2();
+    void i14m3();
+    void i14m4();
+    void i14m5();
+    void i14m6();
+    void i14m7();
+    void i14m8();
+    void i14m9();
+    void i14m10();
+    void i14m11();
+    void i14m12();
+    void i14m13();
+    void i14m14();
+    void i14m15();
+    void i14m16();
+    void i14m17();
+    void i14m18();
+    void i14m19();
+    void i14m20();
+    void i14m21();
+    void i14m22();
+    void i14m23();
+    void i14m24();
+    void i14m25();
+    void i14m26();
+    void i14m27();
+    void i14m28();
+    void i14m29();
+    void i14m30();
+    void i14m31();
+  }
+
+  interface I15 {
+    void i15m0();
+    void i15m1();
+    void i15m2();
+    void i15m3();
+    void i15m4();
+    void i15m5();
+    void i15m6();
+    void i15m7();
+    void i15m8();
+    void i15m9();
+    void i15m10();
+    void i15m11();
+    void i15m12();
+    void i15m13();
+    void i15m14();
+    void i15m15();
+    void i15m16();
+    void i15m17();
+    void i15m18();
+    void i15m19();
+    void i15m20();
+    void i15m21();
+    void i15m22();
+    void i15m23();
+    void i15m24();
+    void i15m25();
+    void i15m26();
+    void i15m27();
+    void i15m28();
+    void i15m29();
+    void i15m30();
+    void i15m31();
+  }
+
+  static class C0 implements I0 {
+    public void i0m0() {}
+    public void i0m1() {}
+    public void i0m2() {}
+    public void i0m3() {}
+    public void i0m4() {}
+    public void i0m5() {}
+    public void i0m6() {}
+    public void i0m7() {}
+    public void i0m8() {}
+    public void i0m9() {}
+    public void i0m10() {}
+    public void i0m11() {}
+    public void i0m12() {}
+    public void i0m13() {}
+    public void i0m14() {}
+    public void i0m15() {}
+    public void i0m16() {}
+    public void i0m17() {}
+    public void i0m18() {}
+    public void i0m19() {}
+    public void i0m20() {}
+    public void i0m21() {}
+    public void i0m22() {}
+    public void i0m23() {}
+    public void i0m24() {}
+    public void i0m25() {}
+    public void i0m26() {}
+    public void i0m27() {}
+    public void i0m28() {}
+    public void i0m29() {}
+    public void i0m30() {}
+    public void i0m31() {}
+    public void c0m0() {}
+    public void c0m1() {}
+    public void c0m2() {}
+    public void c0m3() {}
+    public void c0m4() {}
+    public void c0m5() {}
+    public void c0m6() {}
+    public void c0m7() {}
+    public void c0m8() {}
+    public void c0m9() {}
+    public void c0m10() {}
+    public void c0m11() {}
+    public void c0m12() {}
+    public void c0m13() {}
+    public void c0m14() {}
+    public void c0m15() {}
+    public void c0m16() {}
+    public void c0m17() {}
+    public void c0m18() {}
+    public void c0m19() {}
+    public void c0m20() {}
+    public void c0m21() {}
+    public void c0m22() {}
+    public void c0m23() {}
+    public void c0m24() {}
+    public void c0m25() {}
+    public void c0m26() {}
+    public void c0m27() {}
+    public void c0m28() {}
+    public void c0m29() {}
+    public void c0m30() {}
+    public void c0m31() {}
+  }
+
+  static class C1 extends C0 implements I1 {
+    public void i1m0() {}
+    public void i1m1() {}
+    public void i1m2() {}
+    public void i1m3() {}
+    public void i1m4() {}
+    public void i1m5() {}
+    public void i1m6() {}
+    public void i1m7() {}
+    public void i1m8() {}
+    public void i1m9() {}
+    public void i1m10() {}
+    public void i1m11() {}
+    public void i1m12() {}
+    public void i1m13() {}
+    public void i1m14() {}
+    public void i1m15() {}
+    public void i1m16() {}
+    public void i1m17() {}
+    public void i1m18() {}
+    public void i1m19() {}
+    public void i1m20() {}
+    public void i1m21() {}
+    public void i1m22() {}
+    public void i1m23() {}
+    public void i1m24() {}
+    public void i1m25() {}
+    public void i1m26() {}
+    public void i1m27() {}
+    public void i1m28() {}
+    public void i1m29() {}
+    public void i1m30() {}
+    public void i1m31() {}
+    public void c1m0() {}
+    public void c1m1() {}
+    public void c1m2() {}
+    public void c1m3() {}
+    public void c1m4() {}
+    public void c1m5() {}
+    public void c1m6() {}
+    public void c1m7() {}
+    public void c1m8() {}
+    public void c1m9() {}
+    public void c1m10() {}
+    public void c1m11() {}
+    public void c1m12() {}
+    public void c1m13() {}
+    public void c1m14() {}
+    public void c1m15() {}
+    public void c1m16() {}
+    public void c1m17() {}
+    public void c1m18() {}
+    public void c1m19() {}
+    public void c1m20() {}
+    public void c1m21() {}
+    public void c1m22() {}
+    public void c1m23() {}
+    public void c1m24() {}
+    public void c1m25() {}
+    public void c1m26() {}
+    public void c1m27() {}
+    public void c1m28() {}
+    public void c1m29() {}
+    public void c1m30() {}
+    public void c1m31() {}
+  }
+
+  static class C2 extends C1 implements I2 {
+    public void i2m0() {}
+    public void i2m1() {}
+    public void i2m2() {}
+    public void i2m3() {}
+    public void i2m4() {}
+    public void i2m5() {}
+    public void i2m6() {}
+    public void i2m7() {}
+    public void i2m8() {}
+    public void i2m9() {}
+    public void i2m10() {}
+    public void i2m11() {}
+    public void i2m12() {}
+    public void i2m13() {}
+    public void i2m14() {}
+    public void i2m15() {}
+    public void i2m16() {}
+    public void i2m17() {}
+    public void i2m18() {}
+    public void i2m19() {}
+    public void i2m20() {}
+    public void i2m21() {}
+    public void i2m22() {}
+    public void i2m23() {}
+    public void i2m24() {}
+    public void i2m25() {}
+    public void i2m26() {}
+    public void i2m27() {}
+    public void i2m28() {}
+    public void i2m29() {}
+    public void i2m30() {}
+    public void i2m31() {}
+    public void c2m0() {}
+    public void c2m1() {}
+    public void c2m2() {}
+    public void c2m3() {}
+    public void c2m4() {}
+    public void c2m5() {}
+    public void c2m6() {}
+    public void c2m7() {}
+    public void c2m8() {}
+    public void c2m9() {}
+    public void c2m10() {}
+    public void c2m11() {}
+    public void c2m12() {}
+    public void c2m13() {}
+    public void c2m14() {}
+    public void c2m15() {}
+    public void c2m16() {}
+    public void c2m17() {}
+    public void c2m18() {}
+    public void c2m19() {}
+    public void c2m20() {}
+    public void c2m21() {}
+    public void c2m22() {}
+    public void c2m23() {}
+    public void c2m24() {}
+    public void c2m25() {}
+    public void c2m26() {}
+    public void c2m27() {}
+    public void c2m28() {}
+    public void c2m29() {}
+    public void c2m30() {}
+    public void c2m31() {}
+  }
+
+  static class C3 extends C2 implements I3 {
+    public void i3m0() {}
+    public void i3m1() {}
+    public void i3m2() {}
+    public void i3m3() {}
+    public void i3m4() {}
+    public void i3m5() {}
+    public void i3m6() {}
+    public void i3m7() {}
+    public void i3m8() {}
+    public void i3m9() {}
+    public void i3m10() {}
+    public void i3m11() {}
+    public void i3m12() {}
+    public void i3m13() {}
+    public void i3m14() {}
+    public void i3m15() {}
+    public void i3m16() {}
+    public void i3m17() {}
+    public void i3m18() {}
+    public void i3m19() {}
+    public void i3m20() {}
+    public void i3m21() {}
+    public void i3m22() {}
+    public void i3m23() {}
+    public void i3m24() {}
+    public void i3m25() {}
+    public void i3m26() {}
+    public void i3m27() {}
+    public void i3m28() {}
+    public void i3m29() {}
+    public void i3m30() {}
+    public void i3m31() {}
+    public void c3m0() {}
+    public void c3m1() {}
+    public void c3m2() {}
+    public void c3m3() {}
+    public void c3m4() {}
+    public void c3m5() {}
+    public void c3m6() {}
+    public void c3m7() {}
+    public void c3m8() {}
+    public void c3m9() {}
+    public void c3m10() {}
+    public void c3m11() {}
+    public void c3m12() {}
+    public void c3m13() {}
+    public void c3m14() {}
+    public void c3m15() {}
+    public void c3m16() {}
+    public void c3m17() {}
+    public void c3m18() {}
+    public void c3m19() {}
+    public void c3m20() {}
+    public void c3m21() {}
+    public void c3m22() {}
+    public void c3m23() {}
+    public void c3m24() {}
+    public void c3m25() {}
+    public void c3m26() {}
+    public void c3m27() {}
+    public void c3m28() {}
+    public void c3m29() {}
+    public void c3m30() {}
+    public void c3m31() {}
+  }
+
+  static class C4 extends C3 implements I4 {
+    public void i4m0() {}
+    public void i4m1() {}
+    public void i4m2() {}
+    public void i4m3() {}
+    public void i4m4() {}
+    public void i4m5() {}
+    public void i4m6() {}
+    public void i4m7() {}
+    public void i4m8() {}
+    public void i4m9() {}
+    public void i4m10() {}
+    public void i4m11() {}
+    public void i4m12() {}
+    public void i4m13() {}
+    public void i4m14() {}
+    public void i4m15() {}
+    public void i4m16() {}
+    public void i4m17() {}
+    public void i4m18() {}
+    public void i4m19() {}
+    public void i4m20() {}
+    public void i4m21() {}
+    public void i4m22() {}
+    public void i4m23() {}
+    public void i4m24() {}
+    public void i4m25() {}
+    public void i4m26() {}
+    public void i4m27() {}
+    public void i4m28() {}
+    public void i4m29() {}
+    public void i4m30() {}
+    public void i4m31() {}
+    public void c4m0() {}
+    public void c4m1() {}
+    public void c4m2() {}
+    public void c4m3() {}
+    public void c4m4() {}
+    public void c4m5() {}
+    public void c4m6() {}
+    public void c4m7() {}
+    public void c4m8() {}
+    public void c4m9() {}
+    public void c4m10() {}
+    public void c4m11() {}
+    public void c4m12() {}
+    public void c4m13() {}
+    public void c4m14() {}
+    public void c4m15() {}
+    public void c4m16() {}
+    public void c4m17() {}
+    public void c4m18() {}
+    public void c4m19() {}
+    public void c4m20() {}
+    public void c4m21() {}
+    public void c4m22() {}
+    public void c4m23() {}
+    public void c4m24() {}
+    public void c4m25() {}
+    public void c4m26() {}
+    public void c4m27() {}
+    public void c4m28() {}
+    public void c4m29() {}
+    public void c4m30() {}
+    public void c4m31() {}
+  }
+
+  static class C5 extends C4 implements I5 {
+    public void i5m0() {}
+    public void i5m1() {}
+    public void i5m2() {}
+    public void i5m3() {}
+    public void i5m4() {}
+    public void i5m5() {}
+    public void i5m6() {}
+    public void i5m7() {}
+    public void i5m8() {}
+    public void i5m9() {}
+    public void i5m10() {}
+    public void i5m11() {}
+    public void i5m12() {}
+    public void i5m13() {}
+    public void i5m14() {}
+    public void i5m15() {}
+    public void i5m16() {}
+    public void i5m17() {}
+    public void i5m18() {}
+    public void i5m19() {}
+    public void i5m20() {}
+    public void i5m21() {}
+    public void i5m22() {}
+    public void i5m23() {}
+    public void i5m24() {}
+    public void i5m25() {}
+    public void i5m26() {}
+    public void i5m27() {}
+    public void i5m28() {}
+    public void i5m29() {}
+    public void i5m30() {}
+    public void i5m31() {}
+    public void c5m0() {}
+    public void c5m1() {}
+    public void c5m2() {}
+    public void c5m3() {}
+    public void c5m4() {}
+    public void c5m5() {}
+    public void c5m6() {}
+    public void c5m7() {}
+    public void c5m8() {}
+    public void c5m9() {}
+    public void c5m10() {}
+    public void c5m11() {}
+    public void c5m12() {}
+    public void c5m13() {}
+    public void c5m14() {}
+    public void c5m15() {}
+    public void c5m16() {}
+    public void c5m17() {}
+    public void c5m18() {}
+    public void c5m19() {}
+    public void c5m20() {}
+    public void c5m21() {}
+    public void c5m22() {}
+    public void c5m23() {}
+    public void c5m24() {}
+    public void c5m25() {}
+    public void c5m26() {}
+    public void c5m27() {}
+    public void c5m28() {}
+    public void c5m29() {}
+    public void c5m30() {}
+    public void c5m31() {}
+  }
+
+  static class C6 extends C5 implements I6 {
+    public void i6m0() {}
+    public void i6m1() {}
+    public void i6m2() {}
+    public void i6m3() {}
+    public void i6m4() {}
+    public void i6m5() {}
+    public void i6m6() {}
+    public void i6m7() {}
+    public void i6m8() {}
+    public void i6m9() {}
+    public void i6m10() {}
+    public void i6m11() {}
+    public void i6m12() {}
+    public void i6m13() {}
+    public void i6m14() {}
+    public void i6m15() {}
+    public void i6m16() {}
+    public void i6m17() {}
+    public void i6m18() {}
+    public void i6m19() {}
+    public void i6m20() {}
+    public void i6m21() {}
+    public void i6m22() {}
+    public void i6m23() {}
+    public void i6m24() {}
+    public void i6m25() {}
+    public void i6m26() {}
+    public void i6m27() {}
+    public void i6m28() {}
+    public void i6m29() {}
+    public void i6m30() {}
+    public void i6m31() {}
+    public void c6m0() {}
+    public void c6m1() {}
+    public void c6m2() {}
+    public void c6m3() {}
+    public void c6m4() {}
+    public void c6m5() {}
+    public void c6m6() {}
+    public void c6m7() {}
+    public void c6m8() {}
+    public void c6m9() {}
+    public void c6m10() {}
+    public void c6m11() {}
+    public void c6m12() {}
+    public void c6m13() {}
+    public void c6m14() {}
+    public void c6m15() {}
+    public void c6m16() {}
+    public void c6m17() {}
+    public void c6m18() {}
+    public void c6m19() {}
+    public void c6m20() {}
+    public void c6m21() {}
+    public void c6m22() {}
+    public void c6m23() {}
+    public void c6m24() {}
+    public void c6m25() {}
+    public void c6m26() {}
+    public void c6m27() {}
+    public void c6m28() {}
+    public void c6m29() {}
+    public void c6m30() {}
+    public void c6m31() {}
+  }
+
+  static class C7 extends C6 implements I7 {
+    public void i7m0() {}
+    public void i7m1() {}
+    public void i7m2() {}
+    public void i7m3() {}
+    public void i7m4() {}
+    public void i7m5() {}
+    public void i7m6() {}
+    public void i7m7() {}
+    public void i7m8() {}
+    public void i7m9() {}
+    public void i7m10() {}
+    public void i7m11() {}
+    public void i7m12() {}
+    public void i7m13() {}
+    public void i7m14() {}
+    public void i7m15() {}
+    public void i7m16() {}
+    public void i7m17() {}
+    public void i7m18() {}
+    public void i7m19() {}
+    public void i7m20() {}
+    public void i7m21() {}
+    public void i7m22() {}
+    public void i7m23() {}
+    public void i7m24() {}
+    public void i7m25() {}
+    public void i7m26() {}
+    public void i7m27() {}
+    public void i7m28() {}
+    public void i7m29() {}
+    public void i7m30() {}
+    public void i7m31() {}
+    public void c7m0() {}
+    public void c7m1() {}
+    public void c7m2() {}
+    public void c7m3() {}
+    public void c7m4() {}
+    public void c7m5() {}
+    public void c7m6() {}
+    public void c7m7() {}
+    public void c7m8() {}
+    public void c7m9() {}
+    public void c7m10() {}
+    public void c7m11() {}
+    public void c7m12() {}
+    public void c7m13() {}
+    public void c7m14() {}
+    public void c7m15() {}
+    public void c7m16() {}
+    public void c7m17() {}
+    public void c7m18() {}
+    public void c7m19() {}
+    public void c7m20() {}
+    public void c7m21() {}
+    public void c7m22() {}
+    public void c7m23() {}
+    public void c7m24() {}
+    public void c7m25() {}
+    public void c7m26() {}
+    public void c7m27() {}
+    public void c7m28() {}
+    public void c7m29() {}
+    public void c7m30() {}
+    public void c7m31() {}
+  }
+
+  static class C8 extends C7 implements I8 {
+    public void i8m0() {}
+    public void i8m1() {}
+    public void i8m2() {}
+    public void i8m3() {}
+    public void i8m4() {}
+    public void i8m5() {}
+    public void i8m6() {}
+    public void i8m7() {}
+    public void i8m8() {}
+    public void i8m9() {}
+    public void i8m10() {}
+    public void i8m11() {}
+    public void i8m12() {}
+    public void i8m13() {}
+    public void i8m14() {}
+    public void i8m15() {}
+    public void i8m16() {}
+    public void i8m17() {}
+    public void i8m18() {}
+    public void i8m19() {}
+    public void i8m20() {}
+    public void i8m21() {}
+    public void i8m22() {}
+    public void i8m23() {}
+    public void i8m24() {}
+    public void i8m25() {}
+    public void i8m26() {}
+    public void i8m27() {}
+    public void i8m28() {}
+    public void i8m29() {}
+    public void i8m30() {}
+    public void i8m31() {}
+    public void c8m0() {}
+    public void c8m1() {}
+    public void c8m2() {}
+    public void c8m3() {}
+    public void c8m4() {}
+    public void c8m5() {}
+    public void c8m6() {}
+    public void c8m7() {}
+    public void c8m8() {}
+    public void c8m9() {}
+    public void c8m10() {}
+    public void c8m11() {}
+    public void c8m12() {}
+    public void c8m13() {}
+    public void c8m14() {}
+    public void c8m15() {}
+    public void c8m16() {}
+    public void c8m17() {}
+    public void c8m18() {}
+    public void c8m19() {}
+    public void c8m20() {}
+    public void c8m21() {}
+    public void c8m22() {}
+    public void c8m23() {}
+    public void c8m24() {}
+    public void c8m25() {}
+    public void c8m26() {}
+    public void c8m27() {}
+    public void c8m28() {}
+    public void c8m29() {}
+    public void c8m30() {}
+    public void c8m31() {}
+  }
+
+  static class C9 extends C8 implements I9 {
+    public void i9m0() {}
+    public void i9m1() {}
+    public void i9m2() {}
+    public void i9m3() {}
+    public void i9m4() {}
+    public void i9m5() {}
+    public void i9m6() {}
+    public void i9m7() {}
+    public void i9m8() {}
+    public void i9m9() {}
+    public void i9m10() {}
+    public void i9m11() {}
+    public void i9m12() {}
+    public void i9m13() {}
+    public void i9m14() {}
+    public void i9m15() {}
+    public void i9m16() {}
+    public void i9m17() {}
+    public void i9m18() {}
+    public void i9m19() {}
+    public void i9m20() {}
+    public void i9m21() {}
+    public void i9m22() {}
+    public void i9m23() {}
+    public void i9m24() {}
+    public void i9m25() {}
+    public void i9m26() {}
+    public void i9m27() {}
+    public void i9m28() {}
+    public void i9m29() {}
+    public void i9m30() {}
+    public void i9m31() {}
+    public void c9m0() {}
+    public void c9m1() {}
+    public void c9m2() {}
+    public void c9m3() {}
+    public void c9m4() {}
+    public void c9m5() {}
+    public void c9m6() {}
+    public void c9m7() {}
+    public void c9m8() {}
+    public void c9m9() {}
+    public void c9m10() {}
+    public void c9m11() {}
+    public void c9m12() {}
+    public void c9m13() {}
+    public void c9m14() {}
+    public void c9m15() {}
+    public void c9m16() {}
+    public void c9m17() {}
+    public void c9m18() {}
+    public void c9m19() {}
+    public void c9m20() {}
+    public void c9m21() {}
+    public void c9m22() {}
+    public void c9m23() {}
+    public void c9m24() {}
+    public void c9m25() {}
+    public void c9m26() {}
+    public void c9m27() {}
+    public void c9m28() {}
+    public void c9m29() {}
+    public void c9m30() {}
+    public void c9m31() {}
+  }
+
+  static class C10 extends C9 implements I10 {
+    public void i10m0() {}
+    public void i10m1() {}
+    public void i10m2() {}
+    public void i10m3() {}
+    public void i10m4() {}
+    public void i10m5() {}
+    public void i10m6() {}
+    public void i10m7() {}
+    public void i10m8() {}
+    public void i10m9() {}
+    public void i10m10() {}
+    public void i10m11() {}
+    public void i10m12() {}
+    public void i10m13() {}
+    public void i10m14() {}
+    public void i10m15() {}
+    public void i10m16() {}
+    public void i10m17() {}
+    public void i10m18() {}
+    public void i10m19() {}
+    public void i10m20() {}
+    public void i10m21() {}
+    public void i10m22() {}
+    public void i10m23() {}
+    public void i10m24() {}
+    public void i10m25() {}
+    public void i10m26() {}
+    public void i10m27() {}
+    public void i10m28() {}
+    public void i10m29() {}
+    public void i10m30() {}
+    public void i10m31() {}
+    public void c10m0() {}
+    public void c10m1() {}
+    public void c10m2() {}
+    public void c10m3() {}
+    public void c10m4() {}
+    public void c10m5() {}
+    public void c10m6() {}
+    public void c10m7() {}
+    public void c10m8() {}
+    public void c10m9() {}
+    public void c10m10() {}
+    public void c10m11() {}
+    public void c10m12() {}
+    public void c10m13() {}
+    public void c10m14() {}
+    public void c10m15() {}
+    public void c10m16() {}
+    public void c10m17() {}
+    public void c10m18() {}
+    public void c10m19() {}
+    public void c10m20() {}
+    public void c10m21() {}
+    public void c10m22() {}
+    public void c10m23() {}
+    public void c10m24() {}
+    public void c10m25() {}
+    public void c10m26() {}
+    public void c10m27() {}
+    public void c10m28() {}
+    public void c10m29() {}
+    public void c10m30() {}
+    public void c10m31() {}
+  }
+
+  static class C11 extends C10 implements I11 {
+    public void i11m0() {}
+    public void i11m1() {}
+    public void i11m2() {}
+    public void i11m3() {}
+    public void i11m4() {}
+    public void i11m5() {}
+    public void i11m6() {}
+    public void i11m7() {}
+    public void i11m8() {}
+    public void i11m9() {}
+    public void i11m10() {}
+    public void i11m11() {}
+    public void i11m12() {}
+    public void i11m13() {}
+    public void i11m14() {}
+    public void i11m15() {}
+    public void i11m16() {}
+    public void i11m17() {}
+    public void i11m18() {}
+    public void i11m19() {}
+    public void i11m20() {}
+    public void i11m21() {}
+    public void i11m22() {}
+    public void i11m23() {}
+    public void i11m24() {}
+    public void i11m25() {}
+    public void i11m26() {}
+    public void i11m27() {}
+    public void i11m28() {}
+    public void i11m29() {}
+    public void i11m30() {}
+    public void i11m31() {}
+    public void c11m0() {}
+    public void c11m1() {}
+    public void c11m2() {}
+    public void c11m3() {}
+    public void c11m4() {}
+    public void c11m5() {}
+    public void c11m6() {}
+    public void c11m7() {}
+    public void c11m8() {}
+    public void c11m9() {}
+    public void c11m10() {}
+    public void c11m11() {}
+    public void c11m12() {}
+    public void c11m13() {}
+    public void c11m14() {}
+    public void c11m15() {}
+    public void c11m16() {}
+    public void c11m17() {}
+    public void c11m18() {}
+    public void c11m19() {}
+    public void c11m20() {}
+    public void c11m21() {}
+    public void c11m22() {}
+    public void c11m23() {}
+    public void c11m24() {}
+    public void c11m25() {}
+    public void c11m26() {}
+    public void c11m27() {}
+    public void c11m28() {}
+    public void c11m29() {}
+    public void c11m30() {}
+    public void c11m31() {}
+  }
+
+  static class C12 extends C11 implements I12 {
+    public void i12m0() {}
+    public void i12m1() {}
+    public void i12m2() {}
+    public void i12m3() {}
+    public void i12m4() {}
+    public void i12m5() {}
+    public void i12m6() {}
+    public void i12m7() {}
+    public void i12m8() {}
+    public void i12m9() {}
+    public void i12m10() {}
+    public void i12m11() {}
+    public void i12m12() {}
+    public void i12m13() {}
+    public void i12m14() {}
+    public void i12m15() {}
+    public void i12m16() {}
+    public void i12m17() {}
+    public void i12m18() {}
+    public void i12m19() {}
+    public void i12m20() {}
+    public void i12m21() {}
+    public void i12m22() {}
+    public void i12m23() {}
+    public void i12m24() {}
+    public void i12m25() {}
+    public void i12m26() {}
+    public void i12m27() {}
+    public void i12m28() {}
+    public void i12m29() {}
+    public void i12m30() {}
+    public void i12m31() {}
+    public void c12m0() {}
+    public void c12m1() {}
+    public void c12m2() {}
+    public void c12m3() {}
+    public void c12m4() {}
+    public void c12m5() {}
+    public void c12m6() {}
+    public void c12m7() {}
+    public void c12m8() {}
+    public void c12m9() {}
+    public void c12m10() {}
+    public void c12m11() {}
+    public void c12m12() {}
+    public void c12m13() {}
+    public void c12m14() {}
+    public void c12m15() {}
+    public void c12m16() {}
+    public void c12m17() {}
+    public void c12m18() {}
+    public void c12m19() {}
+    public void c12m20() {}
+    public void c12m21() {}
+    public void c12m22() {}
+    public void c12m23() {}
+    public void c12m24() {}
+    public void c12m25() {}
+    public void c12m26() {}
+    public void c12m27() {}
+    public void c12m28() {}
+    public void c12m29() {}
+    public void c12m30() {}
+    public void c12m31() {}
+  }
+
+  static class C13 extends C12 implements I13 {
+    public void i13m0() {}
+    public void i13m1() {}
+    public void i13m2() {}
+    public void i13m3() {}
+    public void i13m4() {}
+    public void i13m5() {}
+    public void i13m6() {}
+    public void i13m7() {}
+    public void i13m8() {}
+    public void i13m9() {}
+    public void i13m10() {}
+    public void i13m11() {}
+    public void i13m12() {}
+    public void i13m13() {}
+    public void i13m14() {}
+    public void i13m15() {}
+    public void i13m16() {}
+    public void i13m17() {}
+    public void i13m18() {}
+    public void i13m19() {}
+    public void i13m20() {}
+    public void i13m21() {}
+    public void i13m22() {}
+    public void i13m23() {}
+    public void i13m24() {}
+    public void i13m25() {}
+    public void i13m26() {}
+    public void i13m27() {}
+    public void i13m28() {}
+    public void i13m29() {}
+    public void i13m30() {}
+    public void i13m31() {}
+    public void c13m0() {}
+    public void c13m1() {}
+    public void c13m2() {}
+    public void c13m3() {}
+    public void c13m4() {}
+    public void c13m5() {}
+    public void c13m6() {}
+    public void c13m7() {}
+    public void c13m8() {}
+    public void c13m9() {}
+    public void c13m10() {}
+    public void c13m11() {}
+    public void c13m12() {}
+    public void c13m13() {}
+    public void c13m14() {}
+    public void c13m15() {}
+    public void c13m16() {}
+    public void c13m17() {}
+    public void c13m18() {}
+    public void c13m19() {}
+    public void c13m20() {}
+    public void c13m21() {}
+    public void c13m22() {}
+    public void c13m23() {}
+    public void c13m24() {}
+    public void c13m25() {}
+    public void c13m26() {}
+    public void c13m27() {}
+    public void c13m28() {}
+    public void c13m29() {}
+    public void c13m30() {}
+    public void c13m31() {}
+  }
+
+  static class C14 extends C13 implements I14 {
+    public void i14m0() {}
+    public void i14m1() {}
+    public void i14m2() {}
+    public void i14m3() {}
+    public void i14m4() {}
+    public void i14m5() {}
+    public void i14m6() {}
+    public void i14m7() {}
+    public void i14m8() {}
+    public void i14m9() {}
+    public void i14m10() {}
+    public void i14m11() {}
+    public void i14m12() {}
+    public void i14m13() {}
+    public void i14m14() {}
+    public void i14m15() {}
+    public void i14m16() {}
+    public void i14m17() {}
+    public void i14m18() {}
+    public void i14m19() {}
+    public void i14m20() {}
+    public void i14m21() {}
+    public void i14m22() {}
+    public void i14m23() {}
+    public void i14m24() {}
+    public void i14m25() {}
+    public void i14m26() {}
+    public void i14m27() {}
+    public void i14m28() {}
+    public void i14m29() {}
+    public void i14m30() {}
+    public void i14m31() {}
+    public void c14m0() {}
+    public void c14m1() {}
+    public void c14m2() {}
+    public void c14m3() {}
+    public void c14m4() {}
+    public void c14m5() {}
+    public void c14m6() {}
+    public void c14m7() {}
+    public void c14m8() {}
+    public void c14m9() {}
+    public void c14m10() {}
+    public void c14m11() {}
+    public void c14m12() {}
+    public void c14m13() {}
+    public void c14m14() {}
+    public void c14m15() {}
+    public void c14m16() {}
+    public void c14m17() {}
+    public void c14m18() {}
+    public void c14m19() {}
+    public void c14m20() {}
+    public void c14m21() {}
+    public void c14m22() {}
+    public void c14m23() {}
+    public void c14m24() {}
+    public void c14m25() {}
+    public void c14m26() {}
+    public void c14m27() {}
+    public void c14m28() {}
+    public void c14m29() {}
+    public void c14m30() {}
+    public void c14m31() {}
+  }
+
+  static class C15 extends C14 implements I15 {
+    public void i15m0() {}
+    public void i15m1() {}
+    public void i15m2() {}
+    public void i15m3() {}
+    public void i15m4() {}
+    public void i15m5() {}
+    public void i15m6() {}
+    public void i15m7() {}
+    public void i15m8() {}
+    public void i15m9() {}
+    public void i15m10() {}
+    public void i15m11() {}
+    public void i15m12() {}
+    public void i15m13() {}
+    public void i15m14() {}
+    public void i15m15() {}
+    public void i15m16() {}
+    public void i15m17() {}
+    public void i15m18() {}
+    public void i15m19() {}
+    public void i15m20() {}
+    public void i15m21() {}
+    public void i15m22() {}
+    public void i15m23() {}
+    public void i15m24() {}
+    public void i15m25() {}
+    public void i15m26() {}
+    public void i15m27() {}
+    public void i15m28() {}
+    public void i15m29() {}
+    public void i15m30() {}
+    public void i15m31() {}
+    public void c15m0() {}
+    public void c15m1() {}
+    public void c15m2() {}
+    public void c15m3() {}
+    public void c15m4() {}
+    public void c15m5() {}
+    public void c15m6() {}
+    public void c15m7() {}
+    public void c15m8() {}
+    public void c15m9() {}
+    public void c15m10() {}
+    public void c15m11() {}
+    public void c15m12() {}
+    public void c15m13() {}
+    public void c15m14() {}
+    public void c15m15() {}
+    public void c15m16() {}
+    public void c15m17() {}
+    public void c15m18() {}
+    public void c15m19() {}
+    public void c15m20() {}
+    public void c15m21() {}
+    public void c15m22() {}
+    public void c15m23() {}
+    public void c15m24() {}
+    public void c15m25() {}
+    public void c15m26() {}
+    public void c15m27() {}
+    public void c15m28() {}
+    public void c15m29() {}
+    public void c15m30() {}
+    public void c15m31() {}
+  }
+
+  // Classes implementing the same interface with inherited methods, which can share their IMT.
+  interface Shared {
+    void s0();
+    void s1();
+  }
+
+  static class SharedBase {
+    public void s0() {}
+    public void s1() {}
+  }
+
+  static class SharedA extends SharedBase implements Shared {}
+
+  static class SharedB extends SharedBase implements Shared {}
+}